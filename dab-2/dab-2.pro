@@ -113,7 +113,10 @@ HEADERS += ./radio.h \
 	   ../includes/backend/backend-driver.h \
 	   ../includes/backend/backend-deconvolver.h \
 	   ../includes/backend/audio/mp2processor.h \
+	   ../includes/backend/audio/mp2-decoder.h \
 	   ../includes/backend/audio/mp4processor.h \
+	   ../includes/backend/audio/au-pool.h \
+	   ../includes/backend/audio/decoder-pool.h \
 	   ../includes/backend/audio/bitWriter.h \
 	   ../includes/backend/data/data-processor.h \
 	   ../includes/backend/data/pad-handler.h \
@@ -135,8 +138,12 @@ HEADERS += ./radio.h \
 #	   ../includes/output/fir-filters.h \
 	   ../includes/output/audio-base.h \
 	   ../includes/output/newconverter.h \
+	   ../includes/output/audio-ring.h \
+	   ../includes/output/audio-router.h \
+	   ../includes/output/audio-dump-writer.h \
 	   ../includes/output/audiosink.h \
 	   ../includes/support/process-params.h \
+	   ../includes/support/dab-metrics.h \
 #	   ../includes/support/viterbi-jan/viterbi-handler.h \
 	   ../includes/support/viterbi-spiral/viterbi-spiral.h \
            ../includes/support/fft-handler.h \
@@ -213,7 +220,10 @@ SOURCES += ./main.cpp \
            ../src/backend/backend-driver.cpp \
            ../src/backend/backend-deconvolver.cpp \
 	   ../src/backend/audio/mp2processor.cpp \
+	   ../src/backend/audio/mp2-decoder.cpp \
 	   ../src/backend/audio/mp4processor.cpp \
+	   ../src/backend/audio/au-pool.cpp \
+	   ../src/backend/audio/decoder-pool.cpp \
 	   ../src/backend/audio/bitWriter.cpp \
 	   ../src/backend/data/pad-handler.cpp \
 	   ../src/backend/data/data-processor.cpp \
@@ -233,6 +243,8 @@ SOURCES += ./main.cpp \
 	   ../src/backend/data/journaline/NML.cpp \
 	   ../src/output/audio-base.cpp \
 	   ../src/output/newconverter.cpp \
+	   ../src/output/audio-dump-writer.cpp \
+	   ../src/output/audio-router.cpp \
 	   ../src/output/audiosink.cpp \
 #	   ../src/support/viterbi-jan/viterbi-handler.cpp \
 	   ../src/support/viterbi-spiral/viterbi-spiral.cpp \
@@ -575,6 +587,12 @@ datastreamer	{
 	SOURCES		+= ./server-thread/tcp-server.cpp
 }
 
+tcp-streamer|datastreamer	{
+	INCLUDEPATH	+= ../server-thread
+	HEADERS		+= ../server-thread/stream-server.h
+	SOURCES		+= ../server-thread/stream-server.cpp
+}
+
 
 # for RPI2 use:
 NEON_RPI2	{
@@ -521,13 +521,14 @@ void	dabProcessor::handle_tii_detection
 	if (wasSecond (my_ficHandler. get_CIFcount(), &params)) {
 	   my_TII_Detector. addBuffer (b);
 	   if (++tii_counter >= theParams -> tii_delay) {
-	      uint16_t res = my_TII_Detector. processNULL ();
-	      if (res != 0) {
-	         uint8_t mainId   = res >> 8;
-	         uint8_t subId    = res & 0xFF;
+	      std::vector<tiiResult> res = my_TII_Detector. processNULL ();
+//
+//	all transmitters found are reported, the strongest one
+//	- the first in the list - last, so that is the one shown
+	      if (res. size () > 0)
 	         tiiBuffer -> putDataIntoBuffer (ofdmBuffer. data (), T_u);
-	         show_tii (mainId, subId);
-              }
+	      for (int i = (int)res. size () - 1; i >= 0; i --)
+	         show_tii (res [i]. mainId, res [i]. subId);
 	      tii_counter = 0;
 	      my_TII_Detector. reset ();
 	   }
@@ -331,7 +331,9 @@ uint8_t	dabBand;
 	devicewidgetButton	-> setText (showWidget ? "show" : "hide");
 
 #ifdef	DATA_STREAMER
-	dataStreamer		= new tcpServer (dataPort);
+	dataStreamer		= new tcpServer (dataPort,
+	                               dabSettings -> value ("slowClientPolicy",
+	                                         SLOW_CLIENT_SKIP). toInt ());
 #else
 	(void)dataPort;
 #endif
@@ -339,7 +341,9 @@ uint8_t	dabBand;
 //	Where do we leave the audio out?
 	streamoutSelector	-> hide();
 #ifdef	TCP_STREAMER
-	soundOut		= new tcpStreamer	(20040);
+	soundOut		= new tcpStreamer	(20040,
+	                               dabSettings -> value ("slowClientPolicy",
+	                                         SLOW_CLIENT_SKIP). toInt ());
 #elif	QT_AUDIO
 	soundOut		= new Qt_Audio();
 #else
@@ -0,0 +1,224 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	<QComboBox>
+#include	"band-surveyor.h"
+#include	"band-handler.h"
+#include	"dab-processor.h"
+#include	"dab-params.h"
+#include	"channel-device.h"
+#include	"channelizer.h"
+#include	"wideband-reader.h"
+#include	<unistd.h>
+//
+//	a channel is only taken into account if the full 1.536 MHz
+//	ensemble is within the passband of the recording
+#define	HALF_ENSEMBLE	768000
+
+	surveyChannel::surveyChannel ():
+	                         responseBuffer (32768),
+	                         spectrumBuffer (2 * 32768),
+	                         iqBuffer (2 * 1536),
+	                         tiiBuffer (32768),
+	                         frameBuffer (2 * 32768) {
+	params. responseBuffer	= &responseBuffer;
+	params. spectrumBuffer	= &spectrumBuffer;
+	params. iqBuffer	= &iqBuffer;
+	params. tiiBuffer	= &tiiBuffer;
+	params. frameBuffer	= &frameBuffer;
+	noSignal		= false;
+	theDevice		= nullptr;
+	theProcessor		= nullptr;
+}
+
+	surveyChannel::~surveyChannel	() {
+	if (theProcessor != nullptr) {
+	   theProcessor	-> stop ();
+	   delete theProcessor;
+	}
+	if (theDevice != nullptr)
+	   delete theDevice;
+}
+
+	bandSurveyor::bandSurveyor (const QString &fileName,
+	                            QSettings	*dabSettings,
+	                            int16_t	nrWorkers) {
+	this	-> fileName	= fileName;
+	this	-> dabSettings	= dabSettings;
+	this	-> nrWorkers	= nrWorkers;
+	theReader		= nullptr;
+	theChannelizer		= nullptr;
+	readerDone		= false;
+	connect (&progressTimer, SIGNAL (timeout ()),
+	         this, SLOT (checkProgress ()));
+}
+
+//
+//	the reader may be waiting in channelizer::process for the
+//	workers, so it is stopped first, with the workers - and the
+//	processors draining the channels - still running
+	bandSurveyor::~bandSurveyor	() {
+	progressTimer. stop ();
+	if (theReader != nullptr)
+	   theReader -> stopReader ();
+	if (theChannelizer != nullptr)
+	   theChannelizer -> stop ();
+	for (auto c : theChannels)
+	   delete c;
+	if (theChannelizer != nullptr)
+	   delete theChannelizer;
+	if (theReader != nullptr)
+	   delete theReader;
+}
+
+bool	bandSurveyor::startSurvey	() {
+bandHandler	theBand ("", dabSettings);
+QComboBox	channelSelector;
+std::vector<int32_t> frequencies;
+
+	try {
+	   theReader	= new widebandReader (fileName);
+	} catch (int e) {
+	   fprintf (stderr, "cannot survey %s (%d)\n",
+	                          fileName. toUtf8 (). data (), e);
+	   return false;
+	}
+
+	int32_t sampleRate	= theReader -> get_sampleRate ();
+	int32_t centerFreq	= theReader -> get_centerFrequency ();
+	theBand. setupChannels (&channelSelector, BAND_III);
+	for (int i = 0; i < channelSelector. count (); i ++) {
+	   QString name	= channelSelector. itemText (i);
+	   int32_t freq	= theBand. Frequency (name);
+	   if (abs (freq - centerFreq) + HALF_ENSEMBLE > sampleRate / 2)
+	      continue;
+	   surveyChannel *c	= new surveyChannel ();
+	   c -> channelName	= name;
+	   c -> frequency	= freq;
+	   theChannels. push_back (c);
+	   frequencies. push_back (freq);
+	}
+
+	if (theChannels. size () == 0) {
+	   fprintf (stderr, "no channels within %d +/- %d\n",
+	                          centerFreq, sampleRate / 2);
+	   return false;
+	}
+
+	theChannelizer	= new channelizer (sampleRate, centerFreq,
+	                                   frequencies, nrWorkers);
+	for (int i = 0; i < (int)theChannels. size (); i ++) {
+	   surveyChannel *c	= theChannels [i];
+	   c -> params. dabMode		= 1;
+	   c -> params. threshold	=
+	          dabSettings -> value ("threshold", 3). toInt ();
+	   c -> params. diff_length	=
+	          dabSettings -> value ("diff_length", DIFF_LENGTH). toInt ();
+	   c -> params. tii_delay	= 2;
+	   c -> params. tii_depth	=
+	          dabSettings -> value ("tii_depth", 4). toInt ();
+	   c -> params. echo_depth	=
+	          dabSettings -> value ("echo_depth", 1). toInt ();
+	   c -> theDevice	=
+	          new channelDevice (theChannelizer -> channelBuffer (i),
+	                             c -> frequency, c -> channelName);
+	   c -> params. bitDepth	= c -> theDevice -> bitDepth ();
+	   c -> theProcessor	= new dabProcessor (nullptr,
+	                                            c -> theDevice,
+	                                            &c -> params);
+	   connect (c -> theProcessor, SIGNAL (No_Signal_Found ()),
+	            this, SLOT (handle_noSignal ()));
+	   c -> theProcessor -> set_scanMode (true);
+	   c -> theDevice -> restartReader (c -> frequency);
+	   c -> theProcessor -> start (c -> frequency);
+	   fprintf (stderr, "surveying channel %s (%d KHz)\n",
+	                  c -> channelName. toUtf8 (). data (),
+	                  c -> frequency / 1000);
+	}
+
+	connect (theReader, SIGNAL (readerDone ()),
+	         this, SLOT (handle_readerDone ()));
+	theReader	-> startReader (theChannelizer);
+	progressTimer. start (1000);
+	return true;
+}
+
+void	bandSurveyor::handle_readerDone	() {
+	readerDone	= true;
+}
+//
+//	a channel without signal does not need its processor anymore,
+//	the channelizer should not wait for it either
+void	bandSurveyor::handle_noSignal	() {
+	for (int i = 0; i < (int)theChannels. size (); i ++) {
+	   surveyChannel *c = theChannels [i];
+	   if (!c -> noSignal && (c -> theProcessor == sender ())) {
+	      c -> noSignal	= true;
+	      theChannelizer	-> dropChannel (i);
+	      c -> theProcessor	-> stop ();
+	      c -> theDevice	-> stopReader ();
+	      fprintf (stderr, "no signal in channel %s\n",
+	                         c -> channelName. toUtf8 (). data ());
+	   }
+	}
+}
+//
+//	once the recording is read, we wait for the processors
+//	to process the remaining samples
+void	bandSurveyor::checkProgress	() {
+dabParams	p (1);
+
+	fprintf (stderr, "survey: %d %% of %s\n",
+	                   (int)(theReader -> get_progress () * 100),
+	                   fileName. toUtf8 (). data ());
+	if (!readerDone)
+	   return;
+	for (auto c : theChannels)
+	   if (!c -> noSignal &&
+	        (c -> theDevice -> Samples () >= p. get_T_F ()))
+	      return;
+	progressTimer. stop ();
+	report ();
+	surveyDone ();
+}
+
+void	bandSurveyor::report	() {
+	for (auto c : theChannels) {
+	   c -> theProcessor -> stop ();
+	   if (c -> noSignal)
+	      continue;
+	   std::vector<serviceId> services =
+	                    c -> theProcessor -> getServices (ID_BASED);
+	   if (services. size () == 0)
+	      continue;
+	   my_Printer. showSummaryData (c -> channelName,
+	                                c -> frequency,
+	                                "",
+	                                "",
+	                                QByteArray (),
+	                                services,
+	                                c -> theProcessor,
+	                                stdout);
+	}
+	fflush (stdout);
+}
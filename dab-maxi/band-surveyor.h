@@ -0,0 +1,93 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__BAND_SURVEYOR__
+#define	__BAND_SURVEYOR__
+/*
+ *	The bandSurveyor surveys all Band III channels within
+ *	a wideband recording in one pass.
+ *	A channelizer splits the recording into channels, each channel
+ *	is handled by its own dabProcessor, all running concurrently.
+ *	When the recording is processed, the ensembles found
+ *	are printed - in the format of the scan dump - on stdout.
+ */
+#include	<QObject>
+#include	<QString>
+#include	<QTimer>
+#include	<QSettings>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"ringbuffer.h"
+#include	"process-params.h"
+#include	"ensemble-printer.h"
+
+class	dabProcessor;
+class	channelDevice;
+class	channelizer;
+class	widebandReader;
+
+class	surveyChannel {
+public:
+			surveyChannel	();
+			~surveyChannel	();
+	QString		channelName;
+	int32_t		frequency;
+	bool		noSignal;
+	processParams	params;
+	RingBuffer<float>		responseBuffer;
+	RingBuffer<std::complex<float>>	spectrumBuffer;
+	RingBuffer<std::complex<float>>	iqBuffer;
+	RingBuffer<std::complex<float>>	tiiBuffer;
+	RingBuffer<uint8_t>		frameBuffer;
+	channelDevice	*theDevice;
+	dabProcessor	*theProcessor;
+};
+
+class	bandSurveyor: public QObject {
+Q_OBJECT
+public:
+			bandSurveyor	(const QString &fileName,
+	                                 QSettings *,
+	                                 int16_t nrWorkers);
+			~bandSurveyor	();
+	bool		startSurvey	();
+private:
+	QString		fileName;
+	QSettings	*dabSettings;
+	int16_t		nrWorkers;
+	widebandReader	*theReader;
+	channelizer	*theChannelizer;
+	std::vector<surveyChannel *>	theChannels;
+	ensemblePrinter	my_Printer;
+	QTimer		progressTimer;
+	bool		readerDone;
+	void		report		();
+private slots:
+	void		handle_readerDone	();
+	void		handle_noSignal		();
+	void		checkProgress		();
+signals:
+	void		surveyDone		();
+};
+#endif
+
@@ -0,0 +1,655 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	<QComboBox>
+#include	<QFile>
+#include	<QTextStream>
+#include	<QRegExp>
+#include	<QDir>
+#include	<QLocalSocket>
+#include	<QJsonDocument>
+#include	<QJsonArray>
+#include	"dab-daemon.h"
+#include	"band-handler.h"
+#include	"dab-processor.h"
+#include	"device-handler.h"
+#include	"rawfiles.h"
+#include	"iqzfiles.h"
+#include	"wavfiles.h"
+#include	"xml-filereader.h"
+#include	"udp-sink.h"
+#ifdef	HAVE_RTL_TCP
+#include	"rtl_tcp_client.h"
+#endif
+#ifdef	TCP_STREAMER
+#include	"tcp-streamer.h"
+#include	"frame-streamer.h"
+#elif	QT_AUDIO
+#else
+#include	"audiosink.h"
+#endif
+//
+//	the frame counts of the processors are collected - and reset -
+//	each QUALITY_INTERVAL msec, the status shows the last interval
+#define	QUALITY_INTERVAL	10000
+
+	daemonEnsemble::daemonEnsemble ():
+	                         responseBuffer (32768),
+	                         iqBuffer (2 * 1536),
+	                         tiiBuffer (32768),
+	                         frameBuffer (2 * 32768) {
+	params. responseBuffer	= &responseBuffer;
+	params. spectrumBuffer	= nullptr;
+	params. iqBuffer	= &iqBuffer;
+	params. tiiBuffer	= &tiiBuffer;
+	params. frameBuffer	= &frameBuffer;
+	params. metrics		= &theMetrics;
+	frequency		= 0;
+	theDevice		= nullptr;
+	theProcessor		= nullptr;
+	synced			= false;
+	noSignal		= false;
+	ficBlocks		= 0;
+	ficSuccess		= 0;
+	ficRatio		= 0;
+	totalFrames		= 0;
+	goodFrames		= 0;
+	badFrames		= 0;
+}
+
+	daemonEnsemble::~daemonEnsemble	() {
+	if (theProcessor != nullptr) {
+	   theProcessor	-> stop ();
+	   delete theProcessor;
+	}
+	if (theDevice != nullptr) {
+	   theDevice	-> stopReader ();
+	   delete theDevice;
+	}
+}
+
+	dabDaemon::dabDaemon (const QString &configFile,
+	                      QSettings	*dabSettings) {
+	this	-> configFile	= configFile;
+	this	-> dabSettings	= dabSettings;
+	connect (&theServer, SIGNAL (newConnection ()),
+	         this, SLOT (handle_newConnection ()));
+	connect (&qualityTimer, SIGNAL (timeout ()),
+	         this, SLOT (update_quality ()));
+}
+
+	dabDaemon::~dabDaemon	() {
+	qualityTimer. stop ();
+	theServer. close ();
+	for (auto e : theEnsembles) {
+	   while (e -> routedServices. size () > 0)
+	      stopRoute (e, e -> routedServices. back ());
+	   delete e;
+	}
+}
+//
+//	the configuration lists one ensemble per line,
+//	empty lines and lines starting with a '#' are skipped
+bool	dabDaemon::readConfig	() {
+QFile	file (configFile);
+bandHandler	theBand ("", dabSettings);
+QComboBox	channelSelector;
+
+	if (!file. open (QIODevice::ReadOnly | QIODevice::Text)) {
+	   fprintf (stderr, "cannot open %s\n",
+	                          configFile. toUtf8 (). data ());
+	   return false;
+	}
+	theBand. setupChannels (&channelSelector, BAND_III);
+	QTextStream stream (&file);
+	while (!stream. atEnd ()) {
+	   QString line = stream. readLine (). trimmed ();
+	   if ((line == "") || line. startsWith ("#"))
+	      continue;
+	   QStringList fields = line. split (QRegExp ("\\s+"),
+	                                     QString::SkipEmptyParts);
+	   if (fields. size () < 2) {
+	      fprintf (stderr, "%s: incomplete line \"%s\"\n",
+	                          configFile. toUtf8 (). data (),
+	                          line. toUtf8 (). data ());
+	      continue;
+	   }
+	   daemonEnsemble *e	= new daemonEnsemble ();
+	   e -> name		= fields [0];
+	   e -> source		= fields [1];
+	   if (fields. size () > 2) {
+	      e -> channelName	= fields [2];
+	      e -> frequency	= theBand. Frequency (e -> channelName);
+	   }
+//
+//	a recording does not need a channel, the frequency is not used
+	   if (e -> source. startsWith ("tcp:") && (e -> channelName == "")) {
+	      fprintf (stderr, "%s: a channel is needed for %s\n",
+	                          e -> name. toUtf8 (). data (),
+	                          e -> source. toUtf8 (). data ());
+	      delete e;
+	      continue;
+	   }
+	   if ((e -> channelName != "") &&
+	       (channelSelector. findText (e -> channelName) < 0)) {
+	      fprintf (stderr, "%s: unknown channel %s\n",
+	                          e -> name. toUtf8 (). data (),
+	                          e -> channelName. toUtf8 (). data ());
+	      delete e;
+	      continue;
+	   }
+	   theEnsembles. push_back (e);
+	}
+	return theEnsembles. size () > 0;
+}
+//
+//	a source is either a file - the extension tells the type -
+//	or an rtl_tcp server, "tcp:<host>:<port>"
+deviceHandler	*dabDaemon::createDevice (const QString &source) {
+deviceHandler	*res	= nullptr;
+
+	if (source. startsWith ("tcp:")) {
+#ifdef	HAVE_RTL_TCP
+	   QStringList parts	= source. split (":");
+	   if (parts. size () != 3) {
+	      fprintf (stderr, "%s: use tcp:<host>:<port>\n",
+	                          source. toUtf8 (). data ());
+	      return nullptr;
+	   }
+	   rtl_tcp_client *client;
+	   try {
+	      client	= new rtl_tcp_client (dabSettings);
+	   } catch (int e) {
+	      return nullptr;
+	   }
+	   client	-> hide ();
+	   if (!client -> connectTo (parts [1], parts [2]. toInt ())) {
+	      fprintf (stderr, "cannot connect to %s\n",
+	                          source. toUtf8 (). data ());
+	      delete client;
+	      return nullptr;
+	   }
+	   return client;
+#else
+	   fprintf (stderr, "no rtl_tcp support configured\n");
+	   return nullptr;
+#endif
+	}
+
+	QString	file	= QDir::toNativeSeparators (source);
+	try {
+	   if (file. endsWith (".iqz", Qt::CaseInsensitive))
+	      res	= new iqzFiles (file);
+	   else
+	   if (file. endsWith (".sdr", Qt::CaseInsensitive))
+	      res	= new wavFiles (file);
+	   else
+	   if (file. endsWith (".raw", Qt::CaseInsensitive) ||
+	       file. endsWith (".iq", Qt::CaseInsensitive))
+	      res	= new rawFiles (file);
+	   else
+	      res	= new xml_fileReader (file);
+	}
+	catch (int e) {
+	   fprintf (stderr, "cannot process %s\n", file. toUtf8 (). data ());
+	   return nullptr;
+	}
+	res	-> hide ();
+	return res;
+}
+
+bool	dabDaemon::startDaemon	() {
+QString	socketName	=
+	   dabSettings -> value ("daemonSocket", "qt-dab-daemon"). toString ();
+
+	if (!readConfig ())
+	   return false;
+
+	for (auto e : theEnsembles) {
+	   e -> theDevice	= createDevice (e -> source);
+	   if (e -> theDevice == nullptr)
+	      continue;
+	   e -> params. dabMode		= 1;
+	   e -> params. threshold	=
+	          dabSettings -> value ("threshold", 3). toInt ();
+	   e -> params. diff_length	=
+	          dabSettings -> value ("diff_length", DIFF_LENGTH). toInt ();
+	   e -> params. tii_delay	= 2;
+	   e -> params. tii_depth	=
+	          dabSettings -> value ("tii_depth", 4). toInt ();
+	   e -> params. echo_depth	=
+	          dabSettings -> value ("echo_depth", 1). toInt ();
+	   e -> params. bitDepth	= e -> theDevice -> bitDepth ();
+	   e -> theProcessor	= new dabProcessor (nullptr,
+	                                            e -> theDevice,
+	                                            &e -> params);
+	   connect (e -> theProcessor, SIGNAL (setSynced (bool)),
+	            this, SLOT (handle_synced (bool)));
+	   connect (e -> theProcessor, SIGNAL (setSyncLost ()),
+	            this, SLOT (handle_syncLost ()));
+	   connect (e -> theProcessor, SIGNAL (No_Signal_Found ()),
+	            this, SLOT (handle_noSignal ()));
+	   e -> theDevice	-> restartReader (e -> frequency);
+	   e -> theProcessor	-> start (e -> frequency);
+	   fprintf (stderr, "monitoring %s (%s, %d KHz)\n",
+	                  e -> name. toUtf8 (). data (),
+	                  e -> source. toUtf8 (). data (),
+	                  e -> frequency / 1000);
+	}
+//
+//	a socket left behind by an earlier instance is removed
+	QLocalServer::removeServer (socketName);
+	if (!theServer. listen (socketName)) {
+	   fprintf (stderr, "cannot listen on %s (%s)\n",
+	                  socketName. toUtf8 (). data (),
+	                  theServer. errorString (). toUtf8 (). data ());
+	   return false;
+	}
+	fprintf (stderr, "status available on %s\n",
+	                  theServer. fullServerName (). toUtf8 (). data ());
+	qualityTimer. start (QUALITY_INTERVAL);
+	return true;
+}
+
+daemonEnsemble	*dabDaemon::findEnsemble	(const QString &name) {
+	for (auto e : theEnsembles)
+	   if (e -> name == name)
+	      return e;
+	return nullptr;
+}
+
+daemonEnsemble	*dabDaemon::findEnsemble	(QObject *processor) {
+	for (auto e : theEnsembles)
+	   if ((e -> theProcessor != nullptr) && (e -> theProcessor == processor))
+	      return e;
+	return nullptr;
+}
+
+void	dabDaemon::handle_synced	(bool b) {
+daemonEnsemble *e	= findEnsemble (sender ());
+	if (e != nullptr)
+	   e -> synced	= b;
+}
+
+void	dabDaemon::handle_syncLost	() {
+daemonEnsemble *e	= findEnsemble (sender ());
+	if (e != nullptr)
+	   e -> synced	= false;
+}
+//
+//	the processor gives up after a while, the ensemble remains
+//	in the list, marked as having no signal
+void	dabDaemon::handle_noSignal	() {
+daemonEnsemble *e	= findEnsemble (sender ());
+	if ((e == nullptr) || e -> noSignal)
+	   return;
+	e -> noSignal	= true;
+	e -> synced	= false;
+	fprintf (stderr, "no signal for %s\n", e -> name. toUtf8 (). data ());
+}
+
+//
+//	snr, clock error and the fic counts are taken from the
+//	metrics block of the processor, the snr events are not used
+void	dabDaemon::update_quality	() {
+metricsEvent	ev;
+
+	for (auto e : theEnsembles) {
+	   if (e -> theProcessor == nullptr)
+	      continue;
+	   e -> theProcessor -> getFrameQuality (&e -> totalFrames,
+	                                         &e -> goodFrames,
+	                                         &e -> badFrames);
+	   while (e -> theMetrics. getEvent (&ev));
+	   uint32_t blocks	= e -> theMetrics. ficBlocks. load ();
+	   uint32_t success	= e -> theMetrics. ficSuccess. load ();
+	   if (blocks != e -> ficBlocks)
+	      e -> ficRatio	= (success - e -> ficSuccess) * 100 /
+	                                     (blocks - e -> ficBlocks);
+	   else
+	      e -> ficRatio	= 0;
+	   if (e -> ficRatio > 100)
+	      e -> ficRatio	= 100;
+	   e -> ficBlocks	= blocks;
+	   e -> ficSuccess	= success;
+	}
+}
+
+void	dabDaemon::handle_newConnection	() {
+	while (theServer. hasPendingConnections ()) {
+	   QLocalSocket *s	= theServer. nextPendingConnection ();
+	   connect (s, SIGNAL (readyRead ()),
+	            this, SLOT (handle_request ()));
+	   connect (s, SIGNAL (disconnected ()),
+	            s, SLOT (deleteLater ()));
+	}
+}
+//
+//	requests are lines of text, each request gets a single
+//	line of JSON as answer
+void	dabDaemon::handle_request	() {
+QLocalSocket	*s	= qobject_cast<QLocalSocket *>(sender ());
+
+	if (s == nullptr)
+	   return;
+	while (s -> canReadLine ()) {
+	   QString request = QString::fromUtf8 (s -> readLine ()). trimmed ();
+	   if (request == "")
+	      continue;
+	   s -> write (handleRequest (request));
+	   s -> write ("\n");
+	}
+	s -> flush ();
+}
+
+QByteArray	dabDaemon::handleRequest	(const QString &request) {
+QStringList	words	= request. split (' ', QString::SkipEmptyParts);
+QJsonObject	answer;
+
+	if (words [0] == "list") {
+	   QJsonArray names;
+	   for (auto e : theEnsembles)
+	      names. append (e -> name);
+	   answer ["ensembles"]	= names;
+	}
+	else
+	if (words [0] == "status") {
+	   QJsonArray list;
+	   for (auto e : theEnsembles)
+	      if ((words. size () == 1) || (words [1] == e -> name))
+	         list. append (ensembleStatus (e));
+	   if ((words. size () > 1) && (list. size () == 0))
+	      answer ["error"]	= "unknown ensemble " + words [1];
+	   else
+	      answer ["ensembles"]	= list;
+	}
+	else
+	if (words [0] == "route")
+	   routeRequest (words, answer);
+	else
+	if (words [0] == "unroute")
+	   unrouteRequest (words, answer);
+	else
+	if (words [0] == "routes") {
+	   QJsonArray list;
+	   for (auto &s : theRouter. statistics ()) {
+	      QJsonObject route;
+	      route ["service"]		= s. service;
+	      route ["sink"]		= s. sink;
+	      route ["frames"]		= (qint64)s. frames;
+	      route ["underruns"]	= s. underruns;
+	      route ["overrunFrames"]	= (qint64)s. overrunFrames;
+	      route ["droppedFrames"]	= (qint64)s. droppedFrames;
+	      route ["latency"]		= s. latency;
+	      route ["maxLatency"]	= s. maxLatency;
+	      list. append (route);
+	   }
+	   answer ["routes"]	= list;
+	}
+	else
+	   answer ["error"]	= "unknown request " + words [0];
+	return QJsonDocument (answer). toJson (QJsonDocument::Compact);
+}
+
+QJsonObject	dabDaemon::ensembleStatus	(daemonEnsemble *e) {
+QJsonObject	res;
+
+	res ["name"]		= e -> name;
+	res ["source"]		= e -> source;
+	res ["channel"]		= e -> channelName;
+	res ["frequency"]	= e -> frequency;
+	if (e -> theProcessor == nullptr) {
+	   res ["error"]	= "source not available";
+	   return res;
+	}
+	res ["synced"]		= e -> synced;
+	res ["noSignal"]	= e -> noSignal;
+	res ["snr"]		= e -> theMetrics. snr. load ();
+	res ["clockError"]	= e -> theMetrics. clockError. load ();
+	res ["ficRatio"]	= e -> ficRatio;
+	QJsonObject frames;
+	frames ["total"]	= e -> totalFrames;
+	frames ["good"]		= e -> goodFrames;
+	frames ["bad"]		= e -> badFrames;
+	res ["frames"]		= frames;
+	QJsonObject decoding;
+	QJsonArray latency;
+	for (int i = 0; i < LATENCY_BUCKETS; i ++)
+	   latency. append ((qint64)e -> theMetrics. decodeLatency [i]. load ());
+	decoding ["latency"]	= latency;
+	decoding ["dropped"]	=
+	                  (qint64)e -> theMetrics. decodeDropped. load ();
+	res ["decoding"]	= decoding;
+	res ["oversizeAUs"]	=
+	                  (qint64)e -> theMetrics. oversizeAUs. load ();
+	if (!e -> synced)
+	   return res;
+	res ["ensemble"]	= e -> theProcessor -> get_ensembleName ();
+	res ["ensembleId"]	=
+	         QString::number (e -> theProcessor -> get_ensembleId (), 16);
+	res ["ecc"]		=
+	         QString::number (e -> theProcessor -> get_ecc (), 16);
+	QJsonArray services;
+	std::vector<serviceId> list =
+	                   e -> theProcessor -> getServices (ID_BASED);
+	for (auto &s : list) {
+	   QJsonObject service;
+	   service ["name"]	= s. name. trimmed ();
+	   service ["SId"]	= QString::number (s. SId, 16);
+	   service ["subChId"]	= s. subChId;
+	   services. append (service);
+	}
+	res ["services"]	= services;
+	return res;
+}
+//
+//	service names may contain spaces, the sink is the last word
+void	dabDaemon::routeRequest	(const QStringList &words,
+	                                         QJsonObject &answer) {
+	if (words. size () < 4) {
+	   answer ["error"]	= "usage: route <ensemble> <service> <sink>";
+	   return;
+	}
+	daemonEnsemble *e	= findEnsemble (words [1]);
+	if ((e == nullptr) || (e -> theProcessor == nullptr)) {
+	   answer ["error"]	= "unknown ensemble " + words [1];
+	   return;
+	}
+	QString	sink	= words. last ();
+	QString	service	= words. mid (2, words. size () - 3). join (" ");
+	QJsonArray routed;
+	if (service != "all") {
+	   QString error	= startRoute (e, service, sink, 0);
+	   if (error != "") {
+	      answer ["error"]	= error;
+	      return;
+	   }
+	   routed. append (service);
+	   answer ["routed"]	= routed;
+	   return;
+	}
+//
+//	the index of a service - and so its port - is its position
+//	among the audio services, routing "all" again starts
+//	the services that were not routed before
+	QJsonArray errors;
+	int	index	= 0;
+	std::vector<serviceId> list =
+	                   e -> theProcessor -> getServices (ID_BASED);
+	for (auto &s : list) {
+	   if (!e -> theProcessor -> is_audioService (s. name))
+	      continue;
+	   QString error	= startRoute (e, s. name, sink, index ++);
+	   if (error == "")
+	      routed. append (s. name. trimmed ());
+	   else
+	      errors. append (error);
+	}
+	answer ["routed"]	= routed;
+	if (errors. size () > 0)
+	   answer ["errors"]	= errors;
+}
+
+void	dabDaemon::unrouteRequest	(const QStringList &words,
+	                                         QJsonObject &answer) {
+	if (words. size () < 3) {
+	   answer ["error"]	= "usage: unroute <ensemble> <service>";
+	   return;
+	}
+	daemonEnsemble *e	= findEnsemble (words [1]);
+	if (e == nullptr) {
+	   answer ["error"]	= "unknown ensemble " + words [1];
+	   return;
+	}
+	QString	service	= words. mid (2). join (" ");
+	QJsonArray stopped;
+	for (int i = e -> routedServices. size () - 1; i >= 0; i --) {
+	   daemonService *s	= e -> routedServices [i];
+	   if ((service == "all") ||
+	       (s -> ad. serviceName. trimmed () == service. trimmed ())) {
+	      stopped. append (s -> ad. serviceName. trimmed ());
+	      stopRoute (e, s);
+	   }
+	}
+	if (stopped. size () == 0)
+	   answer ["error"]	= service + " is not routed";
+	else
+	   answer ["unrouted"]	= stopped;
+}
+//
+//	The decoder of a routed service writes into the route,
+//	the audio buffer is not used
+QString	dabDaemon::startRoute	(daemonEnsemble *e,
+	                         const QString &service,
+	                         const QString &sink, int index) {
+daemonService	*s	= new daemonService;
+
+	e -> theProcessor -> dataforAudioService (service, &s -> ad);
+	if (!s -> ad. defined) {
+	   delete s;
+	   return "unknown audio service " + service;
+	}
+	for (auto other : e -> routedServices)
+	   if (other -> ad. SId == s -> ad. SId) {
+	      delete s;
+	      return service. trimmed () + " is already routed";
+	   }
+	pcmSink	*theSink	= createSink (sink, service. trimmed (), index);
+	if (theSink == nullptr) {
+	   delete s;
+	   return "cannot create sink " + sink;
+	}
+	s -> route	= theRouter. addRoute (e -> name + ":" +
+	                                            service. trimmed ());
+	theRouter. addSink (s -> route, theSink);
+	s -> ad. route	= s -> route;
+	if (!e -> theProcessor -> set_audioChannel (&s -> ad, nullptr)) {
+	   theRouter. removeRoute (s -> route);
+	   delete s;
+	   return "cannot start " + service. trimmed ();
+	}
+	e -> routedServices. push_back (s);
+	fprintf (stderr, "routing %s (%s) to %s\n",
+	                   service. trimmed (). toUtf8 (). data (),
+	                   e -> name. toUtf8 (). data (),
+	                   theSink -> description (). toUtf8 (). data ());
+	return "";
+}
+//
+//	once the service is stopped, its decoder is gone
+//	and the route can be deleted
+void	dabDaemon::stopRoute	(daemonEnsemble *e, daemonService *s) {
+	if (e -> theProcessor != nullptr)
+	   e -> theProcessor -> stopService (&s -> ad);
+	theRouter. removeRoute (s -> route);
+	for (int i = 0; i < (int)e -> routedServices. size (); i ++)
+	   if (e -> routedServices [i] == s) {
+	      e -> routedServices. erase (e -> routedServices. begin () + i);
+	      break;
+	   }
+	delete s;
+}
+
+pcmSink	*dabDaemon::createSink	(const QString &sink,
+	                         const QString &service, int index) {
+	if (sink == "null")
+	   return new nullSink ();
+
+	if (sink. startsWith ("file:")) {
+	   QString path	= sink. mid (5);
+	   if (QDir (path). exists ()) {
+	      QString name	= service;
+	      name. replace ('/', '_');
+	      name. replace (' ', '_');
+	      return new fileSink (QDir (path). filePath (name + ".wav"));
+	   }
+	   if (index > 0)	// one file for more services?
+	      return nullptr;
+	   return new fileSink (path);
+	}
+
+#ifndef	__MINGW32__
+	if (sink. startsWith ("udp:")) {
+	   QStringList parts	= sink. split (":");
+	   if (parts. size () != 3)
+	      return nullptr;
+	   return new udpSink (parts [1], parts [2]. toInt () + index);
+	}
+#endif
+#ifdef	TCP_STREAMER
+//
+//	frames:<port>[:labels], the encoded frames rather than pcm
+	if (sink. startsWith ("frames:")) {
+	   QStringList parts	= sink. split (":");
+	   if ((parts. size () > 3) ||
+	       ((parts. size () == 3) && (parts [2] != "labels")))
+	      return nullptr;
+	   frameStreamer *theStreamer =
+	              new frameStreamer (parts [1]. toInt () + index,
+	                                 parts. size () == 3);
+	   if (!theStreamer -> isOpen ()) {
+	      delete theStreamer;
+	      return nullptr;
+	   }
+	   return theStreamer;
+	}
+	if (sink. startsWith ("tcp:"))
+	   return new deviceSink (new tcpStreamer (sink. mid (4). toInt () +
+	                                                            index),
+	                          "tcp:" + QString::number (sink. mid (4).
+	                                                toInt () + index));
+#elif	QT_AUDIO
+#else
+	if (sink == "device") {
+	   audioSink *theDevice	= new audioSink (dabSettings ->
+	                                    value ("latency", 5). toInt ());
+	   if (!theDevice -> selectDefaultDevice ()) {
+	      delete theDevice;
+	      return nullptr;
+	   }
+	   return new deviceSink (theDevice, "device");
+	}
+#endif
+	return nullptr;
+}
+
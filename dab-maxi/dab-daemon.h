@@ -0,0 +1,145 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__DAB_DAEMON__
+#define	__DAB_DAEMON__
+/*
+ *	The dabDaemon monitors a number of ensembles in one process,
+ *	without GUI. Each ensemble has its own source - a file or an
+ *	rtl_tcp server - and its own dabProcessor, the processors
+ *	share the FFT plans, the puncture tables and the oscillator table.
+ *	The ensembles are listed in a configuration file, one per line
+ *		<name> <source> [<channel>]
+ *	where a source is a filename or tcp:<host>:<port>.
+ *	The state of the ensembles is available through a local
+ *	socket: a client sends "list" or "status [<name>]", terminated
+ *	by a newline, the answer is a single line of JSON. The status
+ *	includes the audio decoding latency histogram, summed over the
+ *	decoded services of the ensemble (buckets as in dab-metrics.h),
+ *	and the number of DAB+ AUs that were too large to be decoded.
+ *	The audio of any number of services can be recorded or streamed:
+ *		route <ensemble> <service> <sink>
+ *		unroute <ensemble> <service>
+ *		routes
+ *	where the service may be "all" and a sink is one of
+ *	file:<path>, udp:<host>:<port> (not on Windows), device,
+ *	tcp:<port> or null.
+ *	With "all", the path is a directory, getting a file per service,
+ *	and the services are sent to consecutive ports.
+ *	The sink frames:<port>[:labels] streams the encoded AAC (LATM)
+ *	or MP2 frames - optionally with the dynamic labels - rather
+ *	than pcm, a service with only such sinks is not decoded.
+ */
+#include	<QObject>
+#include	<QString>
+#include	<QTimer>
+#include	<QSettings>
+#include	<QLocalServer>
+#include	<QByteArray>
+#include	<QJsonObject>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"ringbuffer.h"
+#include	"process-params.h"
+#include	"dab-metrics.h"
+#include	"audio-router.h"
+
+class	dabProcessor;
+class	deviceHandler;
+
+class	daemonService {
+public:
+	audiodata	ad;
+	audioRoute	*route;
+};
+
+class	daemonEnsemble {
+public:
+			daemonEnsemble	();
+			~daemonEnsemble	();
+	QString		name;
+	QString		source;
+	QString		channelName;
+	int32_t		frequency;
+	processParams	params;
+	RingBuffer<float>		responseBuffer;
+	RingBuffer<std::complex<float>>	iqBuffer;
+	RingBuffer<std::complex<float>>	tiiBuffer;
+	RingBuffer<uint8_t>		frameBuffer;
+	dabMetrics	theMetrics;
+	deviceHandler	*theDevice;
+	dabProcessor	*theProcessor;
+	bool		synced;
+	bool		noSignal;
+	uint32_t	ficBlocks;
+	uint32_t	ficSuccess;
+	int		ficRatio;
+	int		totalFrames;
+	int		goodFrames;
+	int		badFrames;
+	std::vector<daemonService *>	routedServices;
+};
+
+class	dabDaemon: public QObject {
+Q_OBJECT
+public:
+			dabDaemon	(const QString &configFile,
+	                                 QSettings *);
+			~dabDaemon	();
+	bool		startDaemon	();
+private:
+	QString		configFile;
+	QSettings	*dabSettings;
+	QLocalServer	theServer;
+	QTimer		qualityTimer;
+	std::vector<daemonEnsemble *>	theEnsembles;
+	audioRouter	theRouter;
+	bool		readConfig		();
+	deviceHandler	*createDevice		(const QString &source);
+	daemonEnsemble	*findEnsemble		(QObject *);
+	QJsonObject	ensembleStatus		(daemonEnsemble *);
+	QByteArray	handleRequest		(const QString &);
+	daemonEnsemble	*findEnsemble		(const QString &);
+	void		routeRequest		(const QStringList &,
+	                                         QJsonObject &);
+	void		unrouteRequest		(const QStringList &,
+	                                         QJsonObject &);
+	QString		startRoute		(daemonEnsemble *,
+	                                         const QString &service,
+	                                         const QString &sink,
+	                                         int index);
+	void		stopRoute		(daemonEnsemble *,
+	                                         daemonService *);
+	pcmSink		*createSink		(const QString &sink,
+	                                         const QString &service,
+	                                         int index);
+private slots:
+	void		handle_newConnection	();
+	void		handle_request		();
+	void		handle_synced		(bool);
+	void		handle_syncLost		();
+	void		handle_noSignal		();
+	void		update_quality		();
+};
+#endif
+
@@ -28,9 +28,12 @@
 #include	<QString>
 #include        <QDir>
 #include	<QDebug>
+#include	<QThread>
 #include        <unistd.h>
 #include        "dab-constants.h"
 #include        "radio.h"
+#include	"band-surveyor.h"
+#include	"dab-daemon.h"
 
 #define DEFAULT_INI     ".qt-dab.ini"
 #define	PRESETS		".qt-dab-presets.xml"
@@ -79,13 +82,17 @@ int     opt;
 QString freqExtension		= "";
 bool	error_report		= false;
 bool	marzano			= false;
+QString	surveyFile		= "";
+int	surveyWorkers		= QThread::idealThreadCount ();
+QString	batchFile		= "";
+QString	daemonConfig		= "";
 
 	QCoreApplication::setOrganizationName ("Lazy Chair Computing");
 	QCoreApplication::setOrganizationDomain ("Lazy Chair Computing");
 	QCoreApplication::setApplicationName ("qt-dab");
 	QCoreApplication::setApplicationVersion (QString (CURRENT_VERSION) + " Git: " + GITHASH);
 
-	while ((opt = getopt (argc, argv, "i:P:Q:A:TM")) != -1) {
+	while ((opt = getopt (argc, argv, "i:P:Q:A:TMS:W:B:D:")) != -1) {
 	   switch (opt) {
 	      case 'i':
 	         initFileName = fullPathfor (QString (optarg));
@@ -107,6 +114,24 @@ bool	marzano			= false;
 	         marzano	= true;
 	         break;
 
+	      case 'S':
+	         surveyFile	= optarg;
+	         break;
+
+	      case 'W':
+	         surveyWorkers	= atoi (optarg);
+	         break;
+//
+//	process a recording as fast as possible, and quit at its end
+	      case 'B':
+	         batchFile	= optarg;
+	         break;
+//
+//	monitor the ensembles listed in the file, without GUI
+	      case 'D':
+	         daemonConfig	= optarg;
+	         break;
+
 	      default:
 	         break;
 	   }
@@ -127,6 +152,11 @@ bool	marzano			= false;
 	QGuiApplication::setAttribute (Qt::AA_EnableHighDpiScaling);
 #endif
 
+//
+//	the daemon runs without display, the (hidden) widgets of
+//	the devices are handled by the offscreen platform
+	if (daemonConfig != "")
+	   qputenv ("QT_QPA_PLATFORM", "offscreen");
 	QApplication a (argc, argv);
 //	setting the language
 	QString locale = QLocale::system(). name();
@@ -134,13 +164,34 @@ bool	marzano			= false;
 	setTranslator (locale);
 
 	a. setWindowIcon (QIcon (":/qt-dab.ico"));
+//
+//	surveying a wideband recording does not need the GUI
+	if (surveyFile != "") {
+	   bandSurveyor theSurveyor (surveyFile, dabSettings, surveyWorkers);
+	   QObject::connect (&theSurveyor, SIGNAL (surveyDone ()),
+	                     &a, SLOT (quit ()));
+	   if (theSurveyor. startSurvey ())
+	      a. exec ();
+	   delete dabSettings;
+	   return 0;
+	}
+
+	if (daemonConfig != "") {
+	   dabDaemon *theDaemon = new dabDaemon (daemonConfig, dabSettings);
+	   if (theDaemon -> startDaemon ())
+	      a. exec ();
+	   delete theDaemon;
+	   delete dabSettings;
+	   return 0;
+	}
 
 	MyRadioInterface = new RadioInterface (dabSettings,
 	                                       presets,
 	                                       freqExtension,
 	                                       error_report,
 	                                       dataPort,
-	                                       marzano
+	                                       marzano,
+	                                       batchFile
                                                );
 	MyRadioInterface -> show();
         a. exec();
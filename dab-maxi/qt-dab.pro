@@ -5,7 +5,7 @@
 ######################################################################
 
 TEMPLATE	= app
-QT		+= widgets xml
+QT		+= widgets xml network
 #CONFIG		+= console
 CONFIG		-= console
 QMAKE_CXXFLAGS	+= -std=c++14
@@ -51,8 +51,10 @@ DEPENDPATH += . \
 	      ../snr-viewer \
 	      ./qt-devices \
 	      ./qt-devices/rawfiles-new \
+	      ./qt-devices/iqzfiles \
 	      ./qt-devices/wavfiles-new\
-	      ./qt-devices/xml-filereader 
+	      ./qt-devices/xml-filereader \
+	      ./qt-devices/channel-device
 
 INCLUDEPATH += . \
 	      ../ \
@@ -77,11 +79,15 @@ INCLUDEPATH += . \
 	      ../snr-viewer \
 	      ./qt-devices \
 	      ./qt-devices/rawfiles-new \
+	      ./qt-devices/iqzfiles \
 	      ./qt-devices/wavfiles-new \
 	      ./qt-devices/xml-filereader \
+	      ./qt-devices/channel-device \
 
 # Input
 HEADERS += ./radio.h \
+	   ./band-surveyor.h \
+	   ./dab-daemon.h \
 	   ../dab-processor.h \
 	   ../service-description/service-descriptor.h \
 	   ../service-description/audio-descriptor.h \
@@ -90,6 +96,7 @@ HEADERS += ./radio.h \
 	   ../includes/mot-content-types.h \
 	   ../includes/country-codes.h \
 	   ../includes/ofdm/timesyncer.h \
+	   ../includes/ofdm/signal-detector.h \
 	   ../includes/ofdm/sample-reader.h \
 	   ../includes/ofdm/ofdm-decoder.h \
 	   ../includes/ofdm/phasereference.h \
@@ -97,6 +104,7 @@ HEADERS += ./radio.h \
 	   ../includes/ofdm/freq-interleaver.h \
 #	   ../includes/ofdm/tii_table.h \
 	   ../includes/ofdm/tii_detector.h \
+	   ../includes/ofdm/tii-processor.h \
 	   ../includes/ofdm/fic-handler.h \
 	   ../includes/ofdm/fib-decoder.h  \
 	   ../includes/ofdm/fib-table.h \
@@ -116,7 +124,10 @@ HEADERS += ./radio.h \
 	   ../includes/backend/backend-driver.h \
 	   ../includes/backend/backend-deconvolver.h \
 	   ../includes/backend/audio/mp2processor.h \
+	   ../includes/backend/audio/mp2-decoder.h \
 	   ../includes/backend/audio/mp4processor.h \
+	   ../includes/backend/audio/au-pool.h \
+	   ../includes/backend/audio/decoder-pool.h \
 	   ../includes/backend/audio/bitWriter.h \
 	   ../includes/backend/data/data-processor.h \
 	   ../includes/backend/data/pad-handler.h \
@@ -138,11 +149,18 @@ HEADERS += ./radio.h \
 #	   ../includes/output/fir-filters.h \
 	   ../includes/output/audio-base.h \
 	   ../includes/output/newconverter.h \
+	   ../includes/output/audio-ring.h \
+	   ../includes/output/audio-router.h \
+	   ../includes/output/udp-sink.h \
+	   ../includes/output/audio-dump-writer.h \
 	   ../includes/output/audiosink.h \
 	   ../includes/support/process-params.h \
+	   ../includes/support/dab-metrics.h \
 	   ../includes/support/viterbi-jan/viterbi-handler.h \
 	   ../includes/support/viterbi-spiral/viterbi-spiral.h \
            ../includes/support/fft-handler.h \
+           ../includes/support/dump-writer.h \
+           ../includes/support/iqz-format.h \
 	   ../includes/support/ringbuffer.h \
 #	   ../includes/support/Xtan2.h \
 	   ../includes/support/dab-params.h \
@@ -150,6 +168,8 @@ HEADERS += ./radio.h \
 	   ../includes/support/text-mapper.h \
 	   ../includes/support/dab-tables.h \
 	   ../includes/support/ensemble-printer.h \
+	   ../includes/support/polyphase-resampler.h \
+	   ../includes/support/channelizer.h \
 	   ../includes/support/preset-handler.h \
 	   ../includes/support/presetcombobox.h \
 	   ../includes/support/smallcombobox.h \
@@ -173,13 +193,16 @@ HEADERS += ./radio.h \
 	   ./qt-devices/xml-filewriter.h \
 #	   ./qt-devices/filereader-widget.h \
 	   ./qt-devices/rawfiles-new/rawfiles.h \
-	   ./qt-devices/rawfiles-new/raw-reader.h \
+	   ./qt-devices/frame-indexer.h \
+	   ./qt-devices/iqzfiles/iqzfiles.h \
            ./qt-devices/wavfiles-new/wavfiles.h \
            ./qt-devices/wavfiles-new/wav-reader.h \
 	   ./qt-devices/xml-filereader/element-reader.h \
 	   ./qt-devices/xml-filereader/xml-filereader.h \
 	   ./qt-devices/xml-filereader/xml-reader.h \
-	   ./qt-devices/xml-filereader/xml-descriptor.h 
+	   ./qt-devices/xml-filereader/xml-descriptor.h \
+	   ./qt-devices/xml-filereader/wideband-reader.h \
+	   ./qt-devices/channel-device/channel-device.h
 
 FORMS	+= ../forms/technical_data.ui
 FORMS	+= ../forms/dabradio.ui 
@@ -195,10 +218,13 @@ FORMS	+= ./qt-devices/xml-filereader/xmlfiles.ui
 
 SOURCES += ./main.cpp \
 	   ./radio.cpp \
+	   ./band-surveyor.cpp \
+	   ./dab-daemon.cpp \
 	   ../dab-processor.cpp \
 	   ../service-description/audio-descriptor.cpp \
 	   ../service-description/data-descriptor.cpp \
 	   ../src/ofdm/timesyncer.cpp \
+	   ../src/ofdm/signal-detector.cpp \
 	   ../src/ofdm/sample-reader.cpp \
 	   ../src/ofdm/ofdm-decoder.cpp \
 	   ../src/ofdm/phasereference.cpp \
@@ -206,6 +232,7 @@ SOURCES += ./main.cpp \
 	   ../src/ofdm/freq-interleaver.cpp \
 #	   ../src/ofdm/tii_table.cpp \
 	   ../src/ofdm/tii_detector.cpp \
+	   ../src/ofdm/tii-processor.cpp \
 	   ../src/ofdm/fic-handler.cpp \
 	   ../src/ofdm/fib-decoder.cpp  \
 	   ../src/protection/protTables.cpp \
@@ -223,7 +250,10 @@ SOURCES += ./main.cpp \
            ../src/backend/backend-driver.cpp \
            ../src/backend/backend-deconvolver.cpp \
 	   ../src/backend/audio/mp2processor.cpp \
+	   ../src/backend/audio/mp2-decoder.cpp \
 	   ../src/backend/audio/mp4processor.cpp \
+	   ../src/backend/audio/au-pool.cpp \
+	   ../src/backend/audio/decoder-pool.cpp \
 	   ../src/backend/audio/bitWriter.cpp \
 	   ../src/backend/data/pad-handler.cpp \
 	   ../src/backend/data/data-processor.cpp \
@@ -243,16 +273,23 @@ SOURCES += ./main.cpp \
 	   ../src/backend/data/journaline/NML.cpp \
 	   ../src/output/audio-base.cpp \
 	   ../src/output/newconverter.cpp \
+	   ../src/output/audio-dump-writer.cpp \
+	   ../src/output/audio-router.cpp \
+	   ../src/output/udp-sink.cpp \
 	   ../src/output/audiosink.cpp \
 	   ../src/support/viterbi-jan/viterbi-handler.cpp \
 	   ../src/support/viterbi-spiral/viterbi-spiral.cpp \
            ../src/support/fft-handler.cpp \
+           ../src/support/dump-writer.cpp \
+           ../src/support/iqz-format.cpp \
 #	   ../src/support/Xtan2.cpp \
 	   ../src/support/dab-params.cpp \
 	   ../src/support/band-handler.cpp \
 	   ../src/support/text-mapper.cpp \
 	   ../src/support/dab-tables.cpp \
 	   ../src/support/ensemble-printer.cpp \
+	   ../src/support/polyphase-resampler.cpp \
+	   ../src/support/channelizer.cpp \
 	   ../src/support/preset-handler.cpp \
 	   ../src/support/presetcombobox.cpp \
 	   ../src/support/smallcombobox.cpp \
@@ -274,12 +311,15 @@ SOURCES += ./main.cpp \
 	   ./qt-devices/device-handler.cpp \
 	   ./qt-devices/xml-filewriter.cpp \
 	   ./qt-devices/rawfiles-new/rawfiles.cpp \
-	   ./qt-devices/rawfiles-new/raw-reader.cpp \
+	   ./qt-devices/frame-indexer.cpp \
+	   ./qt-devices/iqzfiles/iqzfiles.cpp \
            ./qt-devices/wavfiles-new/wavfiles.cpp \
            ./qt-devices/wavfiles-new/wav-reader.cpp \
 	   ./qt-devices/xml-filereader/xml-filereader.cpp \
 	   ./qt-devices/xml-filereader/xml-reader.cpp \
-	   ./qt-devices/xml-filereader/xml-descriptor.cpp 
+	   ./qt-devices/xml-filereader/xml-descriptor.cpp \
+	   ./qt-devices/xml-filereader/wideband-reader.cpp \
+	   ./qt-devices/channel-device/channel-device.cpp
 #
 #
 unix {
@@ -327,6 +367,9 @@ CONFIG		+= faad
 #very experimental, simple server for connecting to a tdc handler
 #CONFIG		+= datastreamer
 
+#to share the input with other programs, an rtl_tcp compatible server
+#CONFIG		+= iqserver
+
 #to handle output of embedded an IP data stream, uncomment
 CONFIG		+= send_datagram
 
@@ -523,8 +566,10 @@ rtl_tcp {
 	DEFINES		+= HAVE_RTL_TCP
 	QT		+= network
 	INCLUDEPATH	+= ./qt-devices/rtl_tcp
-	HEADERS		+= ./qt-devices/rtl_tcp/rtl_tcp_client.h
-	SOURCES		+= ./qt-devices/rtl_tcp/rtl_tcp_client.cpp
+	HEADERS		+= ./qt-devices/rtl_tcp/rtl_tcp_client.h \
+	                   ./qt-devices/rtl_tcp/tcp-reader.h
+	SOURCES		+= ./qt-devices/rtl_tcp/rtl_tcp_client.cpp \
+	                   ./qt-devices/rtl_tcp/tcp-reader.cpp
 	FORMS		+= ./qt-devices/rtl_tcp/rtl_tcp-widget.ui
 }
 
@@ -614,8 +659,10 @@ try-epg	{
 tcp-streamer	{
 	DEFINES		+= TCP_STREAMER
 	QT		+= network
-	HEADERS		+= ../includes/output/tcp-streamer.h
-	SOURCES		+= ../src/output/tcp-streamer.cpp
+	HEADERS		+= ../includes/output/tcp-streamer.h \
+	                   ../includes/output/frame-streamer.h
+	SOURCES		+= ../src/output/tcp-streamer.cpp \
+	                   ../src/output/frame-streamer.cpp
 }
 
 qt-audio	{
@@ -634,6 +681,19 @@ datastreamer	{
 	SOURCES		+= ../server-thread/tcp-server.cpp
 }
 
+tcp-streamer|datastreamer	{
+	INCLUDEPATH	+= ../server-thread
+	HEADERS		+= ../server-thread/stream-server.h
+	SOURCES		+= ../server-thread/stream-server.cpp
+}
+
+iqserver	{
+	DEFINES		+= IQ_SERVER
+	INCLUDEPATH	+= ../server-thread
+	HEADERS		+= ../server-thread/iq-server.h
+	SOURCES		+= ../server-thread/iq-server.cpp
+}
+
 
 # for RPI use:
 RPI	{
@@ -176,17 +176,8 @@ uint32_t samplerateCount;
 	airspySettings	-> beginGroup ("airspySettings");
 	airspySettings	-> endGroup();
 
-//	The sizes of the mapTables follow from the input and output rate
-//	(selectedRate / 1000) vs (2048000 / 1000)
-//	so we end up with buffers with 1 msec content
-	convBufferSize		= selectedRate / 1000;
-	for (i = 0; i < 2048; i ++) {
-	   float inVal	= float (selectedRate / 1000);
-	   mapTable_int [i]	=  int (floor (i * (inVal / 2048.0)));
-	   mapTable_float [i]	= i * (inVal / 2048.0) - mapTable_int [i];
-	}
-	convIndex	= 0;
-	convBuffer. resize (convBufferSize + 1);
+//	The samples are resampled from selectedRate to 2048000
+	theResampler	= new polyphaseResampler (selectedRate, INPUT_RATE);
 
 	tabWidget	-> setCurrentIndex (0);
 	connect (linearitySlider, SIGNAL (valueChanged (int)),
@@ -250,6 +241,7 @@ uint32_t samplerateCount;
 
 	airspyHandler::~airspyHandler() {
 	stopReader ();
+	delete theResampler;
 	myFrame. hide ();
 	airspySettings	-> beginGroup ("airspySettings");
 	airspySettings -> setValue ("linearity", linearitySlider -> value());
@@ -392,36 +384,25 @@ airspyHandler *p;
 
 //	called from AIRSPY data callback
 //	2*2 = 4 bytes for sample, as per AirSpy USB data stream format
-//	we do the rate conversion here, read in groups of 2 * xxx samples
-//	and transform them into groups of 2 * 512 samples
+//	we do the rate conversion here, the resampler takes
+//	the whole buffer at once
 int 	airspyHandler::data_available (void *buf, int buf_size) {	
 int16_t	*sbuf	= (int16_t *)buf;
 int nSamples	= buf_size / (sizeof (int16_t) * 2);
-std::complex<float> temp [2048];
-int32_t  i, j;
 
 	if (dumping. load ())
 	   xmlWriter -> add ((std::complex<int16_t> *)sbuf, nSamples);
-	for (i = 0; i < nSamples; i ++) {
-	   convBuffer [convIndex ++] = std::complex<float> (
-	                                     sbuf [2 * i] / (float)2048,
-	                                     sbuf [2 * i + 1] / (float)2048);
-	   if (convIndex > convBufferSize) {
-	      for (j = 0; j < 2048; j ++) {
-	         int16_t  inpBase	= mapTable_int [j];
-	         float    inpRatio	= mapTable_float [j];
-	         temp [j]	= cmul (convBuffer [inpBase + 1], inpRatio) + 
-	                          cmul (convBuffer [inpBase], 1 - inpRatio);
-	      }
-
-	      _I_Buffer. putDataIntoBuffer (temp, 2048);
-//
-//	shift the sample at the end to the beginning, it is needed
-//	as the starting sample for the next time
-	      convBuffer [0] = convBuffer [convBufferSize];
-	      convIndex = 1;
-	   }
-	}
+	if ((int)inBuffer. size () < nSamples) {
+	   inBuffer. resize (nSamples);
+	   outBuffer. resize (theResampler -> maxOutput (nSamples));
+	}
+	float *in	= reinterpret_cast<float *>(inBuffer. data ());
+	for (int i = 0; i < 2 * nSamples; i ++)
+	   in [i] = sbuf [i] / (float)2048;
+	int amount	= theResampler -> resample (inBuffer. data (),
+	                                            nSamples,
+	                                            outBuffer. data ());
+	_I_Buffer. putDataIntoBuffer (outBuffer. data (), amount);
 	return 0;
 }
 //
@@ -25,6 +25,7 @@
 #include	"dab-constants.h"
 #include	"ringbuffer.h"
 #include	"device-handler.h"
+#include	"polyphase-resampler.h"
 #include	"ui_airspy-widget.h"
 #ifndef	__MINGW32__
 #include	"libairspy/airspy.h"
@@ -183,11 +184,9 @@ const	char*		board_id_name();
 	int16_t		mixerGain;
 	int16_t		lnaGain;
 	int32_t		selectedRate;
-	int16_t		convBufferSize;
-	int16_t		convIndex;
-	std::vector <complex<float> >	convBuffer;
-	int16_t		mapTable_int   [4 * 512];
-	float		mapTable_float [4 * 512];
+	polyphaseResampler	*theResampler;
+	std::vector<std::complex<float>>	inBuffer;
+	std::vector<std::complex<float>>	outBuffer;
 	QSettings	*airspySettings;
 	int32_t		inputRate;
 	struct airspy_device* device;
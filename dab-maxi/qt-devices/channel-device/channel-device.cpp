@@ -0,0 +1,81 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"channel-device.h"
+#include	<unistd.h>
+
+	channelDevice::channelDevice (RingBuffer<std::complex<float>> *b,
+	                              int32_t frequency,
+	                              QString channelName) {
+	this	-> theBuffer	= b;
+	this	-> frequency	= frequency;
+	this	-> channelName	= channelName;
+	running. store (false);
+}
+
+	channelDevice::~channelDevice	() {
+}
+
+bool	channelDevice::restartReader	(int32_t freq) {
+	(void)freq;
+	running. store (true);
+	return true;
+}
+
+void	channelDevice::stopReader	() {
+	running. store (false);
+}
+
+int32_t	channelDevice::getVFOFrequency	() {
+	return frequency;
+}
+
+int32_t	channelDevice::getSamples	(std::complex<float> *V,
+	                                         int32_t size) {
+	while (running. load () &&
+	       (theBuffer -> GetRingBufferReadAvailable () < size))
+	   usleep (500);
+	return theBuffer -> getDataFromBuffer (V, size);
+}
+
+int32_t	channelDevice::Samples	() {
+	return theBuffer -> GetRingBufferReadAvailable ();
+}
+//
+//	the samples are not ours, we cannot skip them
+void	channelDevice::resetBuffer	() {
+}
+
+void	channelDevice::hide	() {
+}
+
+void	channelDevice::show	() {
+}
+
+bool	channelDevice::isHidden	() {
+	return true;
+}
+
+QString	channelDevice::deviceName	() {
+	return "channel " + channelName;
+}
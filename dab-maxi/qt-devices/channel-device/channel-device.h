@@ -0,0 +1,60 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__CHANNEL_DEVICE__
+#define	__CHANNEL_DEVICE__
+/*
+ *	A channelDevice is the "device" for a dabProcessor in a
+ *	band survey, it hands out the samples of a single channel,
+ *	as delivered by the channelizer
+ */
+#include	<QString>
+#include	<atomic>
+#include	"dab-constants.h"
+#include	"device-handler.h"
+#include	"ringbuffer.h"
+
+class	channelDevice: public deviceHandler {
+public:
+			channelDevice	(RingBuffer<std::complex<float>> *,
+	                                 int32_t frequency,
+	                                 QString channelName);
+			~channelDevice	();
+	bool		restartReader	(int32_t);
+	void		stopReader	();
+	int32_t		getVFOFrequency	();
+	int32_t		getSamples	(std::complex<float> *, int32_t);
+	int32_t		Samples		();
+	void		resetBuffer	();
+	void		hide		();
+	void		show		();
+	bool		isHidden	();
+	QString		deviceName	();
+private:
+	RingBuffer<std::complex<float>>	*theBuffer;
+	int32_t		frequency;
+	QString		channelName;
+	std::atomic<bool>	running;
+};
+#endif
+
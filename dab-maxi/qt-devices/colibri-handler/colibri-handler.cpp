@@ -85,17 +85,8 @@
 	   selectedRate	= 2560000;
 	}
 	rateLabel	-> setText (QString::number (selectedRate));
-//	The sizes of the mapTables follow from the input and output rate
-//	(selectedRate / 1000) vs (2048000 / 1000)
-//	so we end up with buffers with 1 msec content
-	convBufferSize		= selectedRate / 1000;
-	for (int i = 0; i < 2048; i ++) {
-	   float inVal	= float (selectedRate / 1000);
-	   mapTable_int [i]	=  int (floor (i * (inVal / 2048.0)));
-	   mapTable_float [i]	= i * (inVal / 2048.0) - mapTable_int [i];
-	}
-	convIndex	= 0;
-	convBuffer. resize (convBufferSize + 1);
+//	The samples are resampled from selectedRate to 2048000
+	theResampler	= new polyphaseResampler (selectedRate, INPUT_RATE);
 
 	iqSwitcher	= false;
 	switchLabel	-> setText ("I/Q");
@@ -106,6 +97,7 @@
 	colibriHandler::~colibriHandler () {
 	myFrame. hide ();
 	stopReader();
+	delete theResampler;
 	colibriSettings	-> beginGroup ("colibriSettings");
 	colibriSettings	-> setValue ("colibri-gain", 
 	                              gainSelector -> value ());
@@ -142,25 +134,14 @@ static
 bool	the_callBackRx (std::complex<float> *buffer, uint32_t len,
 	                               bool overload, void *ctx) {
 colibriHandler *p = static_cast<colibriHandler *>(ctx);
-std::complex<float> temp [2048];
+int	maxAmount	= p -> theResampler -> maxOutput (len);
 
 	(void)overload;
-	for (int i = 0; i < len; i ++) {
-	   p -> convBuffer [p -> convIndex] = buffer [i];
-	   p -> convIndex ++;
-	   if (p -> convIndex > p -> convBufferSize) {
-	      for (int j = 0; j < 2048; j ++) {
-	         int16_t  inpBase	= p -> mapTable_int [j];
-	         float	inpRatio	= p ->  mapTable_float [j];
-                 temp [j]  = cmul (p -> convBuffer [inpBase + 1], inpRatio) +
-                             cmul (p -> convBuffer [inpBase], 1 - inpRatio);
-              }
-
-              p -> _I_Buffer. putDataIntoBuffer (temp, 2048);
-	      p -> convBuffer [0] = p -> convBuffer [p -> convBufferSize];
-	      p -> convIndex = 1;
-	   }
-	}
+	if ((int)p -> outBuffer. size () < maxAmount)
+	   p -> outBuffer. resize (maxAmount);
+	int amount	= p -> theResampler -> resample (buffer, len,
+	                                             p -> outBuffer. data ());
+	p -> _I_Buffer. putDataIntoBuffer (p -> outBuffer. data (), amount);
 	return true;
 }
 
@@ -35,6 +35,7 @@
 #include	"LibLoader.h"
 #include	"ringbuffer.h"
 #include	"device-handler.h"
+#include	"polyphase-resampler.h"
 
 	class	colibriHandler: public deviceHandler, public Ui_colibriWidget {
 Q_OBJECT
@@ -57,11 +58,8 @@ public:
 	QString		deviceName		();
 
 	RingBuffer<std::complex<float>>	_I_Buffer;
-	int16_t		convBufferSize;
-	int16_t		convIndex;
-	std::vector <complex<float> >   convBuffer;
-	int16_t		mapTable_int   [2048];
-	float		mapTable_float [2048];
+	polyphaseResampler	*theResampler;
+	std::vector<std::complex<float>>	outBuffer;
 private:
 	QFrame			myFrame;
 	LibLoader		m_loader;
@@ -21,12 +21,25 @@
  *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 #include	"device-handler.h"
+#include	<cstdio>
+#include	<sys/time.h>
+
+static inline
+int64_t	getMyTime	() {
+struct timeval	tv;
+
+	gettimeofday (&tv, nullptr);
+	return ((int64_t)tv. tv_sec * 1000000 + (int64_t)tv. tv_usec);
+}
 
 	deviceHandler::deviceHandler	() {
 	lastFrequency	= 100000;
 	vfoOffset	= 0;
 	theGain		= 50;
 	coarseOffset	= 0;
+	batchMode. store	(false);
+	inputEnded. store	(false);
+	batchStart	= 0;
 }
 
 	deviceHandler::~deviceHandler	() {
@@ -55,6 +68,13 @@ int32_t	deviceHandler::Samples		() {
 	return 1024;
 }
 
+//
+//	amount samples in the format given by sampleFormat,
+//	for the default format that is what getSamples delivers
+int32_t	deviceHandler::getRawSamples	(void *v, int32_t amount) {
+	return getSamples ((std::complex<float> *)v, amount);
+}
+
 void	deviceHandler::resetBuffer	() {
 }
 
@@ -72,3 +92,38 @@ QString	deviceHandler::deviceName	() {
 	return "";
 }
 
+void	deviceHandler::set_batchMode	(bool b) {
+	batchMode. store (b);
+	batchStart	= getMyTime ();
+}
+
+bool	deviceHandler::endofInput	() {
+	return inputEnded. load ();
+}
+//
+//	the throughput, relative to real time, of the batch run
+void	deviceHandler::batch_done	(int64_t nrSamples, int32_t rate) {
+double	elapsed	= (getMyTime () - batchStart) / 1000000.0;
+double	signal	= (double)nrSamples / rate;
+
+	if (inputEnded. load ())
+	   return;
+	fprintf (stderr, "batch: %.1f seconds of input in %.1f seconds, %.2f x real time\n",
+	                 signal, elapsed, elapsed > 0 ? signal / elapsed : 0);
+	inputEnded. store (true);
+}
+//
+//	the consumer is done when the buffer is empty, or when
+//	nothing is taken from it for DRAIN_IDLE msec
+#define	DRAIN_IDLE	100
+void	deviceHandler::wait_drained	(RingBuffer<std::complex<float>> *b) {
+int32_t	left	= b -> GetRingBufferReadAvailable ();
+int	idle	= 0;
+
+	while ((left > 0) && (idle < DRAIN_IDLE)) {
+	   msleep (1);
+	   int32_t now	= b -> GetRingBufferReadAvailable ();
+	   idle	= now < left ? 0 : idle + 1;
+	   left	= now;
+	}
+}
@@ -28,11 +28,24 @@
 #define	__DEVICE_HANDLER__
 
 #include	<cstdint>
+#include	<atomic>
 #include	"dab-constants.h"
+#include	"ringbuffer.h"
 #include	<QObject>
 #include	<QThread>
 #include	<QFrame>
 
+//
+//	The formats in which a device may deliver its samples through
+//	getRawSamples. Devices that deliver anything other than
+//	std::complex<float> can keep the samples in their native
+//	format in their buffers, the conversion is left to the
+//	consumer, i.e. the sampleReader.
+#define	SAMPLES_CF32	0	// std::complex<float>, the default
+#define	SAMPLES_U8	1	// unsigned 8 bit I/Q pairs, 128 is zero
+#define	SAMPLES_S8	2	// signed 8 bit I/Q pairs
+#define	SAMPLES_S16	3	// signed 16 bit I/Q pairs, bitDepth bits used
+
 class	deviceHandler: public QThread {
 public:
 			deviceHandler	();
@@ -43,6 +56,8 @@ virtual		void	setVFOFrequency	(int32_t);
 virtual		int32_t	getVFOFrequency() {return 0;}
 virtual		int32_t	getSamples	(std::complex<float> *, int32_t);
 virtual		int32_t	Samples		();
+virtual		int16_t	sampleFormat	() { return SAMPLES_CF32;}
+virtual		int32_t	getRawSamples	(void *, int32_t);
 virtual		void	resetBuffer	();
 virtual		int16_t	bitDepth	() { return 10;}
 virtual		void	hide		();
@@ -50,7 +65,21 @@ virtual		void	show		();
 virtual		bool	isHidden	();
 virtual		QString deviceName	();
 //
+//	In batch mode a file device does not pace, the reader just
+//	waits until the consumer takes the samples. At the end of the
+//	file it stops, calls batch_done and endofInput becomes true.
+//	A device pushing into a ringbuffer first waits until the
+//	consumer stops taking samples, the consumer does not take
+//	a tail shorter than its next request.
+virtual		void	set_batchMode	(bool);
+virtual		bool	endofInput	();
+		void	batch_done	(int64_t nrSamples, int32_t rate);
+		void	wait_drained	(RingBuffer<std::complex<float>> *);
+//
 protected:
+		std::atomic<bool>	batchMode;
+		std::atomic<bool>	inputEnded;
+		int64_t	batchStart;
 		int32_t	lastFrequency;
 	        int32_t	vfoOffset;
 	        int	theGain;
@@ -38,7 +38,9 @@
 		eladHandler::eladHandler (QSettings *s):
 	                                     myFrame (nullptr),
 	                                     _I_Buffer  (256 * 32768),
-	                                     _O_Buffer  (16 * 32768) {
+	                                     _O_Buffer  (16 * 32768),
+	                                     theResampler (ELAD_RATE,
+	                                                   INPUT_RATE) {
 int16_t	success;
 
 	this	-> eladSettings	= s;
@@ -92,14 +94,6 @@ int16_t	success;
 	gainReduced	= 1;
 	gainLabel	-> setText ("0");
 
-        for (int i = 0; i < 2048; i ++) {
-           float inVal  = float (ELAD_RATE / 1000);
-           mapTable_int [i] =  int (floor (i * (inVal / 2048.0)));
-           mapTable_float [i] = i * (inVal / 2048.0) - mapTable_int [i];
-        }
-	convIndex	= 0;
-	fprintf (stderr, "mapTables initialized\n");
-
 	iqSize		= 8;
 //
 	connect (gainReduction, SIGNAL (clicked ()),
@@ -258,18 +252,17 @@ uint32_t	uii = 0, uqq = 0;
 //	   4. from time to time, we convert the rate
 //	   until the _O_Buffer is filled up with at least "size" samples
 #define	SEGMENT_SIZE	(1024 * iqSize)
-static
-int	teller		= 0;
 int32_t	eladHandler::getSamples (std::complex<float> *V, int32_t size) { 
 uint8_t lBuf [SEGMENT_SIZE];
-std::complex<float> temp [2048];
+std::complex<float> inBuf [1024];
+std::complex<float> temp [theResampler. maxOutput (1024)];
 //
 //	if we have sufficient samples in the buffer, go for it
 	if (_O_Buffer. GetRingBufferReadAvailable () >= size) 
 	   return _O_Buffer. getDataFromBuffer (V, size);
 //
 //	per cycle we read in SEGMENT_SIZE bytes, convert them
-//	to 512 complex numbers and put these samples into the
+//	to 1024 complex numbers and put these samples into the
 //	rate converter
 	while (Samples () < size)
 	   usleep (500);
@@ -278,33 +271,12 @@ std::complex<float> temp [2048];
 	       (_O_Buffer. GetRingBufferReadAvailable () < size)) {
 	   _I_Buffer. getDataFromBuffer (lBuf, SEGMENT_SIZE);
 
-	   for (int i = 0; i < SEGMENT_SIZE / iqSize; i ++) {
-	      convBuffer [convIndex ++] =
-	                     makeSample_31bits (&lBuf [iqSize * i],
-                                                iqSwitch. load ());
-	      if (convIndex > ELAD_RATE / 1000) {
-	         float sum = 0;
-	         int16_t j;
-	         for (j = 0; j < 2048; j ++) {
-	            int16_t  inpBase		= mapTable_int [j];
-	            float    inpRatio		= mapTable_float [j];
-	            temp [j]  = cmul (convBuffer [inpBase + 1], inpRatio) +
-                                cmul (convBuffer [inpBase], 1 - inpRatio);
-	            sum += abs (temp [j]);
-                 }
-	         if (++teller > 1000) {
-	            //fprintf (stderr, "signal is %f dB\n",
-//10 * log10 (sum / 2048 / 84));
-	            teller = 0;
-	         }
-	
-	         _O_Buffer. putDataIntoBuffer (temp, 2048);
-//      shift the sample at the end to the beginning, it is needed
-//      as the starting sample for the next time
-                 convBuffer [0] = convBuffer [ELAD_RATE / 1000];
-                 convIndex = 1;
-              }
-	   }
+	   for (int i = 0; i < SEGMENT_SIZE / iqSize; i ++)
+	      inBuf [i] = makeSample_31bits (&lBuf [iqSize * i],
+                                             iqSwitch. load ());
+	   int amount = theResampler. resample (inBuf,
+	                                        SEGMENT_SIZE / iqSize, temp);
+	   _O_Buffer. putDataIntoBuffer (temp, amount);
 	}
 
 	return _O_Buffer. getDataFromBuffer (V, size);
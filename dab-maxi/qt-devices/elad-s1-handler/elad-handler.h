@@ -31,6 +31,7 @@
 #include	"dab-constants.h"
 #include	"device-handler.h"
 #include	"ringbuffer.h"
+#include	"polyphase-resampler.h"
 #include	"ui_elad-widget.h"
 #include	<libusb-1.0/libusb.h>
 
@@ -69,6 +70,7 @@ private:
 	QFrame		myFrame;
 	RingBuffer<uint8_t>	_I_Buffer;
 	RingBuffer<std::complex<float>>	_O_Buffer;
+	polyphaseResampler	theResampler;
 	bool		deviceOK;
 	eladLoader	*theLoader;
 	eladWorker	*theWorker;
@@ -80,10 +82,6 @@ private:
 	int		Nyquist;
 	std::atomic<bool> iqSwitch;
 	int		iqSize;
-	std::complex<float> convBuffer	[ELAD_RATE / 1000 + 1];
-	int		mapTable_int	[INPUT_RATE / 1000];
-        float		mapTable_float	[INPUT_RATE / 1000];
-	int		convIndex;
 };
 #endif
 
@@ -0,0 +1,216 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"frame-indexer.h"
+#include	"dab-constants.h"
+#include	<QFileInfo>
+#include	<algorithm>
+#include	<cstdio>
+#include	<cstring>
+//
+//	A null symbol is recognized as a window of T_null samples
+//	with an average amplitude below DIP_LEVEL times the long
+//	term average. The frame start is the start of the window with
+//	the lowest average, after a frame start we do not look
+//	for the next one during half a frame.
+#define	DIP_LEVEL	0.5
+#define	BLOCK_SIZE	32768
+#define	INDEX_MAGIC	"QDABFIX1"
+
+	frameIndexer::frameIndexer	(const QString &fileName,
+	                                 int32_t sampleRate) {
+	this	-> fileName	= fileName;
+	this	-> indexName	= fileName + ".fidx";
+	this	-> sampleRate	= sampleRate;
+	nullLength	= (int64_t)2656 * sampleRate / INPUT_RATE;
+	frameLength	= (int64_t)196608 * sampleRate / INPUT_RATE;
+	ready. store	(false);
+	running. store	(false);
+}
+
+	frameIndexer::~frameIndexer	() {
+	stop ();
+}
+
+void	frameIndexer::start_indexing	() {
+	if (loadIndex ()) {
+	   ready. store (true);
+	   emit indexReady (frameStarts. size ());
+	   return;
+	}
+	running. store (true);
+	start ();
+}
+
+void	frameIndexer::stop	() {
+	running. store (false);
+	while (isRunning ())
+	   wait (100);
+}
+
+bool	frameIndexer::isReady	() {
+	return ready. load ();
+}
+
+int32_t	frameIndexer::nrFrames	() {
+	return ready. load () ? frameStarts. size () : 0;
+}
+
+int64_t	frameIndexer::frameStart	(int32_t frame) {
+	if (!ready. load () || (frameStarts. size () == 0))
+	   return 0;
+	if (frame < 0)
+	   frame = 0;
+	if (frame >= (int32_t)frameStarts. size ())
+	   frame = frameStarts. size () - 1;
+	return frameStarts [frame];
+}
+//
+//	the frame containing sample "sample"
+int32_t	frameIndexer::frameAt	(int64_t sample) {
+	if (!ready. load () || (frameStarts. size () == 0))
+	   return 0;
+	std::vector<int64_t>::iterator it =
+	        std::upper_bound (frameStarts. begin (),
+	                          frameStarts. end (), sample);
+	return it == frameStarts. begin () ? 0 :
+	                                 (it - frameStarts. begin ()) - 1;
+}
+//
+//	The position to continue with when jumping to "frame", while
+//	the reader is at "current". The position within the frame is
+//	kept, so the stream of samples remains aligned to the frames
+//	and the dabProcessor does not lose its time synchronization
+int64_t	frameIndexer::alignedPosition	(int32_t frame, int64_t current) {
+int32_t	currentFrame	= frameAt (current);
+int64_t	phase		= current - frameStart (currentFrame);
+
+	if ((phase < 0) || (phase >= frameLength))
+	   phase = 0;
+	return frameStart (frame) + phase;
+}
+
+void	frameIndexer::run	() {
+std::vector<std::complex<float>> buffer (BLOCK_SIZE);
+std::vector<float> window (nullLength, 0);
+double	windowSum	= 0;
+double	level		= -1;
+int	windowIndex	= 0;
+int64_t	position	= 0;
+int64_t	dipStart	= -1;
+int64_t	dipEnd		= 0;
+double	dipMin		= 0;
+int64_t	blockedUpto	= 0;
+
+	frameStarts. resize (0);
+	while (running. load ()) {
+	   int32_t n	= readSamples (buffer. data (), BLOCK_SIZE);
+	   if (n <= 0)
+	      break;
+	   if (level < 0) {
+	      level	= 0;
+	      for (int i = 0; i < n; i ++)
+	         level += jan_abs (buffer [i]);
+	      level	/= n;
+	   }
+	   for (int i = 0; i < n; i ++) {
+	      float a	= jan_abs (buffer [i]);
+	      windowSum	+= a - window [windowIndex];
+	      window [windowIndex] = a;
+	      if (++ windowIndex >= nullLength)
+	         windowIndex = 0;
+	      level	+= (a - level) / frameLength;
+	      position ++;
+	      if (position < nullLength)
+	         continue;
+	      double avg	= windowSum / nullLength;
+	      if (dipStart >= 0) {
+	         if (avg < dipMin) {
+	            dipMin	= avg;
+	            dipStart	= position - nullLength;
+	         }
+	         if (position >= dipEnd) {
+	            frameStarts. push_back (dipStart);
+	            blockedUpto	= dipStart + frameLength / 2;
+	            dipStart	= -1;
+	         }
+	      }
+	      else
+	      if ((position > blockedUpto) && (avg < DIP_LEVEL * level)) {
+	         dipStart	= position - nullLength;
+	         dipMin		= avg;
+	         dipEnd		= position + nullLength;
+	      }
+	   }
+	}
+	if (!running. load ())		// interrupted, index incomplete
+	   return;
+	saveIndex ();
+	ready. store (true);
+	emit indexReady (frameStarts. size ());
+}
+//
+//	The index file starts with the size of the recording
+//	and the samplerate, if they do not match, the recording
+//	was changed and the index is rebuilt
+bool	frameIndexer::loadIndex	() {
+FILE	*f	= fopen (indexName. toUtf8 (). data (), "rb");
+char	magic [8];
+int64_t	fileSize;
+int32_t	rate;
+int32_t	n;
+bool	ok;
+
+	if (f == nullptr)
+	   return false;
+	ok	= (fread (magic, 1, 8, f) == 8) &&
+	          (memcmp (magic, INDEX_MAGIC, 8) == 0) &&
+	          (fread (&fileSize, sizeof (int64_t), 1, f) == 1) &&
+	          (fread (&rate, sizeof (int32_t), 1, f) == 1) &&
+	          (fread (&n, sizeof (int32_t), 1, f) == 1) &&
+	          (fileSize == QFileInfo (fileName). size ()) &&
+	          (rate == sampleRate) && (n >= 0);
+	if (ok) {
+	   frameStarts. resize (n);
+	   ok = (int32_t)fread (frameStarts. data (), sizeof (int64_t), n, f) == n;
+	}
+	fclose (f);
+	return ok;
+}
+//
+//	if the index cannot be written (e.g. a read only directory),
+//	we just index again next time
+void	frameIndexer::saveIndex	() {
+FILE	*f	= fopen (indexName. toUtf8 (). data (), "wb");
+int64_t	fileSize	= QFileInfo (fileName). size ();
+int32_t	n		= frameStarts. size ();
+
+	if (f == nullptr)
+	   return;
+	fwrite (INDEX_MAGIC, 1, 8, f);
+	fwrite (&fileSize, sizeof (int64_t), 1, f);
+	fwrite (&sampleRate, sizeof (int32_t), 1, f);
+	fwrite (&n, sizeof (int32_t), 1, f);
+	fwrite (frameStarts. data (), sizeof (int64_t), n, f);
+	fclose (f);
+}
@@ -0,0 +1,76 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__FRAME_INDEXER__
+#define	__FRAME_INDEXER__
+/*
+ *	The frameIndexer builds - in a thread of its own - an index
+ *	of the frame starts (i.e. the start of the null symbols) in
+ *	a (Mode I) recording, so that a file reader can jump to
+ *	"frame N" or "second S" without reading the preceding part.
+ *	The index is saved next to the recording, as <file>.fidx,
+ *	a next time the file is opened the index is just read in.
+ *	The subclass provides the samples, by reading the file
+ *	sequentially from the start; since readSamples is called from
+ *	the indexer thread, the subclass should call stop () in its
+ *	destructor.
+ */
+#include	<QThread>
+#include	<QString>
+#include	<atomic>
+#include	<vector>
+#include	<cstdint>
+#include	<complex>
+
+class	frameIndexer: public QThread {
+Q_OBJECT
+public:
+			frameIndexer	(const QString &fileName,
+	                                 int32_t sampleRate);
+			~frameIndexer	();
+	void		start_indexing	();
+	void		stop		();
+	bool		isReady		();
+	int32_t		nrFrames	();
+	int64_t		frameStart	(int32_t);
+	int32_t		frameAt		(int64_t);
+	int64_t		alignedPosition	(int32_t frame, int64_t current);
+protected:
+virtual	int32_t		readSamples	(std::complex<float> *, int32_t) = 0;
+private:
+	void		run		();
+	bool		loadIndex	();
+	void		saveIndex	();
+	QString		fileName;
+	QString		indexName;
+	int32_t		sampleRate;
+	int32_t		nullLength;
+	int32_t		frameLength;
+	std::vector<int64_t>	frameStarts;
+	std::atomic<bool>	ready;
+	std::atomic<bool>	running;
+signals:
+	void		indexReady	(int);
+};
+#endif
+
@@ -337,22 +337,15 @@ uint16_t value;
 
 //
 //	we use a static large buffer, rather than trying to allocate
-//	a buffer on the stack
-static std::complex<int8_t>buffer [32 * 32768];
+//
+//	the samples are stored as they come, I/Q pairs of int8_t
 static
 int	callback (hackrf_transfer *transfer) {
 hackrfHandler *ctx = static_cast <hackrfHandler *>(transfer -> rx_ctx);
-int	i;
-uint8_t *p	= transfer -> buffer;
 RingBuffer<std::complex<int8_t> > * q = & (ctx -> _I_Buffer);
-int	bufferIndex	= 0;
 
-	for (i = 0; i < transfer -> valid_length / 2; i += 1) {
-	   int8_t re	= ((int8_t *)p) [2 * i];
-	   int8_t im	= ((int8_t *)p) [2 * i + 1];
-	   buffer [bufferIndex ++]	= std::complex<int8_t> (re, im);
-	}
-	q -> putDataIntoBuffer (buffer, bufferIndex);
+	q -> putDataIntoBuffer ((std::complex<int8_t> *)(transfer -> buffer),
+	                        transfer -> valid_length / 2);
 	return 0;
 }
 
@@ -414,14 +407,25 @@ int	res;
 //	size still in I/Q pairs
 int32_t	hackrfHandler::getSamples (std::complex<float> *V, int32_t size) { 
 std::complex<int8_t> temp [size];
-	int amount      = _I_Buffer. getDataFromBuffer (temp, size);
+	int amount      = getRawSamples (temp, size);
         for (int i = 0; i < amount; i ++)
            V [i] = std::complex<float> (real (temp [i]) / 127.0,
                                         imag (temp [i]) / 127.0);
+        return amount;
+
+}
+//
+//	the conversion to float is left to the sampleReader
+int32_t	hackrfHandler::getRawSamples (void *V, int32_t size) {
+std::complex<int8_t> *temp = (std::complex<int8_t> *)V;
+	int amount      = _I_Buffer. getDataFromBuffer (temp, size);
         if (dumping. load ())
            xmlWriter -> add (temp, amount);
         return amount;
+}
 
+int16_t	hackrfHandler::sampleFormat	() {
+	return SAMPLES_S8;
 }
 
 int32_t	hackrfHandler::Samples () {
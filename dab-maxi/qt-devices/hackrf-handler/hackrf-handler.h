@@ -91,6 +91,8 @@ public:
 	void		stopReader		();
 	int32_t		getSamples		(std::complex<float> *,
 	                                                          int32_t);
+	int32_t		getRawSamples		(void *, int32_t);
+	int16_t		sampleFormat		();
 	int32_t		Samples			();
 	void		resetBuffer		();
 	int16_t		bitDepth		();
@@ -0,0 +1,306 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"iqzfiles.h"
+#include	<cstdio>
+#include	<unistd.h>
+#include	<cstring>
+#include	<QVBoxLayout>
+#include	<sys/time.h>
+//
+//	the maximum number of samples we report to be available
+#define	MAX_AVAILABLE	(1 << 24)
+#define	SLIDER_STEPS	1000
+
+static
+int64_t	getMyTime	() {
+struct timeval	tv;
+
+	gettimeofday (&tv, nullptr);
+	return ((int64_t)tv. tv_sec * 1000000 + (int64_t)tv. tv_usec);
+}
+
+	iqzIndexer::iqzIndexer	(const QString &f):
+	                              frameIndexer (f, INPUT_RATE),
+	                              theReader (f) {
+	scale		= 1.0 / (1 << (theReader. nrBits () - 1));
+	currentChunk	= -1;
+	chunkLength	= 0;
+	chunkIndex	= 0;
+}
+
+	iqzIndexer::~iqzIndexer	() {
+	stop ();
+}
+//
+//	a chunk that cannot be decoded is replaced by zeros, so the
+//	positions of the frames in the next chunks remain correct
+int32_t	iqzIndexer::readSamples	(std::complex<float> *V, int32_t size) {
+int	i	= 0;
+
+	while (i < size) {
+	   if (chunkIndex >= chunkLength) {
+	      if (currentChunk + 1 >= theReader. nrChunks ())
+	         break;
+	      currentChunk ++;
+	      chunkLength	= theReader. readChunk (currentChunk, chunkBuffer);
+	      chunkIndex	= 0;
+	      if (chunkLength == 0) {
+	         int64_t end	= currentChunk + 1 < theReader. nrChunks () ?
+	                             theReader. chunkStart (currentChunk + 1) :
+	                             theReader. nrSamples ();
+	         chunkLength	= end - theReader. chunkStart (currentChunk);
+	         chunkBuffer. assign (2 * chunkLength, 0);
+	      }
+	   }
+	   int32_t amount	= chunkLength - chunkIndex;
+	   if (amount > size - i)
+	      amount = size - i;
+	   for (int j = 0; j < amount; j ++)
+	      V [i + j] = std::complex<float> (
+	                     chunkBuffer [2 * (chunkIndex + j)] * scale,
+	                     chunkBuffer [2 * (chunkIndex + j) + 1] * scale);
+	   i		+= amount;
+	   chunkIndex	+= amount;
+	}
+	return i;
+}
+
+	iqzFiles::iqzFiles (QString f):
+	   myFrame (nullptr),
+	   theReader (f),
+	   theIndexer (f) {
+	fileName	= f;
+	setupUi	(&myFrame);
+	if (theReader. sampleRate () != INPUT_RATE) {
+	   fprintf (stderr, "%s: samplerate %d is not supported\n",
+	                     f. toUtf8 (). data (), theReader. sampleRate ());
+	   throw (33);
+	}
+	nrSamples	= theReader. nrSamples ();
+	if (nrSamples < 1) {
+	   fprintf (stderr, "file %s is empty\n", f. toUtf8 (). data ());
+	   throw (31);
+	}
+	scale		= 1.0 / (1 << (theReader. nrBits () - 1));
+
+	metaLabel	= new QLabel (theReader. metaValue ("deviceName") + " " +
+	                              theReader. metaValue ("channel") + " " +
+	                              theReader. metaValue ("recordingTime"));
+	seekSlider	= new QSlider (Qt::Horizontal);
+	seekSlider	-> setRange (0, SLIDER_STEPS);
+	maxSpeedButton	= new QCheckBox ("max speed");
+	myFrame. layout () -> addWidget (metaLabel);
+	myFrame. layout () -> addWidget (seekSlider);
+	myFrame. layout () -> addWidget (maxSpeedButton);
+	myFrame. show	();
+
+	nameofFile	-> setText (f);
+        totalTime       -> display ((float)nrSamples / INPUT_RATE);
+	fileProgress    -> setValue (0);
+        currentTime     -> display (0);
+
+	currentChunk	= -1;
+	chunkLength	= 0;
+	chunkIndex	= 0;
+	seekPosition. store	(-1);
+	filePosition. store	(0);
+	samplesRead. store	(0);
+	maxSpeed. store		(false);
+	running. store		(false);
+	connect (maxSpeedButton, SIGNAL (stateChanged (int)),
+	         this, SLOT (handle_maxSpeed (int)));
+	connect (seekSlider, SIGNAL (sliderReleased ()),
+	         this, SLOT (handle_seekSlider ()));
+	connect (&progressTimer, SIGNAL (timeout ()),
+	         this, SLOT (setProgress ()));
+	progressTimer. start (1000);
+	theIndexer. start_indexing ();
+}
+
+	iqzFiles::~iqzFiles() {
+	theIndexer. stop ();
+	progressTimer. stop ();
+	running. store (false);
+	delete maxSpeedButton;
+	delete seekSlider;
+	delete metaLabel;
+}
+
+void	iqzFiles::resetClock	() {
+	clockBase. store (samplesRead. load () - getMyTime () * 256 / 125);
+}
+
+bool	iqzFiles::restartReader	(int32_t freq) {
+	(void)freq;
+	if (running. load())
+	   return true;
+	resetClock ();
+	running. store (true);
+	return true;
+}
+
+void	iqzFiles::stopReader() {
+	running. store (false);
+}
+
+void	iqzFiles::set_maxSpeed	(bool b) {
+	resetClock ();
+	maxSpeed. store (b);
+}
+
+void	iqzFiles::handle_maxSpeed	(int state) {
+	set_maxSpeed (state == Qt::Checked);
+}
+//
+//	batch mode is max speed, without continuing at the start
+void	iqzFiles::set_batchMode	(bool b) {
+	deviceHandler::set_batchMode (b);
+	set_maxSpeed (b);
+}
+//
+//	the position is a sample offset in the file. Once the frames
+//	are indexed, we jump to the frame containing it, at the position
+//	within the frame where we are now, so the dabProcessor keeps
+//	its time synchronization. Before that, the seek ends up
+//	somewhere in a frame and the processor has to resync
+void	iqzFiles::seekSample	(int64_t sample) {
+	if (sample < 0)
+	   sample = 0;
+	if (sample >= nrSamples)
+	   sample = nrSamples - 1;
+	if (theIndexer. isReady ())
+	   sample = theIndexer. alignedPosition (theIndexer. frameAt (sample),
+	                                         filePosition. load ());
+	if (sample >= nrSamples)
+	   sample = nrSamples - 1;
+	seekPosition. store (sample);
+}
+
+void	iqzFiles::handle_seekSlider	() {
+	seekSample (nrSamples * seekSlider -> value () / SLIDER_STEPS);
+}
+
+int32_t	iqzFiles::Samples() {
+	if (!running. load () || inputEnded. load ())
+	   return 0;
+	if (maxSpeed. load ())
+	   return MAX_AVAILABLE;
+	int64_t available = clockBase. load () + getMyTime () * 256 / 125 -
+	                                            samplesRead. load ();
+	if (available < 0)
+	   return 0;
+	return available > MAX_AVAILABLE ? MAX_AVAILABLE : available;
+}
+
+int32_t	iqzFiles::getSamples	(std::complex<float> *V, int32_t size) {
+	rawBuffer. resize (2 * size);
+	int32_t	amount	= getRawSamples (rawBuffer. data (), size);
+	for (int i = 0; i < amount; i ++)
+	   V [i] = std::complex<float> (rawBuffer [2 * i] * scale,
+	                                rawBuffer [2 * i + 1] * scale);
+	return amount;
+}
+//
+//	size is in I/Q pairs. At the end of the file we continue
+//	at the start - in batch mode we stop there -, a chunk
+//	that cannot be decoded gives zeros
+int32_t	iqzFiles::getRawSamples	(void *V, int32_t size) {
+int16_t	*out	= (int16_t *)V;
+int64_t	target	= seekPosition. exchange (-1);
+
+	while (running. load () && (Samples () < size))
+	   usleep (500);
+
+	if (target >= 0) {
+	   currentChunk	= theReader. chunkFor (target);
+	   chunkLength	= theReader. readChunk (currentChunk, chunkBuffer);
+	   chunkIndex	= target - theReader. chunkStart (currentChunk);
+	   if ((chunkIndex < 0) || (chunkIndex > chunkLength))
+	      chunkIndex = 0;
+	}
+
+	int i	= 0;
+	while (i < size) {
+	   if (chunkIndex >= chunkLength) {
+	      if (batchMode. load () &&
+	              (currentChunk + 1 >= theReader. nrChunks ())) {
+	         memset (&out [2 * i], 0, 2 * (size - i) * sizeof (int16_t));
+	         batch_done (samplesRead. load () + i, INPUT_RATE);
+	         break;
+	      }
+	      currentChunk ++;
+	      if (currentChunk >= theReader. nrChunks ())
+	         currentChunk = 0;
+	      chunkLength	= theReader. readChunk (currentChunk, chunkBuffer);
+	      chunkIndex	= 0;
+	      if (chunkLength == 0) {
+	         memset (&out [2 * i], 0, 2 * (size - i) * sizeof (int16_t));
+	         break;
+	      }
+	   }
+	   int32_t amount	= chunkLength - chunkIndex;
+	   if (amount > size - i)
+	      amount = size - i;
+	   memcpy (&out [2 * i], &chunkBuffer [2 * chunkIndex],
+	                                   2 * amount * sizeof (int16_t));
+	   i		+= amount;
+	   chunkIndex	+= amount;
+	}
+	if (currentChunk >= 0)
+	   filePosition. store (theReader. chunkStart (currentChunk) +
+	                                                     chunkIndex);
+	samplesRead. store (samplesRead. load () + size);
+	return size;
+}
+
+int16_t	iqzFiles::sampleFormat	() {
+	return SAMPLES_S16;
+}
+
+int16_t	iqzFiles::bitDepth	() {
+	return theReader. nrBits ();
+}
+
+QString	iqzFiles::deviceName	() {
+QString	name	= theReader. metaValue ("deviceName");
+	return name == "" ? "iqz file" : name;
+}
+
+void	iqzFiles::setProgress () {
+int64_t	position	= filePosition. load ();
+	fileProgress      -> setValue ((int)(position * 100 / nrSamples));
+	currentTime       -> display ((float)position / INPUT_RATE);
+}
+
+void	iqzFiles::show		() {
+	myFrame. show ();
+}
+
+void	iqzFiles::hide		() {
+	myFrame. hide ();
+}
+
+bool	iqzFiles::isHidden	() {
+	return myFrame. isHidden ();
+}
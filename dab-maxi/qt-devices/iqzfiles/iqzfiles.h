@@ -0,0 +1,120 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__IQZ_FILES__
+#define	__IQZ_FILES__
+
+#include	<QString>
+#include	<QFrame>
+#include	<QTimer>
+#include	<QCheckBox>
+#include	<QSlider>
+#include	<QLabel>
+#include	<atomic>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"device-handler.h"
+#include	"iqz-format.h"
+#include	"frame-indexer.h"
+
+#include	"filereader-widget.h"
+//
+//	the frame indexer reads the recording with a reader of its own,
+//	in its own thread, decoding the chunks one after the other
+class	iqzIndexer: public frameIndexer {
+public:
+			iqzIndexer	(const QString &);
+			~iqzIndexer	();
+private:
+	int32_t		readSamples	(std::complex<float> *, int32_t);
+	iqzReader	theReader;
+	std::vector<int16_t>	chunkBuffer;
+	int32_t		currentChunk;
+	int32_t		chunkLength;
+	int32_t		chunkIndex;
+	float		scale;
+};
+/*
+ *	Playing a compressed (.iqz) recording.
+ *	The file is decoded chunk by chunk, in the thread of the
+ *	caller of getSamples. Pacing is as with the rawFiles.
+ *	Since each chunk can be decoded on its own, seeking is just
+ *	looking up the chunk in the index, the seek takes effect
+ *	with the next call to getSamples. The chunks are not aligned
+ *	to the DAB frames, so once the frames are indexed, a seek
+ *	lands at the same position within the frame as the current one.
+ */
+class	iqzFiles: public deviceHandler, public filereaderWidget {
+Q_OBJECT
+public:
+
+			iqzFiles	(QString);
+ 	               ~iqzFiles	();
+	int32_t		getSamples	(std::complex<float> *, int32_t);
+	int32_t		getRawSamples	(void *, int32_t);
+	int16_t		sampleFormat	();
+	int16_t		bitDepth	();
+	int32_t		Samples		();
+	bool		restartReader	(int32_t);
+	void		stopReader	(void);
+	void		show		();
+	void		hide		();
+	bool		isHidden	();
+	QString		deviceName	();
+	void		set_maxSpeed	(bool);
+	void		set_batchMode	(bool);
+	void		seekSample	(int64_t);
+private:
+	QFrame		myFrame;
+	QCheckBox	*maxSpeedButton;
+	QSlider		*seekSlider;
+	QLabel		*metaLabel;
+	QString		fileName;
+	iqzReader	theReader;
+	iqzIndexer	theIndexer;
+	QTimer		progressTimer;
+	int64_t		nrSamples;
+	float		scale;
+	std::vector<int16_t>	chunkBuffer;
+	std::vector<int16_t>	rawBuffer;
+	int32_t		currentChunk;
+	int32_t		chunkLength;
+	int32_t		chunkIndex;
+	std::atomic<int64_t>	seekPosition;
+	std::atomic<int64_t>	filePosition;
+	std::atomic<int64_t>	samplesRead;
+//	the number of samples that would have arrived at time 0, at
+//	2.048 samples per usec. One atomic value, so resetClock and
+//	Samples, on different threads, need no lock
+	std::atomic<int64_t>	clockBase;
+	std::atomic<bool>	maxSpeed;
+	std::atomic<bool>	running;
+	void		resetClock	();
+public slots:
+	void		setProgress	();
+	void		handle_maxSpeed	(int);
+	void		handle_seekSlider	();
+};
+
+#endif
+
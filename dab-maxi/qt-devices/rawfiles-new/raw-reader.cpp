@@ -1,135 +0,0 @@
-#
-/*
- *    Copyright (C) 2013 .. 2017
- *    Jan van Katwijk (J.vanKatwijk@gmail.com)
- *    Lazy Chair Computing
- *
- *    This file is part of the Qt-DAB program
- *
- *    Qt-DAB is free software; you can redistribute it and/or modify
- *    it under the terms of the GNU General Public License as published by
- *    the Free Software Foundation; either version 2 of the License, or
- *    (at your option) any later version.
- *
- *    Qt-DAB is distributed in the hope that it will be useful,
- *    but WITHOUT ANY WARRANTY; without even the implied warranty of
- *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *    GNU General Public License for more details.
- *
- *    You should have received a copy of the GNU General Public License
- *    along with Qt-DAB; if not, write to the Free Software
- *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
- */
-
-#include	<sys/time.h>
-#include	"raw-reader.h"
-#include	"rawfiles.h"
-
-
-#define	BUFFERSIZE	32768
-static inline
-int64_t         getMyTime() {
-struct timeval  tv;
-
-        gettimeofday (&tv, nullptr);
-        return ((int64_t)tv. tv_sec * 1000000 + (int64_t)tv. tv_usec);
-}
-
-	rawReader::rawReader	(rawFiles *mr,
-	                         FILE	*filePointer,
-	                         RingBuffer<std::complex<float>> *_I_Buffer) {
-	this	-> parent	= mr;
-	this	-> filePointer	= filePointer;
-	this	-> _I_Buffer	= _I_Buffer;
-
-	fseek (filePointer, 0, SEEK_END);
-	fileLength		= ftell (filePointer);
-	fprintf (stderr, "fileLength = %d\n", (int)fileLength);
-        fseek (filePointer, 0, SEEK_SET);
-	period          = (32768 * 1000) / (2 * 2048);  // full IQś read
-        fprintf (stderr, "Period = %ld\n", period);
-        bi              = new uint8_t [BUFFERSIZE];
-	running. store (false);
-	start();
-}
-
-		rawReader::~rawReader() {
-	stopReader();
-	delete[] bi;
-}
-
-void	rawReader::stopReader() {
-	if (running) {
-	   running = false;
-	   while (isRunning())
-	      usleep (200);
-	}
-}
-
-
-static 
-float mapTable [] = {
- -128 / 128.0 , -127 / 128.0 , -126 / 128.0 , -125 / 128.0 , -124 / 128.0 , -123 / 128.0 , -122 / 128.0 , -121 / 128.0 , -120 / 128.0 , -119 / 128.0 , -118 / 128.0 , -117 / 128.0 , -116 / 128.0 , -115 / 128.0 , -114 / 128.0 , -113 / 128.0 
-, -112 / 128.0 , -111 / 128.0 , -110 / 128.0 , -109 / 128.0 , -108 / 128.0 , -107 / 128.0 , -106 / 128.0 , -105 / 128.0 , -104 / 128.0 , -103 / 128.0 , -102 / 128.0 , -101 / 128.0 , -100 / 128.0 , -99 / 128.0 , -98 / 128.0 , -97 / 128.0 
-, -96 / 128.0 , -95 / 128.0 , -94 / 128.0 , -93 / 128.0 , -92 / 128.0 , -91 / 128.0 , -90 / 128.0 , -89 / 128.0 , -88 / 128.0 , -87 / 128.0 , -86 / 128.0 , -85 / 128.0 , -84 / 128.0 , -83 / 128.0 , -82 / 128.0 , -81 / 128.0 
-, -80 / 128.0 , -79 / 128.0 , -78 / 128.0 , -77 / 128.0 , -76 / 128.0 , -75 / 128.0 , -74 / 128.0 , -73 / 128.0 , -72 / 128.0 , -71 / 128.0 , -70 / 128.0 , -69 / 128.0 , -68 / 128.0 , -67 / 128.0 , -66 / 128.0 , -65 / 128.0 
-, -64 / 128.0 , -63 / 128.0 , -62 / 128.0 , -61 / 128.0 , -60 / 128.0 , -59 / 128.0 , -58 / 128.0 , -57 / 128.0 , -56 / 128.0 , -55 / 128.0 , -54 / 128.0 , -53 / 128.0 , -52 / 128.0 , -51 / 128.0 , -50 / 128.0 , -49 / 128.0 
-, -48 / 128.0 , -47 / 128.0 , -46 / 128.0 , -45 / 128.0 , -44 / 128.0 , -43 / 128.0 , -42 / 128.0 , -41 / 128.0 , -40 / 128.0 , -39 / 128.0 , -38 / 128.0 , -37 / 128.0 , -36 / 128.0 , -35 / 128.0 , -34 / 128.0 , -33 / 128.0 
-, -32 / 128.0 , -31 / 128.0 , -30 / 128.0 , -29 / 128.0 , -28 / 128.0 , -27 / 128.0 , -26 / 128.0 , -25 / 128.0 , -24 / 128.0 , -23 / 128.0 , -22 / 128.0 , -21 / 128.0 , -20 / 128.0 , -19 / 128.0 , -18 / 128.0 , -17 / 128.0 
-, -16 / 128.0 , -15 / 128.0 , -14 / 128.0 , -13 / 128.0 , -12 / 128.0 , -11 / 128.0 , -10 / 128.0 , -9 / 128.0 , -8 / 128.0 , -7 / 128.0 , -6 / 128.0 , -5 / 128.0 , -4 / 128.0 , -3 / 128.0 , -2 / 128.0 , -1 / 128.0 
-, 0 / 128.0 , 1 / 128.0 , 2 / 128.0 , 3 / 128.0 , 4 / 128.0 , 5 / 128.0 , 6 / 128.0 , 7 / 128.0 , 8 / 128.0 , 9 / 128.0 , 10 / 128.0 , 11 / 128.0 , 12 / 128.0 , 13 / 128.0 , 14 / 128.0 , 15 / 128.0 
-, 16 / 128.0 , 17 / 128.0 , 18 / 128.0 , 19 / 128.0 , 20 / 128.0 , 21 / 128.0 , 22 / 128.0 , 23 / 128.0 , 24 / 128.0 , 25 / 128.0 , 26 / 128.0 , 27 / 128.0 , 28 / 128.0 , 29 / 128.0 , 30 / 128.0 , 31 / 128.0 
-, 32 / 128.0 , 33 / 128.0 , 34 / 128.0 , 35 / 128.0 , 36 / 128.0 , 37 / 128.0 , 38 / 128.0 , 39 / 128.0 , 40 / 128.0 , 41 / 128.0 , 42 / 128.0 , 43 / 128.0 , 44 / 128.0 , 45 / 128.0 , 46 / 128.0 , 47 / 128.0 
-, 48 / 128.0 , 49 / 128.0 , 50 / 128.0 , 51 / 128.0 , 52 / 128.0 , 53 / 128.0 , 54 / 128.0 , 55 / 128.0 , 56 / 128.0 , 57 / 128.0 , 58 / 128.0 , 59 / 128.0 , 60 / 128.0 , 61 / 128.0 , 62 / 128.0 , 63 / 128.0 
-, 64 / 128.0 , 65 / 128.0 , 66 / 128.0 , 67 / 128.0 , 68 / 128.0 , 69 / 128.0 , 70 / 128.0 , 71 / 128.0 , 72 / 128.0 , 73 / 128.0 , 74 / 128.0 , 75 / 128.0 , 76 / 128.0 , 77 / 128.0 , 78 / 128.0 , 79 / 128.0 
-, 80 / 128.0 , 81 / 128.0 , 82 / 128.0 , 83 / 128.0 , 84 / 128.0 , 85 / 128.0 , 86 / 128.0 , 87 / 128.0 , 88 / 128.0 , 89 / 128.0 , 90 / 128.0 , 91 / 128.0 , 92 / 128.0 , 93 / 128.0 , 94 / 128.0 , 95 / 128.0 
-, 96 / 128.0 , 97 / 128.0 , 98 / 128.0 , 99 / 128.0 , 100 / 128.0 , 101 / 128.0 , 102 / 128.0 , 103 / 128.0 , 104 / 128.0 , 105 / 128.0 , 106 / 128.0 , 107 / 128.0 , 108 / 128.0 , 109 / 128.0 , 110 / 128.0 , 111 / 128.0 
-, 112 / 128.0 , 113 / 128.0 , 114 / 128.0 , 115 / 128.0 , 116 / 128.0 , 117 / 128.0 , 118 / 128.0 , 119 / 128.0 , 120 / 128.0 , 121 / 128.0 , 122 / 128.0 , 123 / 128.0 , 124 / 128.0 , 125 / 128.0 , 126 / 128.0 , 127 / 128.0 };
-void	rawReader::run () {
-int64_t	nextStop;
-int	i;
-int	teller	= 0;
-std::complex<float> localBuffer [BUFFERSIZE / 2];
-
-	connect (this, SIGNAL (setProgress (int, float)),
-	         parent,   SLOT   (setProgress (int, float)));
-	fseek (filePointer, 0, SEEK_SET);
-	running. store (true);
-	nextStop        = getMyTime();
-	try {
-	   while (running. load()) {
-	      while (_I_Buffer -> WriteSpace() < BUFFERSIZE + 10) {
-	         if (!running. load())
-	            throw (32);
-	         usleep (100);
-              }
-	
-	      if (++teller >= 20) {
-	         int xx = ftell (filePointer);
-	         float progress = (float)xx / fileLength;
-	         setProgress ((int)(progress * 100), (float)xx / (2 * 2048000));
-                 teller = 0;
-	      }
-
-	      nextStop += period;
-	      int n = fread (bi, sizeof (uint8_t), BUFFERSIZE, filePointer);
-	      if (n < BUFFERSIZE) {
-	         fprintf (stderr, "eof gehad\n");
-	         fseek (filePointer, 0, SEEK_SET);
-                 for (i =  n; i < BUFFERSIZE; i ++)
-                    bi [i] = 0;
-              }
-
-	      for (i = 0; i < BUFFERSIZE / 2; i ++)
-	         localBuffer [i] = std::complex<float> (
-	                                       mapTable [bi [2 * i]],
-	                                       mapTable [bi [2 * i + 1]]);
-              _I_Buffer -> putDataIntoBuffer (localBuffer, BUFFERSIZE / 2);
-              if (nextStop - getMyTime() > 0)
-                 usleep (nextStop - getMyTime());
-           }
-	} catch (int e) {}
-        fprintf (stderr, "taak voor replay eindigt hier\n");
-}
-
-
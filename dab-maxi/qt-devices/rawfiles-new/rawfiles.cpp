@@ -28,91 +28,273 @@
 #include	<cstdio>
 #include	<unistd.h>
 #include	<cstdlib>
-#include	<fcntl.h>
+#include	<cstring>
+#include	<QVBoxLayout>
 //
 #include	<sys/time.h>
 #include	<ctime>
-
-#include	"raw-reader.h"
-
-#define	INPUT_FRAMEBUFFERSIZE	8 * 32768
 //
+//	The file is mapped in windows of WINDOW_SIZE bytes, so
+//	hours of recording can be handled in a 32 bit address space as well
+#define	WINDOW_SIZE	(64 * 1024 * 1024)
 //
+//	the maximum number of samples we report to be available
+#define	MAX_AVAILABLE	(1 << 24)
+
+static
+int64_t	getMyTime	() {
+struct timeval	tv;
+
+	gettimeofday (&tv, nullptr);
+	return ((int64_t)tv. tv_sec * 1000000 + (int64_t)tv. tv_usec);
+}
+
+	rawIndexer::rawIndexer	(const QString &f):
+	                              frameIndexer (f, INPUT_RATE) {
+	theFile	= fopen (f. toUtf8 (). data (), "rb");
+	for (int i = 0; i < 256; i ++)
+	   mapTable [i] = (i - 128) / 128.0;
+}
+
+	rawIndexer::~rawIndexer	() {
+	stop ();
+	if (theFile != nullptr)
+	   fclose (theFile);
+}
+
+int32_t	rawIndexer::readSamples	(std::complex<float> *V, int32_t size) {
+uint8_t	temp [2 * size];
+int32_t	amount;
+
+	if (theFile == nullptr)
+	   return 0;
+	amount	= fread (temp, 2, size, theFile);
+	for (int i = 0; i < amount; i ++)
+	   V [i] = std::complex<float> (mapTable [temp [2 * i]],
+	                                mapTable [temp [2 * i + 1]]);
+	return amount;
+}
+
 	rawFiles::rawFiles (QString f):
 	   myFrame (nullptr),
-	   _I_Buffer (INPUT_FRAMEBUFFERSIZE) {
+	   theIndexer (f),
+	   theFile (f) {
 	fileName	= f;
 	setupUi	(&myFrame);
+	maxSpeedButton	= new QCheckBox ("max speed");
+	frameSelector	= new QSpinBox ();
+	frameSelector	-> setPrefix ("frame ");
+	frameSelector	-> setEnabled (false);
+	timeSelector	= new QSpinBox ();
+	timeSelector	-> setSuffix (" sec");
+	timeSelector	-> setEnabled (false);
+	myFrame. layout () -> addWidget (maxSpeedButton);
+	myFrame. layout () -> addWidget (frameSelector);
+	myFrame. layout () -> addWidget (timeSelector);
 	myFrame. show	();
-	filePointer	= fopen (f. toUtf8(). data(), "rb");
-	if (filePointer == nullptr) {
+	if (!theFile. open (QIODevice::ReadOnly)) {
 	   fprintf (stderr, "file %s cannot open\n",
 	                                   f. toUtf8(). data());
-	   perror ("file ?");
 	   throw (31);
 	}
+	nrSamples	= theFile. size () / 2;
+	if (nrSamples < 1) {
+	   fprintf (stderr, "file %s is empty\n", f. toUtf8 (). data ());
+	   throw (31);
+	}
+	window		= nullptr;
+	windowStart	= 0;
+	windowSize	= 0;
+	if (!mapWindow (0)) {
+	   fprintf (stderr, "file %s cannot be mapped\n",
+	                                   f. toUtf8 (). data ());
+	   throw (31);
+	}
+
+	for (int i = 0; i < 256; i ++)
+	   mapTable [i] = (i - 128) / 128.0;
+
 	nameofFile	-> setText (f);
-	fseek (filePointer, 0, SEEK_END);
-	int64_t fileLength      = ftell (filePointer);
-        totalTime       -> display ((float)fileLength / (2048000 * 2));
-	fseek (filePointer, 0, SEEK_SET);
+        totalTime       -> display ((float)nrSamples / 2048000);
 	fileProgress    -> setValue (0);
         currentTime     -> display (0);
 
-	running. store (false);
+	filePosition. store	(0);
+	seekPosition. store	(-1);
+	samplesRead. store	(0);
+	maxSpeed. store		(false);
+	running. store		(false);
+	connect (maxSpeedButton, SIGNAL (stateChanged (int)),
+	         this, SLOT (handle_maxSpeed (int)));
+	connect (&progressTimer, SIGNAL (timeout ()),
+	         this, SLOT (setProgress ()));
+	progressTimer. start (1000);
+	connect (&theIndexer, SIGNAL (indexReady (int)),
+	         this, SLOT (handle_indexReady (int)));
+	connect (frameSelector, SIGNAL (editingFinished ()),
+	         this, SLOT (handle_frameSelector ()));
+	connect (timeSelector, SIGNAL (editingFinished ()),
+	         this, SLOT (handle_timeSelector ()));
+	theIndexer. start_indexing ();
 }
 
 	rawFiles::~rawFiles() {
-	if (running. load()) {
-	   readerTask	-> stopReader();
-	   while (readerTask -> isRunning())
-	      usleep (100);
-	   delete readerTask;
-	}
-	if (filePointer != nullptr)
-	   fclose (filePointer);
+	progressTimer. stop ();
+	running. store (false);
+	theIndexer. stop ();
+	if (window != nullptr)
+	   theFile. unmap ((uchar *)window);
+	theFile. close ();
+	delete maxSpeedButton;
+	delete frameSelector;
+	delete timeSelector;
+}
+//
+//	make the window contain byte "offset" of the file
+bool	rawFiles::mapWindow	(int64_t offset) {
+	if (window != nullptr)
+	   theFile. unmap ((uchar *)window);
+	windowStart	= offset & ~(int64_t)1;
+	windowSize	= theFile. size () - windowStart;
+	if (windowSize > WINDOW_SIZE)
+	   windowSize = WINDOW_SIZE;
+	window		= theFile. map (windowStart, windowSize);
+	return window != nullptr;
+}
+
+void	rawFiles::resetClock	() {
+	clockBase. store (samplesRead. load () - getMyTime () * 256 / 125);
 }
 
 bool	rawFiles::restartReader	(int32_t freq) {
 	(void)freq;
 	if (running. load())
 	   return true;
-	readerTask	= new rawReader (this, filePointer, &_I_Buffer);
+	resetClock ();
 	running. store (true);
 	return true;
 }
 
 void	rawFiles::stopReader() {
-	if (running. load()) {
-	   readerTask	-> stopReader();
-	   while (readerTask -> isRunning())
-	      usleep (100);
-	   delete readerTask;
-	}
 	running. store (false);
 }
 
-//	size is in I/Q pairs, file contains 8 bits values
-int32_t	rawFiles::getSamples	(std::complex<float> *V, int32_t size) {
-int32_t	amount;
+void	rawFiles::set_maxSpeed	(bool b) {
+	resetClock ();
+	maxSpeed. store (b);
+}
+
+void	rawFiles::handle_maxSpeed	(int state) {
+	set_maxSpeed (state == Qt::Checked);
+}
+//
+//	batch mode is max speed, without continuing at the start
+void	rawFiles::set_batchMode	(bool b) {
+	deviceHandler::set_batchMode (b);
+	set_maxSpeed (b);
+}
 
-	if (filePointer == nullptr)
+void	rawFiles::handle_indexReady	(int nrFrames) {
+	frameSelector	-> setRange (0, nrFrames > 0 ? nrFrames - 1 : 0);
+	timeSelector	-> setRange (0, nrSamples / 2048000);
+	frameSelector	-> setEnabled (nrFrames > 0);
+	timeSelector	-> setEnabled (nrFrames > 0);
+}
+//
+//	the seek is done by the next getRawSamples
+void	rawFiles::handle_frameSelector	() {
+	seekPosition. store (theIndexer.
+	                       alignedPosition (frameSelector -> value (),
+	                                        filePosition. load ()));
+}
+
+void	rawFiles::handle_timeSelector	() {
+int32_t	frame	= theIndexer. frameAt ((int64_t)timeSelector -> value () *
+	                                                      2048000);
+	seekPosition. store (theIndexer. alignedPosition (frame,
+	                                          filePosition. load ()));
+}
+//
+//	In real time mode, the number of samples available is the
+//	number of samples that would have arrived since the start,
+//	minus the ones already taken
+int32_t	rawFiles::Samples() {
+	if (!running. load () || inputEnded. load ())
 	   return 0;
+	if (maxSpeed. load ())
+	   return MAX_AVAILABLE;
+	int64_t available = clockBase. load () + getMyTime () * 256 / 125 -
+	                                            samplesRead. load ();
+	if (available < 0)
+	   return 0;
+	return available > MAX_AVAILABLE ? MAX_AVAILABLE : available;
+}
 
-	while ((int32_t)(_I_Buffer. GetRingBufferReadAvailable ()) < size)
-	   usleep (500);
+//	size is in I/Q pairs, file contains 8 bits values.
+//	At the end of the file, we continue at the start,
+//	in batch mode we stop there
+int32_t	rawFiles::getSamples	(std::complex<float> *V, int32_t size) {
+std::complex<uint8_t> temp [size];
+int32_t	amount	= getRawSamples (temp, size);
 
-	amount = _I_Buffer. getDataFromBuffer (V,  size);
+	for (int i = 0; i < amount; i ++)
+	   V [i] = std::complex<float> (mapTable [real (temp [i])],
+	                                mapTable [imag (temp [i])]);
 	return amount;
 }
+//
+//	the raw samples are just copied from the mapped window,
+//	the sampleReader does the conversion
+int32_t	rawFiles::getRawSamples	(void *V, int32_t size) {
+uint8_t	*out	= (uint8_t *)V;
+int64_t	position	= filePosition. load ();
+int64_t	target		= seekPosition. exchange (-1);
 
-int32_t	rawFiles::Samples() {
-	return _I_Buffer. GetRingBufferReadAvailable ();
+	if (target >= 0)
+	   position	= target;
+
+	while (running. load () && (Samples () < size))
+	   usleep (500);
+
+	int i	= 0;
+	while (i < size) {
+	   if (position >= nrSamples) {
+	      if (batchMode. load ()) {
+	         memset (&out [2 * i], 128, 2 * (size - i));
+	         batch_done (samplesRead. load () + i, INPUT_RATE);
+	         break;
+	      }
+	      position = 0;
+	   }
+	   int64_t offset	= 2 * position;
+	   if ((offset < windowStart) ||
+	       (offset + 2 > windowStart + windowSize)) {
+	      if (!mapWindow (offset))
+	         return i;
+	   }
+//	the samples we can take from the current window in one go
+	   int64_t amount	= (windowStart + windowSize - offset) / 2;
+	   if (amount > size - i)
+	      amount = size - i;
+	   if (amount > nrSamples - position)
+	      amount = nrSamples - position;
+	   memcpy (&out [2 * i], &window [offset - windowStart], 2 * amount);
+	   i		+= amount;
+	   position	+= amount;
+	}
+	filePosition. store (position);
+	samplesRead. store (samplesRead. load () + size);
+	return size;
 }
 
-void	rawFiles::setProgress (int progress, float timelength) {
-	fileProgress      -> setValue (progress);
-	currentTime       -> display (timelength);
+int16_t	rawFiles::sampleFormat	() {
+	return SAMPLES_U8;
+}
+
+void	rawFiles::setProgress () {
+int64_t	position	= filePosition. load ();
+	fileProgress      -> setValue ((int)(position * 100 / nrSamples));
+	currentTime       -> display ((float)position / 2048000);
 }
 
 void	rawFiles::show		() {
@@ -126,5 +308,3 @@ void	rawFiles::hide		() {
 bool	rawFiles::isHidden	() {
 	return myFrame. isHidden ();
 }
-
-
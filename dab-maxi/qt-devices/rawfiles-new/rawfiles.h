@@ -26,17 +26,38 @@
 #include	<QThread>
 #include	<QString>
 #include	<QFrame>
+#include	<QFile>
+#include	<QTimer>
+#include	<QCheckBox>
+#include	<QSpinBox>
 #include	<atomic>
 #include	"dab-constants.h"
 #include	"device-handler.h"
-#include	"ringbuffer.h"
+#include	"frame-indexer.h"
 
 #include	"filereader-widget.h"
 
 class	QLabel;
 class	QSettings;
-class	rawReader;
+//
+//	the indexer reads the file on its own
+class	rawIndexer: public frameIndexer {
+public:
+			rawIndexer	(const QString &);
+			~rawIndexer	();
+private:
+	int32_t		readSamples	(std::complex<float> *, int32_t);
+	FILE		*theFile;
+	float		mapTable [256];
+};
 /*
+ *	The file is memory mapped, the samples are converted
+ *	straight from the mapped file into the buffer of the caller
+ *	of getSamples. Pacing - unless "max speed" is selected -
+ *	is done by telling the caller (through Samples ())
+ *	how many samples "have arrived" since the start.
+ *	Once the frames are indexed, one may jump to a frame or
+ *	to a time (in seconds from the start).
  */
 class	rawFiles: public deviceHandler, public filereaderWidget {
 Q_OBJECT
@@ -45,6 +66,8 @@ public:
 			rawFiles	(QString);
  	               ~rawFiles	();
 	int32_t		getSamples	(std::complex<float> *, int32_t);
+	int32_t		getRawSamples	(void *, int32_t);
+	int16_t		sampleFormat	();
 	uint8_t		myIdentity	();
 	int32_t		Samples		();
 	bool		restartReader	(int32_t);
@@ -52,15 +75,39 @@ public:
 	void		show		();
 	void		hide		();
 	bool		isHidden	();
+	void		set_maxSpeed	(bool);
+	void		set_batchMode	(bool);
 private:
 	QFrame		myFrame;
+	QCheckBox	*maxSpeedButton;
+	QSpinBox	*frameSelector;
+	QSpinBox	*timeSelector;
+	rawIndexer	theIndexer;
 	QString		fileName;
-	RingBuffer<std::complex<float>>	_I_Buffer;
-	FILE		*filePointer;
-	rawReader	*readerTask;
+	QFile		theFile;
+	QTimer		progressTimer;
+	int64_t		nrSamples;
+	const uint8_t	*window;
+	int64_t		windowStart;
+	int64_t		windowSize;
+	std::atomic<int64_t>	filePosition;
+	std::atomic<int64_t>	seekPosition;
+	std::atomic<int64_t>	samplesRead;
+//	the number of samples that would have arrived at time 0, at
+//	2.048 samples per usec. One atomic value, so resetClock and
+//	Samples, on different threads, need no lock
+	std::atomic<int64_t>	clockBase;
+	std::atomic<bool>	maxSpeed;
 	std::atomic<bool>	running;
+	float		mapTable [256];
+	bool		mapWindow	(int64_t);
+	void		resetClock	();
 public slots:
-	void		setProgress	(int, float);
+	void		setProgress	();
+	void		handle_maxSpeed	(int);
+	void		handle_indexReady	(int);
+	void		handle_frameSelector	();
+	void		handle_timeSelector	();
 };
 
 #endif
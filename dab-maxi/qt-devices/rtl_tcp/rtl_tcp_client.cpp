@@ -27,7 +27,6 @@
 #include	<QLabel>
 #include	<QMessageBox>
 #include	<QHostAddress>
-#include	<QTcpSocket>
 #include	<QFileDialog>
 #include	<QDir>
 #include	"rtl_tcp_client.h"
@@ -55,7 +54,9 @@
 	tcp_gain	-> setValue (theGain);
 	tcp_ppm		-> setValue (thePpm);
 	vfoFrequency	= DEFAULT_FREQUENCY;
-	_I_Buffer	= new RingBuffer<std::complex<float>>(32 * 32768);
+	_I_Buffer	= new RingBuffer<std::complex<uint8_t>>(32 * 32768);
+	theReader	= new tcpReader (_I_Buffer);
+	lastBytes	= 0;
 	connected	= false;
 	hostLineEdit 	= new QLineEdit (nullptr);
 	dumping		= false;
@@ -70,6 +71,8 @@
 	         this, SLOT (set_fCorrection (int)));
 	connect (khzOffset, SIGNAL (valueChanged (int)),
 	         this, SLOT (set_Offset (int)));
+	connect (&statisticsTimer, SIGNAL (timeout ()),
+	         this, SLOT (show_statistics ()));
 	state	-> setText ("waiting to start");
 }
 
@@ -77,16 +80,16 @@
 	remoteSettings ->  beginGroup ("rtl_tcp_client");
 	if (connected) {		// close previous connection
 	   stopReader();
-//	   streamer. close();
 	   remoteSettings -> setValue ("remote-server",
-	                               toServer. peerAddress(). toString());
-	   QByteArray datagram;
+	                               serverAddress. toString());
 	}
 	remoteSettings -> setValue ("rtl_tcp_client-gain",   theGain);
 	remoteSettings -> setValue ("rtl_tcp_client-ppm",    thePpm);
 	remoteSettings -> setValue ("rtl_tcp_client-offset", vfoOffset);
 	remoteSettings -> endGroup();
-	toServer. close();
+	statisticsTimer. stop ();
+	theReader	-> stopReader ();
+	delete	theReader;
 	delete	_I_Buffer;
 	delete	hostLineEdit;
 }
@@ -129,24 +132,31 @@ QList<QHostAddress> ipAddressesList = QNetworkInterface::allAddresses();
 //	Using this text, we try to connect,
 void	rtl_tcp_client::setConnection() {
 QString s	= hostLineEdit -> text();
-QHostAddress theAddress	= QHostAddress (s);
 
-	serverAddress	= QHostAddress (s);
 	disconnect (hostLineEdit, SIGNAL (returnPressed (void)),
 	            this, SLOT (setConnection (void)));
-	toServer. connectToHost (serverAddress, basePort);
-	if (!toServer. waitForConnected (2000)) {
+	if (!connectTo (s, basePort)) {
 	   QMessageBox::warning (&myFrame, tr ("sdr"),
 	                                   tr ("connection failed\n"));
 	   return;
 	}
+}
+//
+//	connectTo is also used without the dialog, e.g. by the daemon
+bool	rtl_tcp_client::connectTo	(const QString &address, int port) {
+	serverAddress	= QHostAddress (address);
+	basePort	= port;
+	if (!theReader -> connectTo (serverAddress, basePort))
+	   return false;
 
 	sendGain (theGain);
 	sendRate (theRate);
 	sendVFO	(DEFAULT_FREQUENCY - theRate / 4);
-	toServer. waitForBytesWritten();
 	state -> setText ("Connected");
 	connected	= true;
+	lastBytes	= 0;
+	statisticsTimer. start (1000);
+	return true;
 }
 
 int32_t	rtl_tcp_client::getRate	() {
@@ -175,36 +185,17 @@ bool	rtl_tcp_client::restartReader	(int32_t freq) {
 	vfoFrequency	= freq;
 //	here the command to set the frequency
 	sendVFO (freq);
-	connect (&toServer, SIGNAL (readyRead (void)),
-	         this, SLOT (readData (void)));
+	theReader	-> setPassing (true);
 	return true;
 }
 
 void	rtl_tcp_client::stopReader() {
 	if (!connected)
 	   return;
-	disconnect (&toServer, SIGNAL (readyRead (void)),
-	            this, SLOT (readData (void)));
+	theReader	-> setPassing (false);
 }
 //
 //
-//	The brave old getSamples. For the dab stick, we get
-//	size: still in I/Q pairs, but we have to convert the data from
-//	uint8_t to DSPCOMPLEX *
-int32_t	rtl_tcp_client::getSamples (std::complex<float> *V, int32_t size) { 
-int32_t	amount;
-	amount = _I_Buffer	-> getDataFromBuffer (V, size);
-	return amount;
-}
-
-int32_t	rtl_tcp_client::Samples() {
-	return  _I_Buffer	-> GetRingBufferReadAvailable ();
-}
-//
-int16_t	rtl_tcp_client::bitDepth() {
-	return 8;
-}
-
 static 
 float mapTable [] = {
  -128 / 128.0 , -127 / 128.0 , -126 / 128.0 , -125 / 128.0 , -124 / 128.0 , -123 / 128.0 , -122 / 128.0 , -121 / 128.0 , -120 / 128.0 , -119 / 128.0 , -118 / 128.0 , -117 / 128.0 , -116 / 128.0 , -115 / 128.0 , -114 / 128.0 , -113 / 128.0 
@@ -224,41 +215,60 @@ float mapTable [] = {
 , 96 / 128.0 , 97 / 128.0 , 98 / 128.0 , 99 / 128.0 , 100 / 128.0 , 101 / 128.0 , 102 / 128.0 , 103 / 128.0 , 104 / 128.0 , 105 / 128.0 , 106 / 128.0 , 107 / 128.0 , 108 / 128.0 , 109 / 128.0 , 110 / 128.0 , 111 / 128.0 
 , 112 / 128.0 , 113 / 128.0 , 114 / 128.0 , 115 / 128.0 , 116 / 128.0 , 117 / 128.0 , 118 / 128.0 , 119 / 128.0 , 120 / 128.0 , 121 / 128.0 , 122 / 128.0 , 123 / 128.0 , 124 / 128.0 , 125 / 128.0 , 126 / 128.0 , 127 / 128.0 };
 
-//	These functions are typical for network use
-void	rtl_tcp_client::readData() {
-uint8_t	buffer [8192];
-std::complex<float> localBuffer [4096];
-
-	while (toServer. bytesAvailable() > 8192) {
-	   toServer. read ((char *)buffer, 8192);
-	   for (int i = 0; i < 4096; i ++)
-	      localBuffer [i] = std::complex<float> (
-	                                    mapTable [buffer [2 * i]],
-	                                    mapTable [buffer [2 * i + 1]]);
-	   _I_Buffer -> putDataIntoBuffer (localBuffer, 4096);
-	}
+//	The brave old getSamples. For the dab stick, we get
+//	size: still in I/Q pairs, but we have to convert the data from
+//	uint8_t to DSPCOMPLEX *
+int32_t	rtl_tcp_client::getSamples (std::complex<float> *V, int32_t size) { 
+std::complex<uint8_t> temp [size];
+int32_t	amount;
+	amount = _I_Buffer	-> getDataFromBuffer (temp, size);
+	for (int i = 0; i < amount; i ++)
+	   V [i] = std::complex<float> (mapTable [real (temp [i])],
+	                                mapTable [imag (temp [i])]);
+	return amount;
 }
 //
+//	the samples are kept as they come from the server,
+//	the sampleReader does the conversion
+int32_t	rtl_tcp_client::getRawSamples (void *V, int32_t size) {
+	return _I_Buffer -> getDataFromBuffer ((std::complex<uint8_t> *)V,
+	                                                            size);
+}
+
+int16_t	rtl_tcp_client::sampleFormat	() {
+	return SAMPLES_U8;
+}
+
+int32_t	rtl_tcp_client::Samples() {
+	return  _I_Buffer	-> GetRingBufferReadAvailable ();
+}
 //
-//	commands are packed in 5 bytes, one "command byte" 
-//	and an integer parameter
-struct command {
-	unsigned char cmd;
-	unsigned int param;
-}__attribute__((packed));
+int16_t	rtl_tcp_client::bitDepth() {
+	return 8;
+}
 
-#define	ONE_BYTE	8
+//	The samples are read by the tcpReader, in its own thread.
+//	Once a second we show what came in and what had to be dropped
+void	rtl_tcp_client::show_statistics	() {
+int64_t	bytes	= theReader -> bytesReceived ();
 
+	if (!theReader -> isConnected ()) {
+	   setDisconnect ();
+	   state	-> setText ("connection lost");
+	   return;
+	}
+	connectedLabel -> setText (QString::number ((bytes - lastBytes) / 1024) +
+	                           " kB/s, " +
+	                           QString::number (theReader -> overruns ()) +
+	                           " overruns, " +
+	                           QString::number (theReader -> samplesDropped ()) +
+	                           " dropped");
+	lastBytes	= bytes;
+}
+//
+//	commands are passed on to the reader, that sends them
 void	rtl_tcp_client::sendCommand (uint8_t cmd, int32_t param) {
-QByteArray datagram;
-
-	datagram. resize (5);
-	datagram [0] = cmd;		// command to set rate
-	datagram [4] = param & 0xFF;  //lsb last
-	datagram [3] = (param >> ONE_BYTE) & 0xFF;
-	datagram [2] = (param >> (2 * ONE_BYTE)) & 0xFF;
-	datagram [1] = (param >> (3 * ONE_BYTE)) & 0xFF;
-	toServer. write (datagram. data(), datagram. size());
+	theReader	-> sendCommand (cmd, param);
 }
 
 void rtl_tcp_client::sendVFO (int32_t frequency) {
@@ -289,12 +299,13 @@ void	rtl_tcp_client::setDisconnect() {
 	   stopReader();
 	   remoteSettings -> beginGroup ("rtl_tcp_client");
 	   remoteSettings -> setValue ("remote-server",
-	                               toServer. peerAddress(). toString());
+	                               serverAddress. toString());
 	   remoteSettings -> setValue ("rtl_tcp_client-gain", theGain);
 	   remoteSettings -> setValue ("rtl_tcp_client-ppm", thePpm);
 	   remoteSettings -> endGroup();
-	   toServer. close();
+	   theReader	-> stopReader ();
 	}
+	statisticsTimer. stop ();
 	connected	= false;
 	connectedLabel	-> setText (" ");
 	state		-> setText ("disconnected");
@@ -31,13 +31,13 @@
 #include	<QLineEdit>
 #include	<QHostAddress>
 #include	<QByteArray>
-#include	<QTcpSocket>
 #include	<QTimer>
 #include	<QComboBox>
 #include	<cstdio>
 #include	"dab-constants.h"
 #include	"device-handler.h"
 #include	"ringbuffer.h"
+#include	"tcp-reader.h"
 #include	"ui_rtl_tcp-widget.h"
 
 class	rtl_tcp_client: public deviceHandler, Ui_rtl_tcp_widget {
@@ -52,16 +52,19 @@ public:
 	bool		restartReader	(int32_t);
 	void		stopReader	();
 	int32_t		getSamples	(std::complex<float> *V, int32_t size);
+	int32_t		getRawSamples	(void *, int32_t);
+	int16_t		sampleFormat	();
 	int32_t		Samples		();
 	void		show		();
 	void		hide		();
 	bool		isHidden	();
 	int16_t		bitDepth	();
+	bool		connectTo	(const QString &, int);
 private slots:
 	void		sendGain	(int);
 	void		set_Offset	(int);
 	void		set_fCorrection	(int);
-	void		readData	();
+	void		show_statistics	();
 	void		setConnection	();
 	void		wantConnect	();
 	void		setDisconnect	();
@@ -76,12 +79,14 @@ private:
 	QSettings	*remoteSettings;
 	int32_t		theRate;
 	int32_t		vfoFrequency;
-	RingBuffer<std::complex<float>>	*_I_Buffer;
+	RingBuffer<std::complex<uint8_t>>	*_I_Buffer;
 	bool		connected;
 	int16_t		theGain;
 	int16_t		thePpm;
 	QHostAddress	serverAddress;
-	QTcpSocket	toServer;
+	tcpReader	*theReader;
+	QTimer		statisticsTimer;
+	int64_t		lastBytes;
 	qint64		basePort;
 	bool		dumping;
 	FILE		*dumpfilePointer;
@@ -0,0 +1,213 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"tcp-reader.h"
+#include	<QTcpSocket>
+//
+//	At 2048000 samples/second, the server delivers app 4 Mbyte/second,
+//	a batch of 256 k bytes is app 60 msec of input.
+//	The socket buffer is made large enough to bridge a
+//	second or so in which we are not reading
+#define	BATCH_SIZE	(256 * 1024)
+#define	SOCKET_BUFFER	(4 * 1024 * 1024)
+//
+//	a fresh connection starts with a 12 byte "dongle info",
+//	"RTL0", the tuner type and the number of gain settings
+#define	HEADER_SIZE	12
+
+	tcpReader::tcpReader (RingBuffer<std::complex<uint8_t>> *b) {
+	theBuffer	= b;
+	serverPort	= 0;
+	running. store (false);
+	connected. store (false);
+	passing. store (false);
+	theTuner. store (0);
+	bytesIn. store (0);
+	droppedSamples. store (0);
+	overrunCount. store (0);
+}
+
+	tcpReader::~tcpReader	() {
+	stopReader ();
+}
+//
+//	connectTo is called from the GUI thread, the connection
+//	is made in the reader thread, we wait here for the outcome
+bool	tcpReader::connectTo	(const QHostAddress &address,
+	                                 qint64 port) {
+	if (isRunning ())
+	   return connected. load ();
+	serverAddress	= address;
+	serverPort	= port;
+	bytesIn. store (0);
+	droppedSamples. store (0);
+	overrunCount. store (0);
+	running. store (true);
+	start ();
+	connectDone. acquire ();
+	if (!connected. load ()) {
+	   running. store (false);
+	   wait ();
+	}
+	return connected. load ();
+}
+
+void	tcpReader::stopReader	() {
+	if (!isRunning ())
+	   return;
+	running. store (false);
+	wait ();
+}
+//
+//	While not passing, the data is read from the socket and discarded,
+//	the server keeps sending anyway
+void	tcpReader::setPassing	(bool b) {
+	passing. store (b);
+}
+//
+//	commands are packed in 5 bytes, one "command byte"
+//	and an integer parameter, msb first
+void	tcpReader::sendCommand	(uint8_t cmd, int32_t param) {
+	if (!connected. load ())
+	   return;
+	commandLocker. lock ();
+	pendingCommands. push_back (cmd);
+	pendingCommands. push_back ((param >> 24) & 0xFF);
+	pendingCommands. push_back ((param >> 16) & 0xFF);
+	pendingCommands. push_back ((param >>  8) & 0xFF);
+	pendingCommands. push_back (param & 0xFF);
+	commandLocker. unlock ();
+}
+
+bool	tcpReader::isConnected	() {
+	return connected. load ();
+}
+
+int32_t	tcpReader::tunerType	() {
+	return theTuner. load ();
+}
+
+int64_t	tcpReader::bytesReceived	() {
+	return bytesIn. load ();
+}
+
+int64_t	tcpReader::samplesDropped	() {
+	return droppedSamples. load ();
+}
+
+int32_t	tcpReader::overruns	() {
+	return overrunCount. load ();
+}
+
+void	tcpReader::sendPending	(QTcpSocket *s) {
+std::vector<uint8_t> commands;
+
+	commandLocker. lock ();
+	commands. swap (pendingCommands);
+	commandLocker. unlock ();
+	if (commands. size () == 0)
+	   return;
+	s -> write ((const char *)commands. data (), commands. size ());
+	s -> waitForBytesWritten (100);
+}
+//
+//	If the ringbuffer cannot hold the batch, the excess is
+//	dropped and counted, the reader never blocks on the buffer
+void	tcpReader::storeSamples	(std::complex<uint8_t> *v, int32_t n) {
+int32_t	space	= theBuffer -> GetRingBufferWriteAvailable ();
+
+	if (n > space) {
+	   droppedSamples. fetch_add (n - space);
+	   overrunCount. fetch_add (1);
+	   n	= space;
+	}
+	theBuffer -> putDataIntoBuffer (v, n);
+}
+//
+//	Servers other than rtl_tcp itself (e.g. a replay server)
+//	may omit the header, so we only skip it when it is there
+void	tcpReader::readHeader	(QTcpSocket *s) {
+uint8_t	header [HEADER_SIZE];
+
+	while (running. load () && (s -> bytesAvailable () < HEADER_SIZE))
+	   if (!s -> waitForReadyRead (1000))
+	      return;
+	if (s -> peek ((char *)header, 4) != 4)
+	   return;
+	if ((header [0] != 'R') || (header [1] != 'T') ||
+	    (header [2] != 'L') || (header [3] != '0'))
+	   return;
+	s -> read ((char *)header, HEADER_SIZE);
+	theTuner. store ((header [4] << 24) | (header [5] << 16) |
+	                 (header [6] << 8) | header [7]);
+}
+
+void	tcpReader::run	() {
+QTcpSocket	toServer;
+std::vector<uint8_t> buffer (BATCH_SIZE);
+int32_t	carry	= 0;
+
+	toServer. connectToHost (serverAddress, serverPort);
+	connected. store (toServer. waitForConnected (2000));
+	if (!connected. load ()) {
+	   connectDone. release ();
+	   return;
+	}
+	toServer. setSocketOption (QAbstractSocket::LowDelayOption, 1);
+	toServer. setSocketOption (QAbstractSocket::ReceiveBufferSizeSocketOption,
+	                                                      SOCKET_BUFFER);
+	connectDone. release ();
+	readHeader (&toServer);
+
+	while (running. load ()) {
+	   sendPending (&toServer);
+	   if ((toServer. bytesAvailable () == 0) &&
+	       !toServer. waitForReadyRead (50)) {
+	      if (toServer. state () != QAbstractSocket::ConnectedState)
+	         break;
+	      continue;
+	   }
+	   qint64 n = toServer. read ((char *)&buffer [carry],
+	                                        BATCH_SIZE - carry);
+	   if (n <= 0)
+	      continue;
+	   bytesIn. fetch_add (n);
+	   n	+= carry;
+//
+//	a batch may end halfway an I/Q pair, the odd byte is kept
+//	as start of the next batch
+	   if (passing. load ())
+	      storeSamples ((std::complex<uint8_t> *)buffer. data (), n / 2);
+	   carry	= n & 01;
+	   if (carry != 0)
+	      buffer [0] = buffer [n - 1];
+	}
+
+	if (toServer. state () == QAbstractSocket::ConnectedState) {
+	   toServer. disconnectFromHost ();
+	   if (toServer. state () != QAbstractSocket::UnconnectedState)
+	      toServer. waitForDisconnected (500);
+	}
+	connected. store (false);
+}
+
@@ -0,0 +1,78 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef	__TCP_READER__
+#define	__TCP_READER__
+/*
+ *	The tcpReader owns the connection with the rtl_tcp server.
+ *	It runs in a thread of its own, so that the samples are read
+ *	independent of the load on the GUI thread.
+ *	The socket is used in blocking mode, the samples are read
+ *	in large batches and passed - unconverted - to the ringbuffer.
+ *	Commands for the server are queued and sent by the
+ *	reader thread, since a QTcpSocket is not thread safe
+ */
+#include	<QThread>
+#include	<QSemaphore>
+#include	<QMutex>
+#include	<QHostAddress>
+#include	<atomic>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"ringbuffer.h"
+
+class	QTcpSocket;
+
+class	tcpReader: public QThread {
+public:
+			tcpReader	(RingBuffer<std::complex<uint8_t>> *);
+			~tcpReader	();
+	bool		connectTo	(const QHostAddress &, qint64);
+	void		stopReader	();
+	void		setPassing	(bool);
+	void		sendCommand	(uint8_t, int32_t);
+	bool		isConnected	();
+	int32_t		tunerType	();
+	int64_t		bytesReceived	();
+	int64_t		samplesDropped	();
+	int32_t		overruns	();
+private:
+	void		run		();
+	void		readHeader	(QTcpSocket *);
+	void		sendPending	(QTcpSocket *);
+	void		storeSamples	(std::complex<uint8_t> *, int32_t);
+	RingBuffer<std::complex<uint8_t>>	*theBuffer;
+	QHostAddress	serverAddress;
+	qint64		serverPort;
+	QSemaphore	connectDone;
+	QMutex		commandLocker;
+	std::vector<uint8_t>	pendingCommands;
+	std::atomic<bool>	running;
+	std::atomic<bool>	connected;
+	std::atomic<bool>	passing;
+	std::atomic<int32_t>	theTuner;
+	std::atomic<int64_t>	bytesIn;
+	std::atomic<int64_t>	droppedSamples;
+	std::atomic<int32_t>	overrunCount;
+};
+#endif
+
@@ -353,17 +353,37 @@ int32_t	rtlsdrHandler::getSamples (std::complex<float> *V, int32_t size) {
 std::complex<uint8_t> temp [size];
 int	amount;
 
-static uint8_t dumpBuffer [4096];
-static int iqTeller	= 0;
-	amount = _I_Buffer. getDataFromBuffer (temp, size);
+	amount = getRawSamples (temp, size);
 	for (int i = 0; i < amount; i ++) 
 	   V [i] = std::complex<float> (mapTable [real (temp [i])],
 	                                mapTable [imag (temp [i])]);
+	return amount;
+}
+//
+//	The samples are kept in the ringbuffer as they come from
+//	the stick, the sampleReader does the conversion
+int32_t	rtlsdrHandler::getRawSamples (void *V, int32_t size) {
+std::complex<uint8_t> *temp = (std::complex<uint8_t> *)V;
+int	amount;
+
+	amount = _I_Buffer. getDataFromBuffer (temp, size);
+	dumpSamples (temp, amount);
+	return amount;
+}
+
+int16_t	rtlsdrHandler::sampleFormat	() {
+	return SAMPLES_U8;
+}
+
+void	rtlsdrHandler::dumpSamples (std::complex<uint8_t> *temp, int amount) {
+static uint8_t dumpBuffer [4096];
+static int iqTeller	= 0;
+
 	if (xml_dumping. load ())
 	   xmlWriter -> add (temp, amount);
 	else
 	if (iq_dumping. load ()) {
-	   for (int i = 0; i < size; i ++) {
+	   for (int i = 0; i < amount; i ++) {
 	      dumpBuffer [iqTeller]	= real (temp [i]);
 	      dumpBuffer [iqTeller + 1]	= imag (temp [i]);
 	      iqTeller += 2;
@@ -373,7 +393,6 @@ static int iqTeller	= 0;
 	      }
 	   }
 	}
-	return amount;
 }
 
 int32_t	rtlsdrHandler::Samples() {
@@ -83,6 +83,8 @@ public:
 	bool		restartReader	(int32_t);
 	void		stopReader	();
 	int32_t		getSamples	(std::complex<float> *, int32_t);
+	int32_t		getRawSamples	(void *, int32_t);
+	int16_t		sampleFormat	();
 	int32_t		Samples		();
 	void		resetBuffer	();
 	int16_t		maxGain		();
@@ -117,6 +119,7 @@ private:
         bool            setup_iqDump		();
         void            close_iqDump		();
         std::atomic<bool> iq_dumping;
+	void		dumpSamples	(std::complex<uint8_t> *, int);
 	void		record_gainSettings	(int);
 	void		update_gainSettings	(int);
 	bool		save_gainSettings;
@@ -36,8 +36,10 @@ struct timeval  tv;
 
 	wavReader::wavReader	(wavFiles	*mr,
 	                         SNDFILE	*filePointer,
-	                         RingBuffer<std::complex<float> > *theBuffer) {
+	                         RingBuffer<std::complex<float> > *theBuffer,
+	                         bool		batchMode) {
 	this	-> parent	= mr;
+	this	-> batchMode	= batchMode;
 	this	-> filePointer	= filePointer;
 	this	-> theBuffer	= theBuffer;
 	fileLength		= sf_seek (filePointer, 0, SEEK_END);
@@ -65,6 +67,7 @@ void	wavReader::run	() {
 int32_t	bufferSize	= 32768;
 int64_t	nextStop;
 int	teller		= 0;
+int64_t	samplesRead	= 0;
 std::complex<float> bi [bufferSize];
 
 	connect (this, SIGNAL (setProgress (int, float)),
@@ -92,12 +95,25 @@ std::complex<float> bi [bufferSize];
 	      nextStop += period;
 	      int n = sf_readf_float (filePointer,
 		                             (float *)bi, bufferSize);
+//
+//	in batch mode we stop at the end of the file, once
+//	the consumer has taken what it will take
+	      if ((n < bufferSize) && batchMode) {
+	         theBuffer -> putDataIntoBuffer (bi, n);
+	         samplesRead	+= n;
+	         parent -> wait_drained (theBuffer);
+	         parent -> batch_done (samplesRead, INPUT_RATE);
+	         break;
+	      }
 	      if (n < bufferSize) {
 	         sf_seek (filePointer, 0, SEEK_SET);
 	         for (int i = n; i < bufferSize; i ++)
 	            bi [i] = std::complex <float> (0, 0);
 	      }
 	      theBuffer -> putDataIntoBuffer (bi, bufferSize);
+	      samplesRead	+= bufferSize;
+	      if (batchMode)
+	         continue;
 	      if (nextStop - getMyTime() > 0)
 	         usleep (nextStop - getMyTime());
 	   }
@@ -35,7 +35,8 @@ Q_OBJECT
 public:
 			wavReader	(wavFiles *,
 	                                 SNDFILE *,
-	                                 RingBuffer<std::complex<float>> *); 
+	                                 RingBuffer<std::complex<float>> *,
+	                                 bool batchMode = false); 
 			~wavReader();
 	void		startReader();
 	void		stopReader();
@@ -45,6 +46,7 @@ virtual void		run		();
 	RingBuffer<std::complex<float> >	*theBuffer;
 	uint64_t	period;
 	std::atomic<bool>	running;
+	bool		batchMode;
 	wavFiles	*parent;
 	int64_t		fileLength;
 signals:
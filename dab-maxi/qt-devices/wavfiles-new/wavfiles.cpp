@@ -78,7 +78,8 @@ bool	wavFiles::restartReader		(int32_t freq) {
 	(void)freq;
 	if (running. load())
            return true;
-        readerTask      = new wavReader (this, filePointer, &_I_Buffer);
+        readerTask      = new wavReader (this, filePointer, &_I_Buffer,
+	                                                 batchMode. load ());
         running. store (true);
         return true;
 }
@@ -0,0 +1,189 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"wideband-reader.h"
+#include	"xml-descriptor.h"
+#include	"channelizer.h"
+#include	<unistd.h>
+#include	<cstring>
+//
+//	the reader reads 10 msec worth of samples per cycle
+#define	BLOCKS_PER_SECOND	100
+
+#define	UINT8_CONTAINER		0
+#define	INT8_CONTAINER		1
+#define	INT16_CONTAINER		2
+#define	FLOAT32_CONTAINER	3
+
+	widebandReader::widebandReader (const QString &fileName) {
+bool	ok	= false;
+
+	theFile	= fopen (fileName. toUtf8 (). data (), "rb");
+	if (theFile == nullptr) {
+	   fprintf (stderr, "file %s cannot open\n",
+	                                   fileName. toUtf8 (). data ());
+	   throw (31);
+	}
+	theDescriptor	= new xmlDescriptor (theFile, &ok);
+	if (!ok) {
+	   fprintf (stderr, "%s probably not an xml file\n",
+	                               fileName. toUtf8 (). data ());
+	   delete theDescriptor;
+	   fclose (theFile);
+	   throw (32);
+	}
+
+	if ((theDescriptor -> iqOrder != "IQ") &&
+	    (theDescriptor -> iqOrder != "QI")) {
+	   fprintf (stderr, "%s: only IQ and QI recordings are supported\n",
+	                               fileName. toUtf8 (). data ());
+	   delete theDescriptor;
+	   fclose (theFile);
+	   throw (33);
+	}
+
+	if (theDescriptor -> container == "uint8") {
+	   containerType	= UINT8_CONTAINER;
+	   elementSize		= 1;
+	}
+	else
+	if (theDescriptor -> container == "int8") {
+	   containerType	= INT8_CONTAINER;
+	   elementSize		= 1;
+	}
+	else
+	if (theDescriptor -> container == "int16") {
+	   containerType	= INT16_CONTAINER;
+	   elementSize		= 2;
+	}
+	else
+	if (theDescriptor -> container == "float32") {
+	   containerType	= FLOAT32_CONTAINER;
+	   elementSize		= 4;
+	}
+	else {
+	   fprintf (stderr, "container %s not supported\n",
+	                theDescriptor -> container. toUtf8 (). data ());
+	   delete theDescriptor;
+	   fclose (theFile);
+	   throw (34);
+	}
+
+	msbFirst	= theDescriptor -> byteOrder == "MSB";
+	scaler		= float (1 << (theDescriptor -> bitsperChannel - 1));
+	samplesToRead	= theDescriptor -> blockList [0]. nrElements;
+	if (theDescriptor -> blockList [0]. typeofUnit == "Channel")
+	   samplesToRead /= 2;
+	rawBuffer. resize (theDescriptor -> sampleRate /
+	                             BLOCKS_PER_SECOND * 2 * elementSize);
+	sampleBuffer. resize (theDescriptor -> sampleRate / BLOCKS_PER_SECOND);
+	theChannelizer	= nullptr;
+	samplesRead. store (0);
+	running. store (false);
+}
+
+	widebandReader::~widebandReader	() {
+	stopReader ();
+	delete theDescriptor;
+	fclose (theFile);
+}
+
+int32_t	widebandReader::get_sampleRate	() {
+	return theDescriptor -> sampleRate;
+}
+
+int32_t	widebandReader::get_centerFrequency	() {
+	return theDescriptor -> blockList [0]. frequency;
+}
+
+float	widebandReader::get_progress	() {
+	if (samplesToRead <= 0)
+	   return 0;
+	return (float)samplesRead. load () / samplesToRead;
+}
+
+void	widebandReader::startReader	(channelizer *c) {
+	if (running. load ())
+	   return;
+	theChannelizer	= c;
+	running. store (true);
+	start ();
+}
+
+void	widebandReader::stopReader	() {
+	if (!isRunning ())
+	   return;
+	running. store (false);
+	while (isRunning ())
+	   usleep (1000);
+}
+
+float	widebandReader::getElement	(const uint8_t *p) {
+	switch (containerType) {
+	   case UINT8_CONTAINER:
+	      return (p [0] - 128) / 128.0;
+
+	   case INT8_CONTAINER:
+	      return ((int8_t)p [0]) / 127.0;
+
+	   case INT16_CONTAINER: {
+	      int16_t v = msbFirst ? (p [0] << 8) | p [1] :
+	                             (p [1] << 8) | p [0];
+	      return v / scaler;
+	   }
+
+	   default: {		// float32
+	      uint32_t v = msbFirst ?
+	                   (p [0] << 24) | (p [1] << 16) | (p [2] << 8) | p [3] :
+	                   (p [3] << 24) | (p [2] << 16) | (p [1] << 8) | p [0];
+	      float	f;
+	      memcpy (&f, &v, sizeof (float));
+	      return f;
+	   }
+	}
+}
+//
+//	No pacing here, the channelizer - and through the channelizer
+//	the slowest dabProcessor - determines the speed
+void	widebandReader::run	() {
+bool	iq	= theDescriptor -> iqOrder == "IQ";
+
+	fseek (theFile, 5000, SEEK_SET);
+	samplesRead. store (0);
+	while (running. load () && (samplesRead. load () < samplesToRead)) {
+	   int amount = fread (rawBuffer. data (), 2 * elementSize,
+	                                    sampleBuffer. size (), theFile);
+	   if (amount <= 0)
+	      break;
+	   for (int i = 0; i < amount; i ++) {
+	      float a = getElement (&rawBuffer [2 * i * elementSize]);
+	      float b = getElement (&rawBuffer [(2 * i + 1) * elementSize]);
+	      sampleBuffer [i] = iq ? std::complex<float> (a, b) :
+	                              std::complex<float> (b, a);
+	   }
+	   theChannelizer -> process (sampleBuffer. data (), amount);
+	   samplesRead. store (samplesRead. load () + amount);
+	}
+	running. store (false);
+	emit readerDone ();
+}
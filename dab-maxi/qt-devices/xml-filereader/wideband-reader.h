@@ -0,0 +1,72 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__WIDEBAND_READER__
+#define	__WIDEBAND_READER__
+/*
+ *	The widebandReader reads an xml file, recorded with a
+ *	samplerate higher than the 2048000 used for DAB, as fast as
+ *	possible and passes the samples on to a channelizer.
+ *	Unlike the xml_Reader, it does not resample to 2048000
+ *	and does not pace the reading to real time.
+ */
+#include	<QThread>
+#include	<QString>
+#include	<atomic>
+#include	<vector>
+#include	<cstdio>
+#include	"dab-constants.h"
+
+class	xmlDescriptor;
+class	channelizer;
+
+class	widebandReader: public QThread {
+Q_OBJECT
+public:
+			widebandReader	(const QString &);
+			~widebandReader	();
+	int32_t		get_sampleRate		();
+	int32_t		get_centerFrequency	();
+	void		startReader	(channelizer *);
+	void		stopReader	();
+	float		get_progress	();
+private:
+	FILE		*theFile;
+	xmlDescriptor	*theDescriptor;
+	channelizer	*theChannelizer;
+	int		containerType;
+	int		elementSize;
+	bool		msbFirst;
+	float		scaler;
+	int64_t		samplesToRead;
+	std::atomic<int64_t>	samplesRead;
+	std::atomic<bool>	running;
+	std::vector<uint8_t>	rawBuffer;
+	std::vector<std::complex<float>>	sampleBuffer;
+	void		run		();
+	float		getElement	(const uint8_t *);
+signals:
+	void		readerDone	();
+};
+#endif
+
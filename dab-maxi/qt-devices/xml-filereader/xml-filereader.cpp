@@ -80,6 +80,24 @@
 	connect (continuousButton, SIGNAL (clicked ()),
 	         this, SLOT (handle_continuousButton ()));
 	running. store (false);
+	theReader	= nullptr;
+
+	frameSelector	= new QSpinBox ();
+	frameSelector	-> setPrefix ("frame ");
+	frameSelector	-> setEnabled (false);
+	timeSelector	= new QSpinBox ();
+	timeSelector	-> setSuffix (" sec");
+	timeSelector	-> setEnabled (false);
+	myFrame. layout () -> addWidget (frameSelector);
+	myFrame. layout () -> addWidget (timeSelector);
+	theIndexer	= new xmlIndexer (f, theDescriptor, 5000);
+	connect (theIndexer, SIGNAL (indexReady (int)),
+	         this, SLOT (handle_indexReady (int)));
+	connect (frameSelector, SIGNAL (editingFinished ()),
+	         this, SLOT (handle_frameSelector ()));
+	connect (timeSelector, SIGNAL (editingFinished ()),
+	         this, SLOT (handle_timeSelector ()));
+	theIndexer	-> start_indexing ();
 }
 
 	xml_fileReader::~xml_fileReader	() {
@@ -89,6 +107,9 @@
 	      usleep (100);
 	   delete theReader;
 	}
+	delete	theIndexer;
+	delete	frameSelector;
+	delete	timeSelector;
 	if (theFile != nullptr)
 	   fclose (theFile);
 
@@ -103,7 +124,8 @@ bool	xml_fileReader::restartReader (int32_t freq) {
 	                                 theFile,
 	                                 theDescriptor,
 	                                 5000,
-	                                 &_I_Buffer);
+	                                 &_I_Buffer,
+	                                 batchMode. load ());
 	running. store (true);
 	return true;
 }
@@ -154,6 +176,32 @@ void	xml_fileReader::handle_continuousButton () {
 	theReader -> handle_continuousButton ();
 }
 
+void	xml_fileReader::handle_indexReady	(int nrFrames) {
+	frameSelector	-> setRange (0, nrFrames > 0 ? nrFrames - 1 : 0);
+	timeSelector	-> setRange (0, theIndexer -> frameStart (nrFrames - 1) /
+	                                       theDescriptor -> sampleRate);
+	frameSelector	-> setEnabled (nrFrames > 0);
+	timeSelector	-> setEnabled (nrFrames > 0);
+}
+//
+//	the position in the frame is kept, so the dabProcessor
+//	remains synchronized
+void	xml_fileReader::seekFrame	(int32_t frame) {
+	if (theReader == nullptr)
+	   return;
+	theReader -> seek (theIndexer -> alignedPosition (frame,
+	                                      theReader -> position ()));
+}
+
+void	xml_fileReader::handle_frameSelector	() {
+	seekFrame (frameSelector -> value ());
+}
+
+void	xml_fileReader::handle_timeSelector	() {
+	seekFrame (theIndexer -> frameAt ((int64_t)timeSelector -> value () *
+	                                       theDescriptor -> sampleRate));
+}
+
 void	xml_fileReader::show	() {
 	myFrame. show ();
 }
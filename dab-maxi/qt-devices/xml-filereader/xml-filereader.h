@@ -26,6 +26,7 @@
 #include	<QThread>
 #include	<QString>
 #include	<QFrame>
+#include	<QSpinBox>
 #include	<atomic>
 #include	"dab-constants.h"
 #include	"device-handler.h"
@@ -35,7 +36,10 @@
 class	QSettings;
 class	xmlDescriptor;
 class	xml_Reader;
+class	xmlIndexer;
 /*
+ *	Once the frames are indexed, one may jump to a frame or
+ *	to a time (in seconds from the start)
  */
 class	xml_fileReader: public deviceHandler, public Ui_xmlfile_widget {
 Q_OBJECT
@@ -60,9 +64,16 @@ private:
 	uint32_t		filePointer;
 	xmlDescriptor		*theDescriptor;
 	xml_Reader		*theReader;
+	xmlIndexer		*theIndexer;
+	QSpinBox		*frameSelector;
+	QSpinBox		*timeSelector;
+	void			seekFrame	(int32_t);
 public slots:
 	void			setProgress	(int, int);
 	void			handle_continuousButton ();
+	void			handle_indexReady	(int);
+	void			handle_frameSelector	();
+	void			handle_timeSelector	();
 };
 
 #endif
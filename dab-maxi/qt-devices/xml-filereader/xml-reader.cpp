@@ -34,11 +34,6 @@ int r	= 1;
 	return r;
 }
 
-static inline
-std::complex<float> compmul (std::complex<float> a, float b) {
-	return std::complex<float> (real (a) * b, imag (a) * b);
-}
-
 static inline
 uint64_t	currentTime () {
 struct timeval tv;
@@ -52,27 +47,25 @@ struct timeval tv;
 	                        FILE	*f,
 	                        xmlDescriptor *fd,
 	                        uint32_t	filePointer,
-	                        RingBuffer<std::complex<float>> *b) {
+	                        RingBuffer<std::complex<float>> *b,
+	                        bool		batchMode):
+	                                theResampler (fd -> sampleRate,
+	                                              INPUT_RATE) {
 	this	-> parent	= mr;
+	this	-> batchMode	= batchMode;
 	this	-> file		= f;
 	this	-> fd		= fd;
 	this	-> filePointer	= filePointer;
 	sampleBuffer		= b;
 //
-//	convBufferSize is a little confusing since the actual 
-//	buffer is one larger
+//	per cycle we read 1 msec of data
 	convBufferSize		= fd -> sampleRate / 1000;
 	continuous. store (false);
-
-	for (int i = 0; i < 2048; i ++) {
-	   float inVal = float (fd -> sampleRate / 1000);
-	   mapTable_int [i] = (int)(floor (i * (inVal / 2048.0)));
-	   mapTable_float [i] = i * (inVal / 2048.0) - mapTable_int [i];
-	}
-
-	convIndex	= 0;
-	convBuffer. resize (convBufferSize + 1);
+	convBuffer. resize (convBufferSize);
+	outBuffer. resize (theResampler. maxOutput (convBufferSize));
 	nrElements	= fd -> blockList [0]. nrElements;
+	seekRequest. store (-1);
+	filePosition. store (0);
 
 	connect (this, SIGNAL (setProgress (int, int)),
 	         parent, SLOT (setProgress (int, int)));
@@ -97,11 +90,13 @@ void	xml_Reader::stopReader	() {
 
 static	int cycleCount = 0;
 void	xml_Reader::run () {
-int	samplesRead	= 0;
+int64_t	samplesRead	= 0;
+int64_t	samplesDone	= 0;
 uint64_t	nextStop;
 int	startPoint	= filePointer;
+int	sampleSize	= bytesperSample (fd);
 
-	fseek (file, filePointer, SEEK_SET);
+	fseeko (file, filePointer, SEEK_SET);
 	nextStop = currentTime ();
 	running. store (true);
 	for (int blocks = 0; blocks < fd -> nrBlocks; blocks ++) {
@@ -110,21 +105,26 @@ int	startPoint	= filePointer;
 	   samplesRead		= 0;
 	   do {
 	      while ((samplesRead <= samplesToRead) && running. load ()) {
+//
+//	a seek (from the GUI) is handled here, in the reader thread
+	         int64_t target	= seekRequest. exchange (-1);
+	         if (target >= 0) {
+	            fseeko (file, startPoint + target * sampleSize, SEEK_SET);
+	            samplesRead	= target;
+	         }
 
-	         if (fd -> iqOrder == "IQ") 
-	            samplesRead += readSamples (file,
-	                                        &xml_Reader::readElements_IQ);
-	         else
-	          if (fd -> iqOrder == "QI")
-	            samplesRead += readSamples (file, 
-	                                        &xml_Reader::readElements_QI);
-	         else
-	         if (fd -> iqOrder == "I_Only")
-	            samplesRead += readSamples (file,
-	                                        &xml_Reader::readElements_I);
-	         else
-	            samplesRead += readSamples (file,
-	                                        &xml_Reader::readElements_Q);
+//
+//	in batch mode, we wait for the consumer rather than for the clock
+	         if (batchMode) {
+	            while ((sampleBuffer -> WriteSpace () <
+	                               (int32_t)outBuffer. size ()) &&
+	                                                running. load ())
+	               usleep (100);
+	         }
+	         int n		= readSamples (file);
+	         samplesRead	+= n;
+	         samplesDone	+= n;
+	         filePosition. store (samplesRead);
 
 	         if (++cycleCount >= 200) {
 	            setProgress (samplesRead, samplesToRead);
@@ -134,15 +134,27 @@ int	startPoint	= filePointer;
 //	the readSamples function returns 1 msec of data,
 //	we assume taking this data does not take time
 	         nextStop = nextStop + (uint64_t)1000;
-	         if (nextStop > currentTime ())
+	         if (!batchMode && (nextStop > currentTime ()))
 	            usleep ( nextStop - currentTime ());
 	      }
 	      setProgress (0, samplesToRead);
 	      filePointer = startPoint;
-	      fseek (file, filePointer, SEEK_SET);
+	      fseeko (file, filePointer, SEEK_SET);
 	      samplesRead		= 0;
-	   } while (running.load () && continuous. load ());
+	   } while (running.load () && continuous. load () && !batchMode);
 	}
+	if (!batchMode)
+	   return;
+	parent -> wait_drained (sampleBuffer);
+	parent -> batch_done (samplesDone, fd -> sampleRate);
+}
+
+void	xml_Reader::seek	(int64_t sample) {
+	seekRequest. store (sample);
+}
+
+int64_t	xml_Reader::position	() {
+	return filePosition. load ();
 }
 
 void	xml_Reader::handle_continuousButton  () {
@@ -171,22 +183,80 @@ int	samplesToRead	= 0;
 	return samplesToRead;
 }
 
-int	xml_Reader::readSamples (FILE *theFile, 
-	                         void(xml_Reader::*r)(FILE *theFile,
-	                                    std::complex<float> *, int)) {
-std::complex<float> temp [2048];
-
-	(*this.*r) (theFile, &convBuffer [1], convBufferSize);
-	for (int i = 0; i < 2048; i ++) {
-	   int16_t inpBase	= mapTable_int [i];
-	   float   inpRatio	= mapTable_float [i];
-	   temp [i] = compmul (convBuffer [inpBase + 1], inpRatio) +
-	                       compmul (convBuffer [inpBase], 1 - inpRatio);
+//
+//	readSamples returns the number of samples read from the file,
+//	these are resampled to 2048000
+int	xml_Reader::readSamples (FILE *theFile) {
+int	amount;
+
+	readBlock (fd, theFile, convBuffer. data (), convBufferSize);
+	amount	= theResampler. resample (convBuffer. data (), convBufferSize,
+	                                  outBuffer. data ());
+	sampleBuffer -> putDataIntoBuffer (outBuffer. data (), amount);
+	return convBufferSize;
+}
+//
+//	the conversion functions only depend on the descriptor,
+//	so the indexer can use them as well
+void	xml_Reader::readBlock	(xmlDescriptor *fd, FILE *theFile,
+	                         std::complex<float> *buffer, int amount) {
+	if (fd -> iqOrder == "IQ") 
+	   readElements_IQ (fd, theFile, buffer, amount);
+	else
+	if (fd -> iqOrder == "QI")
+	   readElements_QI (fd, theFile, buffer, amount);
+	else
+	if (fd -> iqOrder == "I_Only")
+	   readElements_I (fd, theFile, buffer, amount);
+	else
+	   readElements_Q (fd, theFile, buffer, amount);
+}
+
+int	xml_Reader::bytesperSample	(xmlDescriptor *fd) {
+int	elementSize	= 4;		// int32 and float32
+
+	if ((fd -> container == "int8") || (fd -> container == "uint8"))
+	   elementSize	= 1;
+	else
+	if (fd -> container == "int16")
+	   elementSize	= 2;
+	else
+	if (fd -> container == "int24")
+	   elementSize	= 3;
+	if ((fd -> iqOrder == "IQ") || (fd -> iqOrder == "QI"))
+	   return 2 * elementSize;
+	return elementSize;
+}
+
+	xmlIndexer::xmlIndexer	(const QString &f, xmlDescriptor *fd,
+	                         uint32_t filePointer):
+	                           frameIndexer (f, fd -> sampleRate) {
+	this	-> fd	= fd;
+	theFile	= fopen (f. toUtf8 (). data (), "rb");
+	sampleSize	= xml_Reader::bytesperSample (fd);
+	samplesLeft	= 0;
+	if (theFile != nullptr) {
+	   fseeko (theFile, 0, SEEK_END);
+	   samplesLeft	= (ftello (theFile) - filePointer) / sampleSize;
+	   fseeko (theFile, filePointer, SEEK_SET);
 	}
-	convBuffer [0] = convBuffer [convBufferSize];
-	convIndex = 1;
-	sampleBuffer -> putDataIntoBuffer (temp, 2048);
-	return 2048;
+}
+
+	xmlIndexer::~xmlIndexer	() {
+	stop ();
+	if (theFile != nullptr)
+	   fclose (theFile);
+}
+//
+//	the samples are read at the rate of the file, not resampled
+int32_t	xmlIndexer::readSamples	(std::complex<float> *V, int32_t size) {
+	if (samplesLeft < size)
+	   size	= samplesLeft;
+	if (size <= 0)
+	   return 0;
+	xml_Reader::readBlock (fd, theFile, V, size);
+	samplesLeft	-= size;
+	return size;
 }
 	
 static 
@@ -210,7 +280,8 @@ float mapTable [] = {
 
 //
 //	the readers
-void	xml_Reader::readElements_IQ (FILE *theFile, 
+void	xml_Reader::readElements_IQ (xmlDescriptor *fd,
+	                            FILE *theFile, 
 	                             std::complex<float> *buffer,
 	                             int amount) {
 
@@ -354,7 +425,8 @@ float	scaler	= float (shift (nrBits));
 	}
 }
 
-void	xml_Reader::readElements_QI (FILE *theFile, 
+void	xml_Reader::readElements_QI (xmlDescriptor *fd,
+	                            FILE *theFile, 
 	                             std::complex<float> *buffer,
 	                             int amount) {
 
@@ -497,7 +569,8 @@ float	scaler	= float (shift (nrBits));
 	   return;
 	}
 }
-void	xml_Reader::readElements_I (FILE *theFile, 
+void	xml_Reader::readElements_I (xmlDescriptor *fd,
+	                            FILE *theFile, 
 	                            std::complex<float> *buffer,
 	                            int amount) {
 
@@ -615,7 +688,8 @@ float	scaler	= float (shift (nrBits));
 	   return;
 	}
 }
-void	xml_Reader::readElements_Q (FILE *theFile, 
+void	xml_Reader::readElements_Q (xmlDescriptor *fd,
+	                            FILE *theFile, 
 	                            std::complex<float> *buffer,
 	                            int amount) {
 
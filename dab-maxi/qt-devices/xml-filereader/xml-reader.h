@@ -28,6 +28,8 @@
 #include	<QMessageBox>
 #include	<stdio.h>
 #include	"ringbuffer.h"
+#include	"polyphase-resampler.h"
+#include	"frame-indexer.h"
 #include	<stdint.h>
 #include	<complex>
 #include	<vector>
@@ -43,12 +45,21 @@ public:
 	                            FILE		*f,
 	                            xmlDescriptor	*fd,
 	                            uint32_t		filePointer,
-	                            RingBuffer<std::complex<float>> *b);
+	                            RingBuffer<std::complex<float>> *b,
+	                            bool		batchMode = false);
 			~xml_Reader	();
 	void		stopReader	();
 	void		handle_continuousButton	();
+	void		seek		(int64_t);
+	int64_t		position	();
+static	void		readBlock	(xmlDescriptor *, FILE *,
+	                                 std::complex<float> *, int);
+static	int		bytesperSample	(xmlDescriptor *);
 private:
 	std::atomic<bool>	continuous;
+	bool		batchMode;
+	std::atomic<int64_t>	seekRequest;
+	std::atomic<int64_t>	filePosition;
 	FILE		*file;
 	xmlDescriptor	*fd;
 	uint32_t	filePointer;
@@ -59,27 +70,39 @@ private:
 	std::atomic<bool> running;
 	void		run ();
 	int		compute_nrSamples 	(FILE *f, int blockNumber);
-	int		readSamples		(FILE *f, 
-	                                       void(xml_Reader::*)(FILE *,
-	                                          std::complex<float> *, int));
-	void		readElements_IQ		(FILE *f,
+	int		readSamples		(FILE *f);
+static	void		readElements_IQ		(xmlDescriptor *, FILE *f,
 	                                         std::complex<float> *, int amount);
-	void		readElements_QI		(FILE *f, 
+static	void		readElements_QI		(xmlDescriptor *, FILE *f, 
 	                                         std::complex<float> *, int amount);
-	void		readElements_I		(FILE *f, 
+static	void		readElements_I		(xmlDescriptor *, FILE *f, 
 	                                         std::complex<float> *, int amount);
-	void		readElements_Q		(FILE *f, 
+static	void		readElements_Q		(xmlDescriptor *, FILE *f, 
 	                                         std::complex<float> *, int amount);
 //
 //	for the conversion - if any
-	int16_t         convBufferSize;
-        int16_t         convIndex;
-        std::vector <std::complex<float> >   convBuffer;
-        int16_t         mapTable_int   [2048];
-        float           mapTable_float [2048];
+	polyphaseResampler	theResampler;
+	int32_t		convBufferSize;
+	std::vector<std::complex<float>>	convBuffer;
+	std::vector<std::complex<float>>	outBuffer;
 
 signals:
 	void		setProgress		(int, int);
 };
+//
+//	the indexer reads the samples, at the rate of the file,
+//	with a file pointer of its own
+class	xmlIndexer: public frameIndexer {
+public:
+			xmlIndexer	(const QString &, xmlDescriptor *,
+	                                 uint32_t filePointer);
+			~xmlIndexer	();
+private:
+	int32_t		readSamples	(std::complex<float> *, int32_t);
+	xmlDescriptor	*fd;
+	FILE		*theFile;
+	int		sampleSize;
+	int64_t		samplesLeft;
+};
 
 #endif
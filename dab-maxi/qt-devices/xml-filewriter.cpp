@@ -49,6 +49,9 @@ uint8_t t	= 0;
 
 	for (int i = 0; i < 5000; i ++)
 	   fwrite (&t, 1, 1, f);
+//
+//	the samples are written by the writer thread
+	theWriter. open (f);
 	int16_t testWord	= 0xFF;
 
 	struct kort_woord *p	= (struct kort_woord *)(&testWord);
@@ -60,6 +63,7 @@ uint8_t t	= 0;
 }
 
 	xml_fileWriter::~xml_fileWriter	() {
+	theWriter. close ();
 }
 
 void	xml_fileWriter::computeHeader	() {
@@ -67,6 +71,7 @@ QString s;
 QString	topLine = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
 	if (xmlFile == nullptr)
 	   return;
+	theWriter. close ();
 	s = create_xmltree	();
 	fseek (xmlFile, 0, SEEK_SET);
 	fprintf (xmlFile, "%s", topLine. toLatin1 (). data ());
@@ -75,47 +80,26 @@ QString	topLine = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
 	fwrite (cs, 1, len, xmlFile);
 }
 
-#define	BLOCK_SIZE	8192
-static int16_t buffer_int16 [BLOCK_SIZE];
-static int bufferP_int16	= 0;
+//
+//	The samples are passed on as they are, std::complex<T>
+//	is laid out as an I/Q pair of T's. Only what the writer
+//	actually took is counted, so the header stays truthful
 void	xml_fileWriter::add	(std::complex<int16_t> * data, int count) {
-	nrElements	+= 2 * count;
-	for (int i = 0; i < count; i ++) {
-	   buffer_int16 [bufferP_int16 ++] = real (data [i]);
-	   buffer_int16 [bufferP_int16 ++] = imag (data [i]);
-	   if (bufferP_int16 >= BLOCK_SIZE) {
-	      fwrite (buffer_int16, sizeof (int16_t), BLOCK_SIZE, xmlFile);
-	      bufferP_int16 = 0;
-	   }
-	}
+	nrElements	+= theWriter. put (data,
+	                         count * sizeof (std::complex<int16_t>)) /
+	                                                 sizeof (int16_t);
 }
 
-static uint8_t buffer_uint8 [BLOCK_SIZE];
-static int bufferP_uint8	= 0;
 void	xml_fileWriter::add	(std::complex<uint8_t> * data, int count) {
-	nrElements	+= 2 * count;
-	for (int i = 0; i < count; i ++) {
-	   buffer_uint8 [bufferP_uint8 ++] = real (data [i]);
-	   buffer_uint8 [bufferP_uint8 ++] = imag (data [i]);
-	   if (bufferP_uint8 >= BLOCK_SIZE) {
-	      fwrite (buffer_uint8, sizeof (uint8_t), BLOCK_SIZE, xmlFile);
-	      bufferP_uint8 = 0;
-	   }
-	}
+	nrElements	+= theWriter. put (data,
+	                         count * sizeof (std::complex<uint8_t>)) /
+	                                                 sizeof (uint8_t);
 }
 
-static int8_t buffer_int8 [BLOCK_SIZE];
-static int bufferP_int8	= 0;
 void	xml_fileWriter::add	(std::complex<int8_t> * data, int count) {
-	nrElements	+= 2 * count;
-	for (int i = 0; i < count; i ++) {
-	   buffer_int8 [bufferP_int8 ++] = real (data [i]);
-	   buffer_int8 [bufferP_int8 ++] = imag (data [i]);
-	   if (bufferP_int8 >= BLOCK_SIZE) {
-	      fwrite (buffer_int8, sizeof (int8_t), BLOCK_SIZE, xmlFile);
-	      bufferP_int8 = 0;
-	   }
-	}
+	nrElements	+= theWriter. put (data,
+	                         count * sizeof (std::complex<int8_t>)) /
+	                                                 sizeof (int8_t);
 }
 
 QString	xml_fileWriter::create_xmltree () {
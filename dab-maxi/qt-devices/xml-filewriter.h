@@ -33,6 +33,7 @@
 #include	<stdint.h>
 #include	<stdio.h>
 #include	<complex>
+#include	"dump-writer.h"
 
 class Blocks	{
 public:
@@ -73,6 +74,7 @@ private:
 	FILE		*xmlFile;
 	QString		byteOrder;
 	int		nrElements;
+	dumpWriter	theWriter;
 };
 
 #endif
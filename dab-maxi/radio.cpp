@@ -44,6 +44,7 @@
 #include	"audio-descriptor.h"
 #include	"data-descriptor.h"
 #include	"rawfiles.h"
+#include	"iqzfiles.h"
 #include	"wavfiles.h"
 #include	"xml-filereader.h"
 #include	"color-selector.h"
@@ -211,6 +212,7 @@ void	RadioInterface::LOG	(const QString &a1, const QString &a2) {
 	                                bool		error_report,
 	                                int32_t		dataPort,
 	                                bool		marzano,
+	                                const QString	&batchFile,
 	                                QWidget		*parent):
 	                                        QWidget (parent),
 	                                        spectrumBuffer (2 * 32768),
@@ -244,6 +246,7 @@ uint8_t	dabBand;
 	dabSettings		= Si;
 	this	-> error_report	= error_report;
 	this	-> marzano	= marzano;
+	this	-> batchMode	= false;
 	running. 		store (false);
 	scanning. 		store (false);
 	my_dabProcessor		= nullptr;
@@ -257,6 +260,7 @@ uint8_t	dabBand;
 	globals. responseBuffer	= &responseBuffer;
 	globals. tiiBuffer	= &tiiBuffer;
 	globals. frameBuffer	= &frameBuffer;
+	globals. metrics	= &theMetrics;
 
 	latency			=
 	                  dabSettings -> value ("latency", 5). toInt();
@@ -365,21 +369,33 @@ uint8_t	dabBand;
 /*
  */
 #ifdef	DATA_STREAMER
-	dataStreamer		= new tcpServer (dataPort);
+	dataStreamer		= new tcpServer (dataPort,
+	                               dabSettings -> value ("slowClientPolicy",
+	                                         SLOW_CLIENT_SKIP). toInt ());
 #else
 	(void)dataPort;
 #endif
+#ifdef	IQ_SERVER
+	theIQServer		= new iqServer (dabSettings ->
+	                                   value ("iqServerPort", 1234). toInt ());
+	connect (theIQServer, SIGNAL (frequencyRequest (int)),
+	         this, SLOT (handle_iqFrequency (int)));
+#endif
 
 //	Where do we leave the audio out?
 	streamoutSelector	-> hide();
 #ifdef	TCP_STREAMER
-	soundOut		= new tcpStreamer	(20040);
+	soundOut		= new tcpStreamer	(20040,
+	                               dabSettings -> value ("slowClientPolicy",
+	                                         SLOW_CLIENT_SKIP). toInt ());
 #elif	QT_AUDIO
 	soundOut		= new Qt_Audio();
 #else
 //	just sound out
 	soundOut		= new audioSink		(latency);
 
+	((audioSink *)soundOut)	-> setTargetLevel (dabSettings ->
+	                            value ("audioTargetLevel", 100). toInt ());
 	((audioSink *)soundOut)	-> setupChannels (streamoutSelector);
 	streamoutSelector	-> show();
 	bool err;
@@ -451,11 +467,28 @@ uint8_t	dabBand;
 //
 	audioDumper		= nullptr;
 	rawDumper		= nullptr;
+	iqzDumper		= nullptr;
 	frameDumper		= nullptr;
 	ficBlocks		= 0;
 	ficSuccess		= 0;
 	total_ficError		= 0;
 	total_fics		= 0;
+	lastFicBlocks		= 0;
+	lastFicSuccess		= 0;
+	lastIqCount		= 0;
+	lastFramesOut		= 0;
+	lastCorrector		= 0;
+	lastClockError		= 0;
+	lastFrameErrors		= -1;
+	lastRsErrors		= -1;
+	lastAacErrors		= -1;
+	lastSyncLatency		= -1;
+	for (int i = 0; i < LATENCY_BUCKETS; i ++)
+	   decodeBase [i]	= 0;
+	droppedBase		= 0;
+	lastDecoded		= 0;
+	oversizeBase		= 0;
+	lastOversize		= 0;
 	syncedLabel		->
 	        setStyleSheet ("QLabel {background-color : red; color: white}");
 	techData. stereoLabel		->
@@ -520,6 +553,12 @@ uint8_t	dabBand;
 	displayTimer. start (1000);
 	numberofSeconds		= 0;
 //
+//	the statistics of the DSP threads are collected in theMetrics,
+//	they are sampled - and shown - 10 times a second
+	connect (&metricsTimer, SIGNAL (timeout (void)),
+	         this, SLOT (update_metrics (void)));
+	metricsTimer. start (100);
+//
 //	timer for scanning
 	channelTimer. setSingleShot (true);
 	channelTimer. setInterval (10000);
@@ -593,13 +632,22 @@ uint8_t	dabBand;
 	deviceSelector	-> addItem ("elad-s1");
 #endif
 	inputDevice	= nullptr;
-	h               =
+	if (batchFile != "") {
+	   inputDevice	= create_fileDevice (batchFile);
+	   if (inputDevice != nullptr) {
+	      inputDevice -> set_batchMode (true);
+	      batchMode	= true;
+	   }
+	}
+	else {
+	   h		=
 	           dabSettings -> value ("device", "no device"). toString();
-	k               = deviceSelector -> findText (h);
-//	fprintf (stderr, "%d %s\n", k, h. toUtf8(). data());
-	if (k != -1) {
-	   deviceSelector       -> setCurrentIndex (k);
-	   inputDevice	= setDevice (deviceSelector -> currentText());
+	   k		= deviceSelector -> findText (h);
+//	   fprintf (stderr, "%d %s\n", k, h. toUtf8(). data());
+	   if (k != -1) {
+	      deviceSelector       -> setCurrentIndex (k);
+	      inputDevice	= setDevice (deviceSelector -> currentText());
+	   }
 	}
 
 	if (inputDevice != nullptr) {
@@ -675,6 +723,9 @@ bool	RadioInterface::doStart	() {
 	   channelSelector -> setCurrentIndex (k);
 
 	my_dabProcessor	= new dabProcessor  (this, inputDevice, &globals);
+#ifdef	IQ_SERVER
+	my_dabProcessor	-> set_iqServer (theIQServer);
+#endif
 
 //	Some buttons should not be touched before we have a device
 	connectGUI ();
@@ -1164,6 +1215,7 @@ void	RadioInterface::TerminateProcess () {
 	delete		dataStreamer;
 #endif
 	displayTimer.	stop	();
+	metricsTimer.	stop	();
 	channelTimer.	stop	();
 	presetTimer.	stop	();
 #ifdef	TRY_EPG
@@ -1201,6 +1253,9 @@ void	RadioInterface::TerminateProcess () {
 	   delete	my_dabProcessor;
 	if (inputDevice != nullptr)
 	   delete	inputDevice;
+#ifdef	IQ_SERVER
+	delete		theIQServer;
+#endif
 
 	delete		soundOut;
 	if (motSlides != nullptr)
@@ -1245,6 +1300,21 @@ void	RadioInterface::updateTimeDisplay() {
 //	that it rings when there is no processor running
 	if (my_dabProcessor == nullptr)
 	   return;
+//
+//	a batch run ends when the device has delivered the whole file
+	if (batchMode && inputDevice -> endofInput ()) {
+	   int	totalFrames;
+	   int	goodFrames;
+	   int	badFrames;
+	   my_dabProcessor	-> getFrameQuality (&totalFrames,
+	                                            &goodFrames,
+	                                            &badFrames);
+	   fprintf (stderr, "batch: total %d, good %d bad %d\n",
+	                     totalFrames, goodFrames, badFrames);
+	   TerminateProcess ();
+	   qApp -> quit ();
+	   return;
+	}
 
 	if (error_report && (numberofSeconds % 10) == 0) {
 	   int	totalFrames;
@@ -1261,8 +1331,12 @@ void	RadioInterface::updateTimeDisplay() {
 #ifndef TCP_STREAMER 
 #ifndef	QT_AUDIO
 	   if (streamoutSelector -> isVisible ()) {
+	      int underruns, overruns, fillLevel, ppm;
 	      int xxx = ((audioSink *)soundOut)	-> missed();
-	      fprintf (stderr, "missed %d\n", xxx);
+	      ((audioSink *)soundOut) -> telemetry (&underruns, &overruns,
+	                                            &fillLevel, &ppm);
+	      fprintf (stderr, "missed %d (underruns %d, overruns %d), fill %d msec, drift %d ppm\n",
+	                        xxx, underruns, overruns, fillLevel, ppm);
 	   }
 #endif
 #endif
@@ -1510,6 +1584,26 @@ deviceHandler	*inputDevice	= nullptr;
 	      return nullptr;
 	   }
 	}
+	else
+	if (s == "file input (.iqz)") {
+	   file		= QFileDialog::getOpenFileName (this,
+	                                                tr ("Open file ..."),
+	                                                QDir::homePath(),
+	                                                tr ("compressed iq (*.iqz)"));
+	   if (file == QString (""))
+	      return nullptr;
+
+	   file		= QDir::toNativeSeparators (file);
+	   try {
+	      inputDevice	= new iqzFiles (file);
+	      hideButtons();	
+	   }
+	   catch (int e) {
+	      QMessageBox::warning (this, tr ("Warning"),
+	                               tr ("file cannot be read"));
+	      return nullptr;
+	   }
+	}
 	else {
 	   fprintf (stderr, "unknown device, failing\n");
 	   return nullptr;
@@ -1530,6 +1624,35 @@ deviceHandler	*inputDevice	= nullptr;
 //
 //	newDevice is called from the GUI when selecting a device
 //	with the selector
+//
+//	For a batch run, the file device is selected by the extension
+//	of the file, no dialog needed
+deviceHandler	*RadioInterface::create_fileDevice (const QString &f) {
+QString	file	= QDir::toNativeSeparators (f);
+deviceHandler	*res	= nullptr;
+
+	try {
+	   if (file. endsWith (".iqz", Qt::CaseInsensitive))
+	      res	= new iqzFiles (file);
+	   else
+	   if (file. endsWith (".sdr", Qt::CaseInsensitive))
+	      res	= new wavFiles (file);
+	   else
+	   if (file. endsWith (".raw", Qt::CaseInsensitive) ||
+	       file. endsWith (".iq", Qt::CaseInsensitive))
+	      res	= new rawFiles (file);
+	   else
+	      res	= new xml_fileReader (file);
+	}
+	catch (int e) {
+	   fprintf (stderr, "cannot process %s\n", file. toUtf8 (). data ());
+	   return nullptr;
+	}
+	hideButtons ();
+	my_spectrumViewer. setBitDepth (res -> bitDepth ());
+	return res;
+}
+
 void	RadioInterface::newDevice (const QString &deviceName) {
 //	Part I : stopping all activities
 	running. store (false);
@@ -1648,20 +1771,24 @@ void	RadioInterface::show_ficSuccess (bool b) {
 	   ficSuccess ++;
 
 	if (++ficBlocks >= 100) {
-	   QPalette p      = ficError_display -> palette();
-	   if (ficSuccess < 85)
-              p. setColor (QPalette::Highlight, Qt::red);
-	   else
-	      p. setColor (QPalette::Highlight, Qt::green);
-
-	   ficError_display	-> setPalette (p);
-	   ficError_display	-> setValue (ficSuccess);
+	   show_ficRatio (ficSuccess);
 	   total_ficError	+= 100 - ficSuccess;
 	   total_fics		+= 100;
 	   ficSuccess		= 0;
 	   ficBlocks		= 0;
 	}
 }
+
+void	RadioInterface::show_ficRatio	(int ratio) {
+	QPalette p      = ficError_display -> palette();
+	if (ratio < 85)
+	   p. setColor (QPalette::Highlight, Qt::red);
+	else
+	   p. setColor (QPalette::Highlight, Qt::green);
+
+	ficError_display	-> setPalette (p);
+	ficError_display	-> setValue (ratio);
+}
 //
 //	called from the PAD handler
 void	RadioInterface::show_motHandling (bool b) {
@@ -1729,7 +1856,11 @@ QString	tiiNumber (int n) {
 	return QString ("0") + QString::number (n);
 }
 
-void	RadioInterface::show_tii	(int mainId, int subId) {
+//
+//	the transmitters found in a null period are reported strongest
+//	first, the strength of the others is relative to the strongest one
+void	RadioInterface::show_tii	(int mainId, int subId,
+	                                 float strength) {
 QString a = "Est: ";
 bool	found	= false;
 	if (mainId == 0xFF) 
@@ -1749,7 +1880,12 @@ bool	found	= false;
         if (!running. load())
            return;
 
-	a = a + " " +  tiiNumber (mainId) + " " + tiiNumber (subId);
+	if (strength >= 0)
+	   a = a + " " +  tiiNumber (mainId) + " " + tiiNumber (subId);
+	else
+	   a = transmitter_coordinates -> text () + "  " +
+	                tiiNumber (mainId) + " " + tiiNumber (subId) +
+	                " (" + QString::number ((int)strength) + " dB)";
 
 	transmitter_coordinates	-> setAlignment (Qt::AlignRight);
 	transmitter_coordinates	-> setText (a);
@@ -1900,12 +2036,15 @@ void	setButtonFont (QPushButton *b, QString text, int size) {
 }
 
 void	RadioInterface::stop_sourceDumping	() {
-	if (rawDumper == nullptr) 
+	if ((rawDumper == nullptr) && (iqzDumper == nullptr))
 	   return;
 
 	my_dabProcessor	-> stopDumping();
-	sf_close (rawDumper);
+	if (rawDumper != nullptr)
+	   sf_close (rawDumper);
+	delete iqzDumper;	// writes the index
 	rawDumper	= nullptr;
+	iqzDumper	= nullptr;
 	setButtonFont (dumpButton, "Raw dump", 10);
 }
 //
@@ -1916,8 +2055,32 @@ QString channelName	= channelSelector -> currentText ();
 	if (scanning. load ())
 	   return;
 
-	rawDumper	=
+	QString fileName	=
 	         filenameFinder. findRawDump_fileName (deviceName, channelName);
+	if (fileName == "")
+	   return;
+
+	if (fileName. endsWith (".iqz", Qt::CaseInsensitive)) {
+	   QString metaData	= "deviceName=" + deviceName + "\n" +
+	                          "channel=" + channelName + "\n" +
+	                          "recorderName=Qt-DAB\n" +
+	                          "recorderVersion=" + version + "\n" +
+	                          "recordingTime=" +
+	              QDateTime::currentDateTime (). toString (Qt::ISODate) + "\n";
+	   try {
+	      iqzDumper	= new iqzWriter (fileName, INPUT_RATE,
+	                                 theBand. Frequency (channelName),
+	                                 inputDevice -> bitDepth (),
+	                                 metaData);
+	   } catch (int e) {
+	      return;
+	   }
+	   setButtonFont (dumpButton, "writing", 12);
+	   my_dabProcessor -> startDumping (iqzDumper);
+	   return;
+	}
+
+	rawDumper	= filenameFinder. open_rawDump (fileName);
 	if (rawDumper == nullptr)
 	   return;
 
@@ -1929,7 +2092,7 @@ void	RadioInterface::handle_sourcedumpButton () {
 	if (!running. load () || scanning. load ())
 	   return;
 
-	if (rawDumper != nullptr)
+	if ((rawDumper != nullptr) || (iqzDumper != nullptr))
 	   stop_sourceDumping ();
 	else
 	   start_sourceDumping ();
@@ -2007,6 +2170,118 @@ uint8_t buffer [amount];
 	      fwrite (buffer, amount, 1, frameDumper);
 	}
 }
+//
+//	The DSP threads do not signal their statistics, they store
+//	them in theMetrics, here we sample and show them.
+//	Values are only shown when they changed
+void	RadioInterface::update_metrics	() {
+metricsEvent	e;
+int32_t	v;
+uint32_t n;
+
+	if (!running. load ())
+	   return;
+
+	v	= theMetrics. corrector. load ();
+	if (v != lastCorrector) {
+	   set_CorrectorDisplay (v);
+	   lastCorrector	= v;
+	}
+
+	while (theMetrics. getEvent (&e))
+	   if (e. kind == SNR_EVENT)
+	      show_snr (e. value, e. v1, e. v2);
+
+	v	= theMetrics. clockError. load ();
+	if (v != lastClockError) {
+	   show_clockError (v);
+	   lastClockError	= v;
+	}
+
+	n	= theMetrics. iqCount. load ();
+	if (n != lastIqCount) {
+	   showIQ	(theMetrics. iqAmount. load ());
+	   showQuality	(theMetrics. quality. load ());
+	   lastIqCount	= n;
+	}
+//
+//	the fic success rate is shown per (at least) 100 fic blocks,
+//	ficSuccess is counted after ficBlocks, so it may run ahead
+	uint32_t blocks	= theMetrics. ficBlocks. load () - lastFicBlocks;
+	if (blocks >= 100) {
+	   uint32_t success = theMetrics. ficSuccess. load () - lastFicSuccess;
+	   if (success > blocks)
+	      success = blocks;
+	   show_ficRatio (success * 100 / blocks);
+	   total_ficError	+= blocks - success;
+	   total_fics		+= blocks;
+	   lastFicBlocks	+= blocks;
+	   lastFicSuccess	+= success;
+	}
+
+	v	= theMetrics. frameErrors. load ();
+	if ((v >= 0) && (v != lastFrameErrors)) {
+	   show_frameErrors (v);
+	   lastFrameErrors	= v;
+	}
+	v	= theMetrics. rsErrors. load ();
+	if ((v >= 0) && (v != lastRsErrors)) {
+	   show_rsErrors (v);
+	   lastRsErrors	= v;
+	}
+	v	= theMetrics. aacErrors. load ();
+	if ((v >= 0) && (v != lastAacErrors)) {
+	   show_aacErrors (v);
+	   lastAacErrors	= v;
+	}
+	v	= theMetrics. syncLatency. load ();
+	if ((v >= 0) && (v != lastSyncLatency)) {
+	   techData. frameError_display -> setToolTip (
+	          QString ("Frame errors. Indication of the quality of the DAB+ frame detection. 100 is good.\nSuperframe sync after %1 msec").arg (v));
+	   lastSyncLatency	= v;
+	}
+	v	= theMetrics. stereo. load ();
+	if (v >= 0)
+	   setStereo (v != 0);
+	show_decodeLatency ();
+
+	n	= theMetrics. framesOut. load ();
+	if (n != lastFramesOut) {
+	   int amount	= frameBuffer. GetRingBufferReadAvailable ();
+	   if (amount > 0)
+	      newFrame (amount);
+	   lastFramesOut	= n;
+	}
+}
+
+//
+//	the decoding latency histogram and the AUs too large to be
+//	decoded, counted from the selection of the service, are shown
+//	as tooltip of the aac error display.
+//	It is refreshed after (about) a second of frames
+void	RadioInterface::show_decodeLatency	() {
+uint32_t h [LATENCY_BUCKETS];
+uint32_t decoded	= 0;
+
+	for (int i = 0; i < LATENCY_BUCKETS; i ++) {
+	   h [i]	= theMetrics. decodeLatency [i]. load () - decodeBase [i];
+	   decoded	+= h [i];
+	}
+	uint32_t dropped = theMetrics. decodeDropped. load () - droppedBase;
+	uint32_t oversize = theMetrics. oversizeAUs. load () - oversizeBase;
+	if ((decoded - lastDecoded < 40) && (oversize == lastOversize))
+	   return;
+	lastDecoded	= decoded;
+	lastOversize	= oversize;
+	QString text	= "Decoding latency (msec):";
+	for (int i = 0; i < LATENCY_BUCKETS - 1; i ++)
+	   text	+= QString (" <%1: %2"). arg (latencyLimits [i]). arg (h [i]);
+	text	+= QString (" >=%1: %2\nframes dropped: %3, AUs too large: %4").
+	               arg (latencyLimits [LATENCY_BUCKETS - 2]).
+	               arg (h [LATENCY_BUCKETS - 1]). arg (dropped).
+	               arg (oversize);
+	techData. aacError_display -> setToolTip (text);
+}
 
 void	RadioInterface::handle_tiiButton	() {
 	if (!running. load ())
@@ -2572,6 +2847,21 @@ void	RadioInterface::cleanScreen	() {
 	techData. frameError_display	-> setValue (0);
 	techData. rsError_display	-> setValue (0);
 	techData. aacError_display	-> setValue (0);
+	theMetrics. frameErrors. store (-1);
+	theMetrics. rsErrors. store (-1);
+	theMetrics. aacErrors. store (-1);
+	theMetrics. syncLatency. store (-1);
+	lastFrameErrors			= -1;
+	lastRsErrors			= -1;
+	lastAacErrors			= -1;
+	lastSyncLatency			= -1;
+	for (int i = 0; i < LATENCY_BUCKETS; i ++)
+	   decodeBase [i]	= theMetrics. decodeLatency [i]. load ();
+	droppedBase			= theMetrics. decodeDropped. load ();
+	lastDecoded			= 0;
+	oversizeBase			= theMetrics. oversizeAUs. load ();
+	lastOversize			= 0;
+	techData. aacError_display	-> setToolTip ("");
 	techData. programName		-> setText (QString (""));
 	techData. bitrateDisplay	-> display (0);
 	techData. startAddressDisplay	-> display (0);
@@ -2929,6 +3219,26 @@ void	RadioInterface::set_channelButton (int currentChannel) {
 	startChannel (channelSelector -> currentText ());
 }
 
+#ifdef	IQ_SERVER
+//
+//	The client of the iqServer that is in control asks for
+//	a frequency, we only switch to channels in the band
+void	RadioInterface::handle_iqFrequency (int frequency) {
+	if (!running. load () || scanning. load ())
+	   return;
+	for (int i = 0; i < channelSelector -> count (); i ++) {
+	   if (theBand. Frequency (channelSelector -> itemText (i)) ==
+	                                                     frequency) {
+	      if (i != channelSelector -> currentIndex ())
+	         set_channelButton (i);
+	      return;
+	   }
+	}
+	fprintf (stderr, "iqServer: %d is not a channel frequency\n",
+	                                                     frequency);
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////
 //
 //	scanning
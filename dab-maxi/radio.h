@@ -46,6 +46,9 @@
 #ifdef	DATA_STREAMER
 #include	"tcp-server.h"
 #endif
+#ifdef	IQ_SERVER
+#include	"iq-server.h"
+#endif
 #include	"preset-handler.h"
 #include	"scanner-table.h"
 #ifdef	TRY_EPG
@@ -59,6 +62,7 @@
 #include	"snr-viewer.h"
 
 #include	"findfilenames.h"
+#include	"iqz-format.h"
 class	QSettings;
 class	deviceHandler;
 class	audioBase;
@@ -93,6 +97,7 @@ public:
 	                                 bool,
 	                                 int32_t	 dataPort,
 	                                 bool,
+	                                 const QString	&batchFile,
 	                                 QWidget	*parent = nullptr);
 		~RadioInterface		();
 
@@ -115,8 +120,10 @@ private:
 	scannerTable		theTable;
 	findfileNames		filenameFinder;
 	processParams		globals;
+	dabMetrics		theMetrics;
 	QString			version;
 	bool			marzano;
+	bool			batchMode;
 #ifdef	__LOGGING__
 	FILE			*logFile;
 #endif
@@ -149,6 +156,9 @@ private:
 #ifdef	DATA_STREAMER
 	tcpServer		*dataStreamer;
 #endif
+#ifdef	IQ_SERVER
+	iqServer		*theIQServer;
+#endif
 #ifdef	TRY_EPG
 	CEPGDecoder		epgHandler;
 	epgDecoder		epgProcessor;
@@ -167,6 +177,7 @@ private:
 	int32_t			port;
 #endif
 	SNDFILE                 *rawDumper;
+	iqzWriter		*iqzDumper;
         FILE                    *frameDumper;
         SNDFILE                 *audioDumper;
 	FILE			*scanDumpFile;
@@ -182,6 +193,7 @@ private:
 
 	QStringList		soundChannels;
 	QTimer			displayTimer;
+	QTimer			metricsTimer;
 	QTimer			channelTimer;
 	QTimer			presetTimer;
 	QTimer			startTimer;
@@ -194,6 +206,23 @@ private:
 	int16_t			ficSuccess;
 	int			total_ficError;
 	int			total_fics;
+	uint32_t		lastFicBlocks;
+	uint32_t		lastFicSuccess;
+	uint32_t		lastIqCount;
+	uint32_t		lastFramesOut;
+	int32_t			lastCorrector;
+	int32_t			lastClockError;
+	int32_t			lastFrameErrors;
+	int32_t			lastRsErrors;
+	int32_t			lastAacErrors;
+	int32_t			lastSyncLatency;
+	uint32_t		decodeBase	[LATENCY_BUCKETS];
+	uint32_t		droppedBase;
+	uint32_t		lastDecoded;
+	uint32_t		oversizeBase;
+	uint32_t		lastOversize;
+	void			show_decodeLatency	();
+	void			show_ficRatio		(int);
 	void			connectGUI		();
 	void			disconnectGUI		();
 
@@ -206,6 +235,7 @@ private:
 	void			hideButtons		();
 	void			showButtons		();
 	deviceHandler		*setDevice		(const QString &);
+	deviceHandler		*create_fileDevice	(const QString &);
 	historyHandler		*my_history;
 	historyHandler		*my_presets;
 	timeTableHandler	*my_timeTable;
@@ -277,7 +307,7 @@ public slots:
 	void			showIQ			(int);
 	void			showQuality		(float);
 	void			show_rsCorrections	(int);
-	void			show_tii		(int, int);
+	void			show_tii		(int, int, float);
 	void			closeEvent		(QCloseEvent *event);
 	void			clockTime		(int, int, int, int, int);
 	void			startAnnouncement	(const QString &, int);
@@ -289,6 +319,9 @@ public slots:
 	void			set_epgData		(int,
 	                                                 int, const QString &);
 	void			epgTimer_timeOut	();
+#endif
+#ifdef	IQ_SERVER
+	void			handle_iqFrequency	(int);
 #endif
 	void			switchVisibility	(QWidget *);
 //	Somehow, these must be connected to the GUI
@@ -323,6 +356,7 @@ private slots:
 	void			handle_historySelect	(const QString &);
 	void			TerminateProcess	();
 	void			updateTimeDisplay	();
+	void			update_metrics		();
 	void			channel_timeOut		();
 
 	void			selectService		(QModelIndex);
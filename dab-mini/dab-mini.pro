@@ -70,12 +70,14 @@ HEADERS += ./radio.h \
 	   ../includes/dab-constants.h \
 	   ../includes/country-codes.h \
 	   ../includes/ofdm/timesyncer.h \
+	   ../includes/ofdm/signal-detector.h \
 	   ../includes/ofdm/sample-reader.h \
 	   ../includes/ofdm/ofdm-decoder.h \
 	   ../includes/ofdm/phasereference.h \
 	   ../includes/ofdm/phasetable.h \
 	   ../includes/ofdm/freq-interleaver.h \
 	   ../includes/ofdm/tii_detector.h \
+	   ../includes/ofdm/tii-processor.h \
 	   ../includes/ofdm/fic-handler.h \
 	   ../includes/ofdm/fib-decoder.h  \
 	   ../includes/ofdm/fib-table.h \
@@ -95,7 +97,10 @@ HEADERS += ./radio.h \
 	   ../includes/backend/backend-driver.h \
 	   ../includes/backend/backend-deconvolver.h \
 	   ../includes/backend/audio/mp2processor.h \
+	   ../includes/backend/audio/mp2-decoder.h \
 	   ../includes/backend/audio/mp4processor.h \
+	   ../includes/backend/audio/au-pool.h \
+	   ../includes/backend/audio/decoder-pool.h \
 	   ../includes/backend/audio/bitWriter.h \
 	   ../includes/backend/data/data-processor.h \
 	   ../includes/backend/data/pad-handler.h \
@@ -117,11 +122,17 @@ HEADERS += ./radio.h \
 #	   ../includes/output/fir-filters.h \
 	   ../includes/output/audio-base.h \
 	   ../includes/output/newconverter.h \
+	   ../includes/output/audio-ring.h \
+	   ../includes/output/audio-router.h \
+	   ../includes/output/audio-dump-writer.h \
 	   ../includes/output/audiosink.h \
 	   ../includes/support/process-params.h \
+	   ../includes/support/dab-metrics.h \
 	   ../includes/support/viterbi-jan/viterbi-handler.h \
 	   ../includes/support/viterbi-spiral/viterbi-spiral.h \
            ../includes/support/fft-handler.h \
+           ../includes/support/dump-writer.h \
+           ../includes/support/iqz-format.h \
 	   ../includes/support/ringbuffer.h \
 #	   ../includes/support/Xtan2.h \
 	   ../includes/support/dab-params.h \
@@ -144,6 +155,7 @@ SOURCES += ./main.cpp \
 	   ./radio.cpp \
 	   ../dab-processor.cpp \
 	   ../src/ofdm/timesyncer.cpp \
+	   ../src/ofdm/signal-detector.cpp \
 	   ../src/ofdm/sample-reader.cpp \
 	   ../src/ofdm/ofdm-decoder.cpp \
 	   ../src/ofdm/phasereference.cpp \
@@ -151,6 +163,7 @@ SOURCES += ./main.cpp \
 	   ../src/ofdm/freq-interleaver.cpp \
 #	   ../src/ofdm/tii_table.cpp \
 	   ../src/ofdm/tii_detector.cpp \
+	   ../src/ofdm/tii-processor.cpp \
 	   ../src/ofdm/fic-handler.cpp \
 	   ../src/ofdm/fib-decoder.cpp  \
 	   ../src/protection/protTables.cpp \
@@ -168,7 +181,10 @@ SOURCES += ./main.cpp \
            ../src/backend/backend-driver.cpp \
            ../src/backend/backend-deconvolver.cpp \
 	   ../src/backend/audio/mp2processor.cpp \
+	   ../src/backend/audio/mp2-decoder.cpp \
 	   ../src/backend/audio/mp4processor.cpp \
+	   ../src/backend/audio/au-pool.cpp \
+	   ../src/backend/audio/decoder-pool.cpp \
 	   ../src/backend/audio/bitWriter.cpp \
 	   ../src/backend/data/pad-handler.cpp \
 	   ../src/backend/data/data-processor.cpp \
@@ -188,10 +204,14 @@ SOURCES += ./main.cpp \
 	   ../src/backend/data/journaline/NML.cpp \
 	   ../src/output/audio-base.cpp \
 	   ../src/output/newconverter.cpp \
+	   ../src/output/audio-dump-writer.cpp \
+	   ../src/output/audio-router.cpp \
 	   ../src/output/audiosink.cpp \
 	   ../src/support/viterbi-jan/viterbi-handler.cpp \
 	   ../src/support/viterbi-spiral/viterbi-spiral.cpp \
            ../src/support/fft-handler.cpp \
+           ../src/support/dump-writer.cpp \
+           ../src/support/iqz-format.cpp \
 #	   ../src/support/Xtan2.cpp \
 	   ../src/support/dab-params.cpp \
 	   ../src/support/band-handler.cpp \
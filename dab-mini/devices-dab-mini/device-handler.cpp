@@ -50,6 +50,13 @@ int32_t	deviceHandler::Samples		(void) {
 	return 1024;
 }
 
+//
+//	amount samples in the format given by sampleFormat,
+//	for the default format that is what getSamples delivers
+int32_t	deviceHandler::getRawSamples	(void *v, int32_t amount) {
+	return getSamples ((std::complex<float> *)v, amount);
+}
+
 void	deviceHandler::resetBuffer	(void) {
 }
 
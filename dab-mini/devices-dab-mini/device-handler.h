@@ -31,6 +31,17 @@
 #include	"dab-constants.h"
 #include	<QThread>
 
+//
+//	The formats in which a device may deliver its samples through
+//	getRawSamples. Devices that deliver anything other than
+//	std::complex<float> can keep the samples in their native
+//	format in their buffers, the conversion is left to the
+//	consumer, i.e. the sampleReader.
+#define	SAMPLES_CF32	0	// std::complex<float>, the default
+#define	SAMPLES_U8	1	// unsigned 8 bit I/Q pairs, 128 is zero
+#define	SAMPLES_S8	2	// signed 8 bit I/Q pairs
+#define	SAMPLES_S16	3	// signed 16 bit I/Q pairs, bitDepth bits used
+
 class	deviceHandler: public QThread {
 public:
 			deviceHandler 	(void);
@@ -39,6 +50,8 @@ virtual		bool	restartReader	(int32_t);
 virtual		void	stopReader	(void);
 virtual		int32_t	getSamples	(std::complex<float> *, int32_t);
 virtual		int32_t	Samples		(void);
+virtual		int16_t	sampleFormat	(void) { return SAMPLES_CF32;}
+virtual		int32_t	getRawSamples	(void *, int32_t);
 virtual		void	resetBuffer	(void);
 virtual		int16_t	bitDepth	(void) { return 10;}
 //
@@ -172,21 +172,15 @@ int	res;
 	}
 }
 
-static std::complex<float>buffer [32 * 32768];
+//
+//	the samples are stored as they come, I/Q pairs of int8_t
 static
 int	callback (hackrf_transfer *transfer) {
 hackrfHandler *ctx = static_cast <hackrfHandler *>(transfer -> rx_ctx);
-int	i;
-//std::complex<float> buffer [transfer -> buffer_length / 2];
-uint8_t *p	= transfer -> buffer;
-RingBuffer<std::complex<float> > * q = &(ctx -> _I_Buffer);
-
-	for (i = 0; i < transfer -> valid_length / 2; i ++) {
-	   float re	= (int8_t)(p [2 * i]) / 128.0;
-	   float im	= (int8_t)(p [2 * i + 1]) / 128.0;
-	   buffer [i]	= std::complex<float> (re, im);
-	}
-	q	-> putDataIntoBuffer (buffer, transfer -> valid_length / 2);
+RingBuffer<std::complex<int8_t> > * q = &(ctx -> _I_Buffer);
+
+	q	-> putDataIntoBuffer ((std::complex<int8_t> *)(transfer -> buffer),
+	                              transfer -> valid_length / 2);
 	return 0;
 }
 
@@ -231,7 +225,22 @@ int	res;
 //	The brave old getSamples. For the hackrf, we get
 //	size still in I/Q pairs
 int32_t	hackrfHandler::getSamples (std::complex<float> *V, int32_t size) { 
-	return _I_Buffer. getDataFromBuffer (V, size);
+std::complex<int8_t> temp [size];
+int	amount	= _I_Buffer. getDataFromBuffer (temp, size);
+
+	for (int i = 0; i < amount; i ++)
+	   V [i] = std::complex<float> (real (temp [i]) / 128.0,
+	                                imag (temp [i]) / 128.0);
+	return amount;
+}
+//
+//	the conversion to float is left to the sampleReader
+int32_t	hackrfHandler::getRawSamples (void *V, int32_t size) {
+	return _I_Buffer. getDataFromBuffer ((std::complex<int8_t> *)V, size);
+}
+
+int16_t	hackrfHandler::sampleFormat	(void) {
+	return SAMPLES_S8;
 }
 
 int32_t	hackrfHandler::Samples	(void) {
@@ -76,12 +76,14 @@ public:
 	void		stopReader		(void);
 	int32_t		getSamples		(std::complex<float> *,
 	                                                          int32_t);
+	int32_t		getRawSamples		(void *, int32_t);
+	int16_t		sampleFormat		(void);
 	int32_t		Samples			(void);
 	void		resetBuffer		(void);
 	int16_t		bitDepth		(void);
 //
 //	The buffer should be visible by the callback function
-	RingBuffer<std::complex<float>>	_I_Buffer;
+	RingBuffer<std::complex<int8_t>>	_I_Buffer;
 	hackrf_device	*theDevice;
 private:
 	bool                    load_hackrfFunctions    (void);
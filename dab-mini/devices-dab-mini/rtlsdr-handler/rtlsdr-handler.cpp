@@ -326,6 +326,17 @@ uint8_t	*tempBuffer = (uint8_t *)alloca (2 * size * sizeof (uint8_t));
 	return amount / 2;
 }
 
+//
+//	The sampleReader may take the samples as they come from
+//	the stick and do the conversion itself
+int32_t	rtlsdrHandler::getRawSamples (void *V, int32_t size) {
+	return _I_Buffer. getDataFromBuffer ((uint8_t *)V, 2 * size) / 2;
+}
+
+int16_t	rtlsdrHandler::sampleFormat	(void) {
+	return SAMPLES_U8;
+}
+
 int32_t	rtlsdrHandler::Samples	(void) {
 	return _I_Buffer. GetRingBufferReadAvailable () / 2;
 }
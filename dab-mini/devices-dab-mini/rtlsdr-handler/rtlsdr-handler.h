@@ -75,6 +75,8 @@ public:
 	bool		restartReader	(int32_t frequency);
 	void		stopReader	(void);
 	int32_t		getSamples	(std::complex<float> *, int32_t);
+	int32_t		getRawSamples	(void *, int32_t);
+	int16_t		sampleFormat	(void);
 	int32_t		Samples		(void);
 	void		resetBuffer	(void);
 	int16_t		bitDepth	(void);
@@ -667,8 +667,8 @@ void	RadioInterface::setStereo	(bool s) {
 
 }
 
-void	RadioInterface::show_tii	(int s1, int s2) {
-	(void)s1; (void)s2;
+void	RadioInterface::show_tii	(int s1, int s2, float f1) {
+	(void)s1; (void)s2; (void)f1;
 }
 
 void	RadioInterface::show_snr	(int s1, float f1, float f2) {
@@ -168,7 +168,7 @@ public slots:
 	void			showIQ			(int);
 	void			showQuality		(float);
 	void			show_rsCorrections	(int);
-	void			show_tii		(int, int);
+	void			show_tii		(int, int, float);
 	void			show_snr		(int, float, float);
 	void			closeEvent		(QCloseEvent *event);
 	void			clockTime		(int, int, int,
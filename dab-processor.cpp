@@ -44,23 +44,28 @@
 	                                 params (p -> dabMode),
 	                                 myReader (mr,
 	                                           inputDevice,
-	                                           p -> spectrumBuffer),
-	                                 my_ficHandler (mr, p -> dabMode),
+	                                           p -> spectrumBuffer,
+	                                           p -> metrics),
+	                                 my_ficHandler (mr, p -> dabMode,
+	                                                p -> metrics),
 	                                 my_mscHandler (mr, p -> dabMode,
-	                                                p -> frameBuffer),
+	                                                p -> frameBuffer,
+	                                                p -> metrics),
 	                                 phaseSynchronizer (mr, p),
-	                                 my_TII_Detector (p -> dabMode,
-	                                                  p -> tii_depth), 
+	                                 my_tiiProcessor (mr, p),
+	                                 my_signalDetector (&myReader,
+	                                                    p -> dabMode),
 	                                 my_ofdmDecoder (mr, 
 	                                                 p -> dabMode,
 	                                                 inputDevice -> bitDepth(),
-	                                                 p -> iqBuffer) {
+	                                                 p -> iqBuffer,
+	                                                 p -> metrics) {
 
 	this	-> myRadioInterface	= mr;
 	this	-> inputDevice		= inputDevice;
 	this	-> frequency		= 220000000;	// default
 	this	-> threshold		= p -> threshold;
-	this	-> tiiBuffer		= p -> tiiBuffer;
+	this	-> metrics		= p -> metrics;
 	this	-> T_null		= params. get_T_null();
 	this	-> T_s			= params. get_T_s();
 	this	-> T_u			= params. get_T_u();
@@ -70,14 +75,13 @@
 	this	-> carriers		= params. get_carriers();
 	this	-> carrierDiff		= params. get_carrierDiff();
 
-	this	-> tii_delay		= p -> tii_delay;
-	this	-> tii_counter		= 0;
-
 	ofdmBuffer. resize (2 * T_s);
 	fineOffset			= 0;	
 	coarseOffset			= 0;	
 	correctionNeeded		= true;
 	attempts			= 0;
+	snr				= 0;
+	snrCount			= 0;
 
 	goodFrames			= 0;
 	badFrames			= 0;
@@ -89,13 +93,10 @@
 	         myRadioInterface, SLOT (setSyncLost (void)));
 	connect (this, SIGNAL (show_Spectrum (int)),
 	         myRadioInterface, SLOT (showSpectrum (int)));
-	connect (this, SIGNAL (show_tii (int, int)),
-	         myRadioInterface, SLOT (show_tii (int, int)));
 	connect (this, SIGNAL (show_snr (int, float, float)),
 	         mr, SLOT (show_snr (int, float, float)));
 	connect (this, SIGNAL (show_clockErr (int)),
 	         mr, SLOT (show_clockError (int)));
-	my_TII_Detector. reset();
 }
 
 	dabProcessor::~dabProcessor() {
@@ -159,6 +160,16 @@ int	cCount		= 0;
 	   for (i = 0; i < T_F / 5; i ++) {
 	      myReader. getSample (0);
 	   }
+//
+//	While scanning, we first look - within a single frame - whether
+//	there is anything resembling a DAB signal, if not there is no
+//	need to wait for 8 failing attempts of the timeSyncer.
+//	The receivers of the signal stop the processor, so there is
+//	no point in trying to synchronize
+	   if (scanMode && !my_signalDetector. signalPresent ()) {
+	      emit (No_Signal_Found ());
+	      return;
+	   }
 //Initing:
 notSynced:
 	   totalFrames ++;
@@ -167,7 +178,7 @@ notSynced:
 	   sampleCount	= 0;
 
 	   setSynced (false);
-	   my_TII_Detector. reset ();
+	   my_tiiProcessor. reset ();
 	   switch (myTimeSyncer. sync (T_null, T_F)) {
 	      case TIMESYNC_ESTABLISHED:
 	         break;			// yes, we are ready
@@ -206,7 +217,11 @@ Check_endofNULL:
 	   frameCount ++;
 	   totalSamples	+= sampleCount;
 	   if (frameCount > 10) {
-	      show_clockErr (totalSamples - frameCount * 196608);
+	      if (metrics != nullptr)
+	         metrics -> clockError. store (totalSamples -
+	                                          frameCount * 196608);
+	      else
+	         show_clockErr (totalSamples - frameCount * 196608);
 	      totalSamples = 0;
 	      frameCount = 0;
 	   }
@@ -333,34 +348,23 @@ SyncOnPhase:
 	   for (i = 0; i < T_null; i ++)
 	      sum += abs (ofdmBuffer [i]);
 	   sum /= T_null;
-	   static	float snr	= 0;
 	   snr = 0.9 * snr +
 	     0.1 * 20 * log10 ((myReader. get_sLevel() + 0.005) / sum);
-	   static int ccc	= 0;
-	   if (++ccc >= 2 ) {
-	      ccc = 0;
-	      show_snr ((int)snr, cLevel / cCount, sum);
+	   if (++snrCount >= 2 ) {
+	      snrCount = 0;
+	      if (metrics != nullptr) {
+	         metrics -> snr. store ((int)snr);
+	         metrics -> putEvent (SNR_EVENT, (int)snr, cLevel / cCount, sum);
+	      }
+	      else
+	         show_snr ((int)snr, cLevel / cCount, sum);
 	   }
 /*
  *	The TII data is encoded in the null period of the
  *	odd frames 
  */
-          if (params. get_dabMode () == 1) {
-	     if (wasSecond (my_ficHandler. get_CIFcount(), &params)) {
-	         my_TII_Detector. addBuffer (ofdmBuffer);
-	         if (++tii_counter >= tii_delay) {
-	            uint16_t res = my_TII_Detector. processNULL ();
-	            if (res != 0) {
-	               uint8_t mainId	= res >> 8;
-	               uint8_t subId	= res & 0xFF;
-	               tiiBuffer -> putDataIntoBuffer (ofdmBuffer. data(), T_u);
-	               show_tii (mainId, subId);
-	            }
-	            tii_counter = 0;
-	            my_TII_Detector. reset();
-	         }
-	      }
-	   }
+	   if (wasSecond (my_ficHandler. get_CIFcount(), &params))
+	      my_tiiProcessor. addNull (ofdmBuffer. data ());
 /**
   *	The first sample to be found for the next frame should be T_g
   *	samples ahead. Before going for the next frame, we
@@ -510,10 +514,18 @@ void	dabProcessor::startDumping	(SNDFILE *f) {
 	myReader. startDumping (f);
 }
 
+void	dabProcessor::startDumping	(iqzWriter *f) {
+	myReader. startDumping (f);
+}
+
 void	dabProcessor::stopDumping() {
 	myReader. stopDumping();
 }
 
+void	dabProcessor::set_iqServer	(iqServer *s) {
+	myReader. set_iqServer (s);
+}
+
 bool	dabProcessor::wasSecond (int16_t cf, dabParams *p) {
     switch (p -> get_dabMode()) {
 	   default:
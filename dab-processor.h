@@ -42,12 +42,14 @@
 #include	"msc-handler.h"
 #include	"device-handler.h"
 #include	"ringbuffer.h"
-#include	"tii_detector.h"
+#include	"tii-processor.h"
+#include	"signal-detector.h"
 //
 
 class	RadioInterface;
 class	dabParams;
 class	processParams;
+class	iqServer;
 
 class dabProcessor: public QThread {
 Q_OBJECT
@@ -59,7 +61,9 @@ public:
 	void		start			(int32_t);
 	void		stop			();
 	void		startDumping		(SNDFILE *);
+	void		startDumping		(iqzWriter *);
 	void		stopDumping		();
+	void		set_iqServer		(iqServer *);
 	void		set_scanMode		(bool);
 	void		getFrameQuality		(int *, int*, int *);
 //
@@ -94,6 +98,7 @@ public:
 private:
 	int		frequency;
 	int		threshold;
+	dabMetrics	*metrics;
 	int		totalFrames;
 	int		goodFrames;
 	int		badFrames;
@@ -102,16 +107,14 @@ private:
 	int16_t		echo_depth;
 	deviceHandler	*inputDevice;
 	dabParams	params;
-	RingBuffer<std::complex<float> > *tiiBuffer;
-	int16_t		tii_delay;
-	int16_t		tii_counter;
 
 	sampleReader	myReader;
 	RadioInterface	*myRadioInterface;
 	ficHandler	my_ficHandler;
 	mscHandler	my_mscHandler;
 	phaseReference	phaseSynchronizer;
-	TII_Detector	my_TII_Detector;
+	tiiProcessor	my_tiiProcessor;
+	signalDetector	my_signalDetector;
 	ofdmDecoder	my_ofdmDecoder;
 
 	int16_t		attempts;
@@ -128,6 +131,8 @@ private:
 	int32_t		coarseOffset;
 	QByteArray	transmitters;
 	bool		correctionNeeded;
+	float		snr;
+	int		snrCount;
 	std::vector<std::complex<float>	>ofdmBuffer;
 	bool		wasSecond		(int16_t, dabParams *);
 virtual	void		run();
@@ -135,7 +140,6 @@ signals:
 	void		setSynced		(bool);
 	void		No_Signal_Found		();
 	void		setSyncLost		();
-	void		show_tii		(int, int);
 	void		show_Spectrum		(int);
 	void		show_snr		(int, float, float);
 	void		show_clockErr		(int);
@@ -0,0 +1,92 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	The AAC access units of a superframe are - once - copied from the
+ *	superframe into an auBuffer, a buffer from a pool shared by all
+ *	mp4Processors. The buffer contains the AU itself (followed by
+ *	some zeros, as the faad decoder wants) and the same AU packed
+ *	in an LATM frame, as the fdk-aac decoder wants and as it is
+ *	written to the frame dump.
+ *	Whoever needs the AU (a decoder, a dumper, a network sink)
+ *	takes a reference, the buffer returns to the pool when the last
+ *	reference is released. The buffers are never freed, after
+ *	a short while the pool is large enough and no more buffers
+ *	are allocated, the counters show that.
+ */
+#ifndef	__AU_POOL__
+#define	__AU_POOL__
+
+#include	<QMutex>
+#include	<stdint.h>
+#include	<atomic>
+#include	<vector>
+#ifdef	__WITH_FDK_AAC__
+#include	"fdk-aac.h"
+#else
+#include	"faad-decoder.h"
+#endif
+//
+//	an AU is at most the 110 bytes per 8 kbit/s of a superframe,
+//	minus the header, at 192 kbit/s that is less than 2640 bytes.
+//	The LATM header is app 10 bytes, plus a byte per 255 AU bytes
+#define	AU_MAX_SIZE	2640
+#define	AU_PADDING	10
+#define	LATM_MAX_SIZE	(AU_MAX_SIZE + 32)
+
+class	auPool;
+
+class	auBuffer {
+public:
+	uint8_t		au	[AU_MAX_SIZE + AU_PADDING];
+	int16_t		auLength;
+	uint8_t		latm	[LATM_MAX_SIZE];
+	int16_t		latmLength;
+	stream_parms	params;
+	void		addRef		();
+	void		release		();
+private:
+	friend class	auPool;
+			auBuffer	(auPool *);
+			~auBuffer	();
+	auPool		*owner;
+	std::atomic<int32_t>	refCount;
+};
+
+class	auPool {
+public:
+	static auPool	*sharedPool	();
+	auBuffer	*getBuffer	();
+	uint32_t	allocations	();
+	uint32_t	requests	();
+	int32_t		inUse		();
+private:
+	friend class	auBuffer;
+			auPool		();
+			~auPool		();
+	void		putBuffer	(auBuffer *);
+	QMutex		locker;
+	std::vector<auBuffer *>	freeList;
+	std::atomic<uint32_t>	allocCount;
+	std::atomic<uint32_t>	requestCount;
+	std::atomic<int32_t>	usedCount;
+};
+#endif
@@ -35,6 +35,8 @@ public:
         const std::vector<uint8_t> GetData() {
 	   return data;
 	}
+        const uint8_t *Data() const {return data.data();}
+        size_t Size() const {return data.size();}
 
         void WriteAudioMuxLengthBytes();        // needed for LATM
 };
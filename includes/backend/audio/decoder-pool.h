@@ -0,0 +1,117 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	The decoding of the audio (AAC or MP2 frames to PCM) is not done
+ *	by the thread running the backend - often the thread running the
+ *	OFDM decoding - but by a small pool of worker threads, shared by
+ *	all services.
+ *	Each service (mp2 or mp4 processor) has a decodeChannel, a
+ *	bounded queue of frames, in auBuffers. The frames of a channel are
+ *	decoded in order, by one worker at the time, the decoders keep
+ *	state. The backend never waits, if the queue is full the frame
+ *	is dropped (and counted).
+ *	Per channel a histogram is kept of the latency, the time from
+ *	submitting a frame to the end of its decoding. The histogram and
+ *	the dropped frames are also added to the dabMetrics block, if
+ *	any, where the GUI and the daemon read them.
+ */
+#ifndef	__DECODER_POOL__
+#define	__DECODER_POOL__
+
+#include	<QThread>
+#include	<QMutex>
+#include	<QWaitCondition>
+#include	<QString>
+#include	<stdint.h>
+#include	<atomic>
+#include	<deque>
+#include	<vector>
+#include	"au-pool.h"
+#include	"dab-metrics.h"
+
+#define	CHANNEL_QUEUE	16
+
+class	decoderPool;
+//
+//	implemented by the processors, decodeFrame is called from
+//	one of the workers
+class	decodeClient {
+public:
+	virtual		~decodeClient	() {}
+	virtual void	decodeFrame	(auBuffer *)	= 0;
+};
+
+class	decodeChannel {
+public:
+			decodeChannel	(decodeClient *, const QString &,
+	                                         dabMetrics *metrics = nullptr);
+			~decodeChannel	();
+	bool		submit		(auBuffer *);
+	void		latencies	(uint32_t *);
+	uint32_t	dropped		();
+private:
+	friend class	decoderPool;
+	class	pendingFrame {
+	public:
+		auBuffer	*frame;
+		int64_t		submitTime;
+	};
+	decoderPool	*thePool;
+	decodeClient	*client;
+	QString		name;
+	dabMetrics	*metrics;
+	std::deque<pendingFrame>	pending;
+	bool		scheduled;	// in the ready list or being decoded
+	bool		busy;		// being decoded
+	std::atomic<uint32_t>	histogram [LATENCY_BUCKETS];
+	std::atomic<uint32_t>	droppedFrames;
+	void		record		(int64_t);
+};
+
+class	decodeWorker: public QThread {
+public:
+			decodeWorker	(decoderPool *);
+			~decodeWorker	();
+private:
+	void		run		();
+	decoderPool	*thePool;
+};
+
+class	decoderPool {
+public:
+	static decoderPool	*sharedPool	();
+private:
+	friend class	decodeChannel;
+	friend class	decodeWorker;
+			decoderPool	();
+			~decoderPool	();
+	bool		submit		(decodeChannel *, auBuffer *);
+	void		detach		(decodeChannel *);
+	bool		work		();
+	QMutex		locker;
+	QWaitCondition	workAvailable;
+	QWaitCondition	channelIdle;
+	std::deque<decodeChannel *>	readyList;
+	std::vector<decodeWorker *>	workers;
+	bool		running;
+};
+#endif
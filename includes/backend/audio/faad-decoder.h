@@ -25,6 +25,7 @@
 #include        <QObject>
 #include        "neaacdec.h"
 #include        "ringbuffer.h"
+#include	"audio-router.h"
 
 class   RadioInterface;
 
@@ -45,7 +46,8 @@ class	faadDecoder: public QObject{
 Q_OBJECT
 public:
         faadDecoder     (RadioInterface *mr,
-                         RingBuffer<int16_t> *buffer);
+                         RingBuffer<int16_t> *buffer,
+	                 audioRoute *route = nullptr);
         ~faadDecoder();
 int16_t	 MP42PCM         (stream_parms *sp,
                          uint8_t buffer [],
@@ -61,6 +63,7 @@ bool    initialize      (stream_parms *);
         NeAACDecFrameInfo       hInfo;
         int32_t         baudRate;
         RingBuffer<int16_t>     *audioBuffer;
+	audioRoute		*route;
 signals:
         void                    newAudio (int, int);
 };
@@ -30,6 +30,7 @@
 #include	<stdint.h>
 #include	<aacdecoder_lib.h>
 #include	"ringbuffer.h"
+#include	"audio-router.h"
 
 
 typedef struct {
@@ -54,7 +55,8 @@ class	fdkAAC : public QObject {
 Q_OBJECT
 public:
 		fdkAAC (RadioInterface *mr,
-                        RingBuffer<int16_t> *buffer);
+                        RingBuffer<int16_t> *buffer,
+	                audioRoute *route = nullptr);
 		~fdkAAC	();
 
 int16_t		MP42PCM (stream_parms *sp,
@@ -62,6 +64,7 @@ int16_t		MP42PCM (stream_parms *sp,
                          int16_t   packetLength);
 private:
 	RingBuffer<int16_t>	*audioBuffer;
+	audioRoute		*route;
 	bool			working;
 	HANDLE_AACDECODER	handle;
 signals:
@@ -0,0 +1,77 @@
+#
+/******************************************************************************
+** kjmp2 -- a minimal MPEG-1 Audio Layer II decoder library                  **
+*******************************************************************************
+** Copyright (C) 2006 Martin J. Fiedler <martin.fiedler@gmx.net>             **
+**                                                                           **
+** This software is provided 'as-is', without any express or implied         **
+** warranty. In no event will the authors be held liable for any damages     **
+** arising from the use of this software.                                    **
+**                                                                           **
+** Permission is granted to anyone to use this software for any purpose,     **
+** including commercial applications, and to alter it and redistribute it    **
+** freely, subject to the following restrictions:                            **
+**   1. The origin of this software must not be misrepresented; you must not **
+**      claim that you wrote the original software. If you use this software **
+**      in a product, an acknowledgment in the product documentation would   **
+**      be appreciated but is not required.                                  **
+**   2. Altered source versions must be plainly marked as such, and must not **
+**      be misrepresented as being the original software.                    **
+**   3. This notice may not be removed or altered from any source            **
+**      distribution.                                                        **
+******************************************************************************/
+//
+//	This software is a rewrite of the original kjmp2 software,
+//	Rewriting in the form of a class
+//	for use in the sdr-j DAB/DAB+ receiver
+//	all rights remain where they belong
+
+#ifndef	__MP2_DECODER__
+#define	__MP2_DECODER__
+//
+//	The kjmp2 decoder proper: a frame in, 1152 stereo samples out.
+//	It knows nothing about DAB, the mp2Processor does the framing,
+//	the PAD and the scheduling, mp2-bench uses it stand alone.
+//	With SSE_AVAILABLE or NEON_AVAILABLE the synthesis is
+//	vectorized, the output is the same as with the plain C version
+#include	<cstdint>
+
+#define KJMP2_MAX_FRAME_SIZE    1440  // the maximum size of a frame
+#define KJMP2_SAMPLES_PER_FRAME 1152  // the number of samples per frame
+
+// quantizer specification structure
+struct quantizer_spec {
+	int32_t nlevels;
+	uint8_t grouping;
+	uint8_t cw_bits;
+};
+
+class	mp2Decoder {
+public:
+			mp2Decoder	();
+			~mp2Decoder	();
+	int32_t		decodeFrame	(const uint8_t *, int16_t *);
+	bool		isStereo	();
+static	int32_t		sampleRate	(const uint8_t *);
+static	int32_t		frameLength	(uint32_t, int16_t);
+private:
+	struct quantizer_spec *read_allocation (int, int);
+	void		read_samples	(struct quantizer_spec *, int, int *);
+	int32_t		get_bits	(int32_t);
+	void		matrixing	(const int32_t *, int16_t *);
+	void		windowing	(const int16_t *, int, int16_t *);
+	int16_t		V [2][1024];
+	int16_t		Voffs;
+	int16_t		N [64][32];
+	struct quantizer_spec *allocation[2][32];
+	int32_t		scfsi[2][32];
+	int32_t		scalefactor[2][32][3];
+	int32_t		sample[2][32][3];
+	int32_t		U[512];
+
+	int32_t		bit_window;
+	int32_t		bits_in_window;
+	const uint8_t	*frame_pos;
+	bool		stereo;
+};
+#endif
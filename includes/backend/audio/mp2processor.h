@@ -37,60 +37,55 @@
 #include	<cstdio>
 #include	"ringbuffer.h"
 #include	"pad-handler.h"
-
-#define KJMP2_MAX_FRAME_SIZE    1440  // the maximum size of a frame
-#define KJMP2_SAMPLES_PER_FRAME 1152  // the number of samples per frame
-
-// quantizer specification structure
-struct quantizer_spec {
-	int32_t nlevels;
-	uint8_t grouping;
-	uint8_t cw_bits;
-};
+#include	"dab-metrics.h"
+#include	"au-pool.h"
+#include	"decoder-pool.h"
+#include	"audio-router.h"
+#include	"mp2-decoder.h"
 
 class	RadioInterface;
 
-class	mp2Processor: public QObject, public frameProcessor {
+class	mp2Processor: public QObject,
+	            public frameProcessor, public decodeClient {
 Q_OBJECT
 public:
 			mp2Processor	(RadioInterface *,
 	                                 int16_t,
 	                                 RingBuffer<int16_t> *,
-	                                 RingBuffer<uint8_t> *);
+	                                 RingBuffer<uint8_t> *,
+	                                 dabMetrics *metrics = nullptr,
+	                                 const QString &serviceName = "",
+	                                 audioRoute *route = nullptr);
 			~mp2Processor();
 	void		addtoFrame	(std::vector<uint8_t>);
+	void		decodeFrame	(auBuffer *);
 	void		setFile		(FILE *);
 
 private:
 	RadioInterface	*myRadioInterface;
+	dabMetrics	*metrics;
 	int16_t		bitRate;
 	padHandler	my_padhandler;
-	int32_t		mp2sampleRate	(uint8_t *);
-	int32_t		mp2decodeFrame	(uint8_t *, int16_t *);
+	mp2Decoder	theDecoder;
 	RingBuffer<int16_t>	*buffer;
+	audioRoute	*route;
 	int32_t		baudRate;
 	void		setSamplerate		(int32_t);
-	struct quantizer_spec *read_allocation (int, int);
-	void		read_samples	(struct quantizer_spec *, int, int *);
-	int32_t		get_bits	(int32_t);
-	int16_t		V [2][1024];
-	int16_t		Voffs;
-	int16_t		N [64][32];
-	struct quantizer_spec *allocation[2][32];
-	int32_t		scfsi[2][32];
-	int32_t		scalefactor[2][32][3];
-	int32_t		sample[2][32][3];
-	int32_t		U[512];
-
-	int32_t		bit_window;
-	int32_t		bits_in_window;
-	uint8_t		*frame_pos;
 	uint8_t		*MP2frame;
 	int16_t		MP2framesize;
-	int16_t		MP2Header_OK;
-	int16_t		MP2headerCount;
-	int16_t		MP2bitCount;
-	void		addbittoMP2	(uint8_t *, uint8_t, int16_t);
+//	the framer works on bytes, a frame may start at any bit,
+//	syncShift tells where, the last 5 input bytes are in syncWindow
+	uint64_t	syncWindow;
+	int16_t		windowFill;
+	bool		frameSync;
+	int16_t		syncShift;
+	int32_t		frameFill;
+	int32_t		frameLength;
+	int32_t		headerLength	(uint32_t);
+	int16_t		findSync	(uint64_t);
+	void		handleFrame	();
+	auPool		*thePool;
+	decodeChannel	*theChannel;
 	int16_t		numberofFrames;
 	int16_t		errorFrames;
 signals:
@@ -38,6 +38,10 @@
 #include	"reed-solomon.h"
 #include	<QObject>
 #include	"pad-handler.h"
+#include	"dab-metrics.h"
+#include	"au-pool.h"
+#include	"decoder-pool.h"
+#include	"bitWriter.h"
 
 #ifdef	__WITH_FDK_AAC__
 #include	"fdk-aac.h"
@@ -47,33 +51,49 @@
 
 class	RadioInterface;
 
-class	mp4Processor : public QObject, public frameProcessor {
+class	mp4Processor : public QObject,
+	             public frameProcessor, public decodeClient {
 Q_OBJECT
 public:
 			mp4Processor	(RadioInterface *,
 	                                 int16_t,
 	                                 RingBuffer<int16_t> *,
 	                                 RingBuffer<uint8_t> *,
-	                                 uint8_t procMode = 1);
+	                                 uint8_t procMode = 1,
+	                                 dabMetrics *metrics = nullptr,
+	                                 const QString &serviceName = "",
+	                                 audioRoute *route = nullptr);
 			~mp4Processor();
 	void		addtoFrame	(std::vector<uint8_t>);
+	void		decodeFrame	(auBuffer *);
 private:
 	RadioInterface	*myRadioInterface;
+	dabMetrics	*metrics;
+	audioRoute	*route;
 	padHandler	my_padhandler;
 	bool		processSuperframe (uint8_t [], int16_t);
 	int		build_aacFile (int16_t aac_frame_len,
                                      stream_parms *sp,
                                      uint8_t	*data,
-                                     std::vector<uint8_t> &fileBuffer);
+                                     uint8_t	*out);
+	BitWriter	au_bw;
+	auPool		*thePool;
+	decodeChannel	*theChannel;
 
 	uint8_t		procMode;
 	int16_t		superFramesize;
 	int16_t		blockFillIndex;
 	int16_t		blocksInBuffer;
+//	per block in the buffer: does a superframe start there
+//	according to the fire code
+	bool		fireCodeOK	[5];
+	bool		superframeSync;
+	int32_t		syncBlocks;
 	int16_t         frameCount;
         int16_t         frameErrors;
         int16_t         rsErrors;
         int16_t         aacErrors;
+	int		oversizeAUs;
         int16_t         aacFrames;
         int16_t         successFrames;
         int16_t         charSet;
@@ -26,6 +26,7 @@
 
 #include	"dab-constants.h"
 #include	"radio.h"
+#include	"dab-metrics.h"
 #include	<vector>
 
 class	frameProcessor;
@@ -36,7 +37,8 @@ public:
 	                 descriptorType *,
 	                 RingBuffer<int16_t> *,
 	                 RingBuffer<uint8_t> *,
-	                 RingBuffer<uint8_t> *);
+	                 RingBuffer<uint8_t> *,
+	                 dabMetrics *);
     ~backendDriver();
 void	addtoFrame	(std::vector<uint8_t> outData);
 private:
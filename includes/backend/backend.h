@@ -48,7 +48,8 @@ public:
 	                 descriptorType	*d,
 	                 RingBuffer<int16_t> *,
 	                 RingBuffer<uint8_t> *,
-	                 RingBuffer<uint8_t> *);
+	                 RingBuffer<uint8_t> *,
+	                 dabMetrics *);
 		~Backend();
 	int32_t	process		(int16_t *, int16_t);
 	void	stopRunning();
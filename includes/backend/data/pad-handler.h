@@ -30,6 +30,7 @@
 
 class	RadioInterface;
 class	motObject;
+class	audioRoute;
 
 class	padHandler: public QObject {
 Q_OBJECT
@@ -37,8 +38,11 @@ public:
 		padHandler		(RadioInterface *);
 		~padHandler();
 	void	processPAD		(uint8_t *, int16_t, uint8_t, uint8_t);
+	void	setRoute		(audioRoute *);
 private:
 		RadioInterface	*myRadioInterface;
+	audioRoute	*route;
+	void	labelReady		();
 	void	handle_variablePAD	(uint8_t *, int16_t, uint8_t);
 	void	handle_shortPAD		(uint8_t *, int16_t, uint8_t);
 	void	dynamicLabel		(uint8_t *, int16_t, uint8_t);
@@ -37,7 +37,7 @@ public:
 // error detection. x[0-1] contains parity, x[2-10] contains data
 	bool	check (const uint8_t *x); // return true if firecode check is passed
 private:
-	uint16_t tab[256];
+	uint16_t tab [8][256];
 	uint16_t run8(unsigned char regs[]);
 	static const uint8_t g[16];
 };
@@ -41,6 +41,7 @@
 #include        "ringbuffer.h"
 #include        "phasetable.h"
 #include        "freq-interleaver.h"
+#include	"dab-metrics.h"
 
 class	RadioInterface;
 class	Backend;
@@ -53,7 +54,8 @@ class	mscHandler {
 public:
 			mscHandler		(RadioInterface *,
 	                                         uint8_t,
-	                                         RingBuffer<uint8_t> *);
+	                                         RingBuffer<uint8_t> *,
+	                                         dabMetrics *metrics = nullptr);
 			~mscHandler();
 	void		processBlock_0		(std::complex<float> *);
 	void		process_Msc		(std::complex<float> *, int);
@@ -70,6 +72,7 @@ private:
 	RadioInterface	*myRadioInterface;
 	RingBuffer<uint8_t>	*dataBuffer;
 	RingBuffer<uint8_t>	*frameBuffer;
+	dabMetrics	*metrics;
 	dabParams	params;
 	fftHandler      my_fftHandler;
 	std::complex<float>     *fft_buffer;
@@ -180,6 +180,9 @@ public:
 	}
 };
 
+//	if a route is set, the decoded audio goes there,
+//	not to the audio buffer
+class	audioRoute;
 class audiodata: public descriptorType {
 public:
 	int16_t	ASCTy;
@@ -187,8 +190,10 @@ public:
 	int16_t	programType;
 	int16_t	compnr;
 	int32_t	fmFrequency;
+	audioRoute	*route;
 	audiodata() {
 	   type	= AUDIO_SERVICE;
+	   route	= nullptr;
 	}
 };
 
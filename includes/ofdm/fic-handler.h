@@ -34,6 +34,7 @@
 #include	<QObject>
 #include	"dab-params.h"
 #include	"fib-decoder.h"
+#include	"dab-metrics.h"
 
 
 class	RadioInterface;
@@ -42,7 +43,8 @@ class	dabParams;
 class ficHandler: public fibDecoder {
 Q_OBJECT
 public:
-		ficHandler		(RadioInterface *, uint8_t);
+		ficHandler		(RadioInterface *, uint8_t,
+	                                 dabMetrics *metrics = nullptr);
 		~ficHandler();
 	void	process_ficBlock	(std::vector<int16_t>, int16_t);
 	void	stop			();
@@ -50,6 +52,7 @@ public:
 	
 private:
 	dabParams	params;
+	dabMetrics	*metrics;
 	viterbiSpiral	myViterbi;
 	uint8_t		bitBuffer_out	[768];
         int16_t		ofdm_input	[2304];
@@ -31,6 +31,7 @@
 #include	"phasetable.h"
 #include	"freq-interleaver.h"
 #include	"dab-params.h"
+#include	"dab-metrics.h"
 
 class	RadioInterface;
 
@@ -40,7 +41,8 @@ public:
 		ofdmDecoder		(RadioInterface *,
 	                                 uint8_t,
 	                                 int16_t,
-	                                 RingBuffer<std::complex<float>> * iqBuffer = nullptr);
+	                                 RingBuffer<std::complex<float>> * iqBuffer = nullptr,
+	                                 dabMetrics *metrics = nullptr);
 		~ofdmDecoder();
 	void	processBlock_0		(std::vector<std::complex<float> >);
 	void	decode			(std::vector<std::complex<float> >,
@@ -54,6 +56,7 @@ private:
 	interLeaver     myMapper;
 
 	RingBuffer<std::complex<float>> *iqBuffer;
+	dabMetrics	*metrics;
 	float		computeQuality	(std::complex<float> *);
         void            compute_timeOffset      (std::complex<float> *,
                                                  std::complex<float> *);
@@ -34,19 +34,22 @@
 #include	<vector>
 #include	"device-handler.h"
 #include	"ringbuffer.h"
+#include	"dump-writer.h"
+#include	"dab-metrics.h"
 //
-//      Note:
-//      It was found that enlarging the buffersize to e.g. 8192
-//      cannot be handled properly by the underlying system.
+//	the samples for the dump are converted in chunks of
+//	DUMPSIZE / 2 samples and passed on to the dumpWriter
 #define DUMPSIZE                4096
 
 class	RadioInterface;
+class	iqServer;
 class	sampleReader : public QObject {
 Q_OBJECT
 public:
 			sampleReader	(RadioInterface *mr,
 	                         	deviceHandler *theRig,
-	                         	RingBuffer<std::complex<float>> *spectrumBuffer = nullptr);
+	                         	RingBuffer<std::complex<float>> *spectrumBuffer = nullptr,
+	                         	dabMetrics *metrics = nullptr);
 
 			~sampleReader();
 		void	setRunning	(bool b);
@@ -55,11 +58,14 @@ public:
 	        void	getSamples	(std::complex<float> *v,
 	                                 int32_t n, int32_t phase);
 	        void	startDumping	(SNDFILE *);
+	        void	startDumping	(iqzWriter *);
 	        void	stopDumping();
+	        void	set_iqServer	(iqServer *);
 private:
 		RadioInterface	*myRadioInterface;
 		deviceHandler	*theRig;
 		RingBuffer<std::complex<float>> *spectrumBuffer;
+		dabMetrics	*metrics;
 		std::vector<std::complex<float>> localBuffer;
 		int32_t		localCounter;
 		int32_t		bufferSize;
@@ -69,11 +75,23 @@ private:
 		float		sLevel;
 		int32_t		sampleCount;
 	        int32_t		corrector;
-		bool		dumping;
-		int16_t         dumpIndex;
 		int16_t         dumpScale;
 		int16_t         dumpBuffer [DUMPSIZE];
-		std::atomic<SNDFILE *>	dumpfilePointer;
+		dumpWriter	theDumper;
+		std::atomic<iqServer *>	theServer;
+		void		dumpSamples	(const std::complex<float> *,
+	                                                       int32_t);
+//
+//	devices may deliver their samples in their native format,
+//	conversion to std::complex<float> is then done here
+		int16_t		sampleFormat;
+		std::vector<uint8_t>	rawBuffer;
+		float		u8Table [256];
+		float		sampleScale;
+		int32_t		readSamples	(std::complex<float> *, int32_t);
+		void		convert_u8	(const uint8_t *, float *, int32_t);
+		void		convert_s8	(const int8_t *, float *, int32_t);
+		void		convert_s16	(const int16_t *, float *, int32_t);
 signals:
 		void		show_Spectrum (int);
 	        void		show_Corrector (int);
@@ -0,0 +1,65 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__SIGNAL_DETECTOR__
+#define	__SIGNAL_DETECTOR__
+/*
+ *	The signalDetector is used while scanning. It looks - in a
+ *	single frame worth of samples, i.e. app 100 msec in Mode I -
+ *	whether or not it is worth the effort to try to synchronize
+ *	on the channel, which may take up to 8 frames.
+ */
+#include	<cstdint>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"dab-params.h"
+#include	"fft-handler.h"
+
+class	sampleReader;
+
+class	signalDetector {
+public:
+			signalDetector	(sampleReader *, uint8_t);
+			~signalDetector	();
+	bool		signalPresent	();
+	float		get_occupancy	();
+	float		get_dipLevel	();
+private:
+	sampleReader	*myReader;
+	dabParams	params;
+	fftHandler	my_fftHandler;
+	std::complex<float>	*fft_buffer;
+	int32_t		T_u;
+	int32_t		T_null;
+	int32_t		T_F;
+	int32_t		carriers;
+	int32_t		segmentSize;
+	std::vector<std::complex<float>> inBuffer;
+	std::vector<float>	powerSpectrum;
+	std::vector<float>	segmentLevels;
+	float		occupancy;
+	float		dipLevel;
+	void		compute_occupancy	();
+	void		compute_dipLevel	();
+};
+#endif
+
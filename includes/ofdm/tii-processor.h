@@ -0,0 +1,68 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__TII_PROCESSOR__
+#define	__TII_PROCESSOR__
+/*
+ *	The tiiProcessor runs the TII detection in a thread of its own.
+ *	The dabProcessor just passes a copy of the null period
+ *	(if there is room for it, otherwise it is dropped), so it does
+ *	not have to wait for the - relatively expensive - detection
+ */
+#include	<QThread>
+#include	<QObject>
+#include	<QSemaphore>
+#include	<atomic>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"ringbuffer.h"
+#include	"tii_detector.h"
+
+class	RadioInterface;
+class	processParams;
+
+class	tiiProcessor: public QThread {
+Q_OBJECT
+public:
+			tiiProcessor	(RadioInterface *, processParams *);
+			~tiiProcessor	();
+	void		addNull		(const std::complex<float> *);
+	void		reset		();
+	void		stop		();
+private:
+	TII_Detector	my_TII_Detector;
+	RingBuffer<std::complex<float>>	nullBuffer;
+	RingBuffer<std::complex<float>>	*tiiBuffer;
+	QSemaphore	nullsAvailable;
+	int16_t		T_u;
+	int16_t		tii_delay;
+	int16_t		tii_counter;
+	std::atomic<bool>	resetRequest;
+	std::atomic<bool>	running;
+	std::vector<std::complex<float>>	theNull;
+	void		run		();
+signals:
+	void		show_tii	(int, int, float);
+};
+#endif
+
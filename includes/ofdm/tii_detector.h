@@ -28,17 +28,36 @@
 #include	"dab-params.h"
 #include	"fft-handler.h"
 #include	<vector>
+//
+//	one entry for each transmitter found in the null period,
+//	strength is in dB, relative to the strongest one
+class	tiiResult {
+public:
+	uint8_t		mainId;
+	uint8_t		subId;
+	float		strength;
+};
+
+//
+//	a contiguous range of carrier pairs in the fft output
+class	tiiRun {
+public:
+	int16_t		fftIndex;
+	int16_t		pairIndex;
+	int16_t		length;
+};
 
 class	TII_Detector {
 public:
 			TII_Detector	(uint8_t dabMode, int16_t);
 			~TII_Detector();
 	void		reset();
-	void		addBuffer	(std::vector<std::complex<float>>);
-	uint16_t	processNULL	();
+	void		addBuffer	(const std::vector<std::complex<float>> &);
+	std::vector<tiiResult>	processNULL	();
+	bool		is_supported	();
 
 private:
-	void			collapse	(std::complex<float> *,
+	void			collapse	(const std::complex<float> *,
 	                                         float *);
 	int16_t			depth;
 	uint8_t			invTable [256];
@@ -48,7 +67,8 @@ private:
 	int16_t			carriers;
 	std::complex<float>	*fft_buffer;
 	std::vector<complex<float> >	theBuffer;
-	std::vector<float>	window;
+	std::vector<float>	pairBuffer;
+	std::vector<tiiRun>	runs;
 };
 
 #endif
@@ -29,6 +29,8 @@
 #include	<QMutex>
 #include	<QObject>
 #include	"newconverter.h"
+#include	"audio-dump-writer.h"
+#include	<vector>
 #include	"ringbuffer.h"
 
 
@@ -44,14 +46,11 @@ virtual	void		restart();
 	void		startDumping		(SNDFILE *);
 	void		stopDumping();
 private:
-	void		audioOut_16000		(int16_t *, int32_t);
-	void		audioOut_24000		(int16_t *, int32_t);
-	void		audioOut_32000		(int16_t *, int32_t);
-	void		audioOut_48000		(int16_t *, int32_t);
 	newConverter	converter_16;
 	newConverter	converter_24;
 	newConverter	converter_32;
-	SNDFILE		*dumpFile;
+	std::vector<float>	outBuffer;
+	audioDumpWriter	*dumper;
 	QMutex		myLocker;
 protected:
 virtual	void		audioOutput		(float *, int32_t);
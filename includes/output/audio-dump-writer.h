@@ -1,6 +1,6 @@
 #
 /*
- *    Copyright (C) 2013 .. 2017
+ *    Copyright (C) 2014 .. 2020
  *    Jan van Katwijk (J.vanKatwijk@gmail.com)
  *    Lazy Chair Computing
  *
@@ -19,36 +19,33 @@
  *    You should have received a copy of the GNU General Public License
  *    along with Qt-DAB; if not, write to the Free Software
  *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	The audioDumpWriter writes the audio - 48000 stereo float samples -
+ *	to the dump file in a thread of its own. The audio path only
+ *	puts the samples in a ringbuffer, it never waits for the file.
+ *	If the writer cannot keep up, samples are dropped and counted.
  */
-#ifndef	__RAW_READER__
-#define	__RAW_READER__
+#ifndef	__AUDIO_DUMP_WRITER__
+#define	__AUDIO_DUMP_WRITER__
 
 #include	<QThread>
-#include	"dab-constants.h"
-#include	"ringbuffer.h"
+#include	<sndfile.h>
 #include	<atomic>
-class	rawFiles;
+#include	<vector>
+#include	"ringbuffer.h"
 
-class	rawReader:public QThread {
-Q_OBJECT
+class	audioDumpWriter: public QThread {
 public:
-			rawReader	(rawFiles *,
-	                                 FILE *, RingBuffer<std::complex<float>> *); 
-			~rawReader();
-	void		startReader();
-	void		stopReader();
+			audioDumpWriter	(SNDFILE *);
+			~audioDumpWriter	();
+	void		putSamples	(const float *, int32_t);
+	int32_t		dropped		();
 private:
-virtual void		run();
-	FILE		*filePointer;
-	RingBuffer<std::complex<float>>	*_I_Buffer;
-	uint64_t	period;
+	void		run		();
+	SNDFILE		*dumpFile;
+	RingBuffer<float>	dumpBuffer;
 	std::atomic<bool>	running;
-	uint8_t		*bi;
-	rawFiles	*parent;
-	int64_t		fileLength;
-signals:
-	void		setProgress	(int, float);
+	std::atomic<int32_t>	droppedFrames;
 };
-
 #endif
 
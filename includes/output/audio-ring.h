@@ -0,0 +1,128 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	audioRing is a single writer, single reader ring for stereo
+ *	float frames, the writer is the thread passing the audio, the
+ *	reader the callback of the audio device.
+ *	The indices count frames, they are free running and only
+ *	masked when used, the writer publishes its index with a release
+ *	store, the reader its index, so the writer sees the space
+ *	becoming free only after the reader is done with it.
+ *	The reader - and only the reader - may skip frames to bring the
+ *	fill level down.
+ */
+#ifndef	__AUDIO_RING__
+#define	__AUDIO_RING__
+
+#include	<atomic>
+#include	<vector>
+#include	<cstdint>
+#include	<cstring>
+
+class	audioRing {
+public:
+			audioRing	(uint32_t frames) {
+	   uint32_t size	= 1;
+	   while (size < frames)
+	      size <<= 1;
+	   buffer. resize (2 * size);
+	   mask		= size - 1;
+	   writeIndex. store (0);
+	   readIndex. store (0);
+	}
+			~audioRing	() {}
+
+	int32_t		capacity	() {
+	   return mask + 1;
+	}
+//	the number of frames available for the reader
+	int32_t		fill		() {
+	   return writeIndex. load (std::memory_order_acquire) -
+	          readIndex. load (std::memory_order_acquire);
+	}
+
+	int32_t		space		() {
+	   return capacity () - fill ();
+	}
+//
+//	writer side, what does not fit is not written
+	int32_t		put		(const float *v, int32_t frames) {
+	   uint32_t w	= writeIndex. load (std::memory_order_relaxed);
+	   uint32_t r	= readIndex. load (std::memory_order_acquire);
+	   int32_t free	= capacity () - (int32_t)(w - r);
+	   if (frames > free)
+	      frames	= free;
+	   copyIn (w, v, frames);
+	   writeIndex. store (w + frames, std::memory_order_release);
+	   return frames;
+	}
+//
+//	reader side, the result is the number of frames read
+	int32_t		get		(float *v, int32_t frames) {
+	   uint32_t r	= readIndex. load (std::memory_order_relaxed);
+	   uint32_t w	= writeIndex. load (std::memory_order_acquire);
+	   if (frames > (int32_t)(w - r))
+	      frames	= w - r;
+	   copyOut (r, v, frames);
+	   readIndex. store (r + frames, std::memory_order_release);
+	   return frames;
+	}
+
+	int32_t		skip		(int32_t frames) {
+	   uint32_t r	= readIndex. load (std::memory_order_relaxed);
+	   uint32_t w	= writeIndex. load (std::memory_order_acquire);
+	   if (frames > (int32_t)(w - r))
+	      frames	= w - r;
+	   readIndex. store (r + frames, std::memory_order_release);
+	   return frames;
+	}
+//
+//	only when the reader is not running
+	void		flush		() {
+	   readIndex. store (writeIndex. load ());
+	}
+private:
+	std::vector<float>	buffer;
+	uint32_t		mask;
+	std::atomic<uint32_t>	writeIndex;
+	std::atomic<uint32_t>	readIndex;
+
+	void		copyIn		(uint32_t w, const float *v, int32_t n) {
+	   uint32_t start	= w & mask;
+	   int32_t first	= n < (int32_t)(capacity () - start) ?
+	                                     n : capacity () - start;
+	   memcpy (&buffer [2 * start], v, 2 * first * sizeof (float));
+	   memcpy (buffer. data (), &v [2 * first],
+	                             2 * (n - first) * sizeof (float));
+	}
+
+	void		copyOut		(uint32_t r, float *v, int32_t n) {
+	   uint32_t start	= r & mask;
+	   int32_t first	= n < (int32_t)(capacity () - start) ?
+	                                     n : capacity () - start;
+	   memcpy (v, &buffer [2 * start], 2 * first * sizeof (float));
+	   memcpy (&v [2 * first], buffer. data (),
+	                             2 * (n - first) * sizeof (float));
+	}
+};
+#endif
+
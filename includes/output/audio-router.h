@@ -0,0 +1,165 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	The audioRouter passes the PCM output of any number of services
+ *	to any number of sinks.
+ *	The decoder of a routed service writes its samples - 16 bit
+ *	stereo frames - once, in the ring of its audioRoute. Each sink
+ *	attached to the route has its own thread and its own read
+ *	position in that ring, the sink gets pointers into the ring,
+ *	so there is no copying per sink, and a slow sink does not
+ *	delay the others.
+ *	A sink that lags too much skips ahead, the decoder never waits.
+ *	Per sink the frames, the gaps in the input (underruns), the
+ *	skipped frames (overruns) and the latency are counted.
+ *	A compressed sink gets the encoded frames of the service -
+ *	AAC as LATM/LOAS, MP2 as is - and its dynamic labels instead,
+ *	directly from the decoder thread, such a sink may not wait.
+ *	Per compressed sink the frames it sent and the frames it
+ *	dropped are counted.
+ *	A service with compressed sinks only is not decoded.
+ */
+#ifndef	__AUDIO_ROUTER__
+#define	__AUDIO_ROUTER__
+
+#include	<QMutex>
+#include	<QString>
+#include	<sndfile.h>
+#include	<stdint.h>
+#include	<atomic>
+#include	<vector>
+
+class	audioBase;
+class	audioRouter;
+class	routeOutput;
+class	frameOutput;
+
+#define	ROUTE_FRAME_AAC		1
+#define	ROUTE_FRAME_MP2		2
+//
+//	what a compressed sink did with a frame, a frame no one
+//	was listening for is not a dropped one
+#define	FRAME_SENT		0
+#define	FRAME_IDLE		1
+#define	FRAME_DROPPED		2
+//
+//	a sink gets the frames of one service, with their rate
+class	pcmSink {
+public:
+			pcmSink		() {}
+virtual			~pcmSink	() {}
+virtual	void		pcmOut		(const int16_t *, int32_t, int32_t) = 0;
+virtual	QString		description	() = 0;
+virtual	bool		compressed	() { return false; }
+//	a compressed sink tells what happened to the frame
+virtual	int		frameOut	(const uint8_t *, int32_t, int) {
+	                                            return FRAME_DROPPED; }
+virtual	void		labelOut	(const QString &) {}
+};
+//
+//	a wav file, opened with the rate of the first frames
+class	fileSink: public pcmSink {
+public:
+			fileSink	(const QString &);
+			~fileSink	();
+	void		pcmOut		(const int16_t *, int32_t, int32_t);
+	QString		description	();
+private:
+	QString		fileName;
+	SNDFILE		*theFile;
+	int32_t		fileRate;
+	bool		failed;
+};
+//
+//	one of the existing outputs, portaudio, Qt audio or the
+//	tcp streamer, the sink owns it
+class	deviceSink: public pcmSink {
+public:
+			deviceSink	(audioBase *, const QString &);
+			~deviceSink	();
+	void		pcmOut		(const int16_t *, int32_t, int32_t);
+	QString		description	();
+private:
+	audioBase	*theDevice;
+	QString		name;
+};
+
+class	nullSink: public pcmSink {
+public:
+			nullSink	() {}
+			~nullSink	() {}
+	void		pcmOut		(const int16_t *, int32_t, int32_t) {}
+	QString		description	() { return "null"; }
+};
+
+class	routeStats {
+public:
+	QString		service;
+	QString		sink;
+	int64_t		frames;
+	int32_t		underruns;
+	int64_t		overrunFrames;
+	int64_t		droppedFrames;		// compressed sinks
+	int32_t		latency;		// msec, mean
+	int32_t		maxLatency;		// msec
+};
+//
+//	putSamples is called by the decoder of the service,
+//	the number of frames should be (much) less than ROUTE_FRAMES / 2.
+//	putFrame and putLabel are called by the processor of the service.
+//	The sinks are added before the service is started
+class	audioRoute {
+public:
+			audioRoute	(const QString &);
+			~audioRoute	();
+	void		putSamples	(const int16_t *, int32_t, int32_t);
+	void		putFrame	(const uint8_t *, int32_t, int);
+	void		putLabel	(const QString &);
+	bool		wantsPcm	();
+	bool		wantsFrames	();
+	QString		serviceName	();
+private:
+friend	class	audioRouter;
+friend	class	routeOutput;
+friend	class	frameOutput;
+	QString		service;
+	std::vector<int16_t>	theRing;
+	uint64_t	ringMask;
+	std::atomic<uint64_t>	writePosition;
+	std::atomic<int32_t>	rate;
+	std::vector<routeOutput *>	outputs;
+	std::vector<frameOutput *>	frameSinks;
+};
+
+class	audioRouter {
+public:
+			audioRouter	();
+			~audioRouter	();
+	audioRoute	*addRoute	(const QString &);
+	void		removeRoute	(audioRoute *);
+	void		addSink		(audioRoute *, pcmSink *);
+	std::vector<routeStats>	statistics	();
+private:
+	QMutex		locker;
+	std::vector<audioRoute *>	theRoutes;
+};
+#endif
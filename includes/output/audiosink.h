@@ -23,6 +23,14 @@
  *    along with Qt-DAB; if not, write to the Free Software
  *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
+ *	The audio passes through an audioRing to the callback of the
+ *	soundcard. The clock of the soundcard is not the clock of the
+ *	broadcast, so, left alone, the fill level of the ring - i.e.
+ *	the latency - drifts. The fill level is kept at a target level
+ *	by resampling the audio with a ratio slightly different from 1,
+ *	set by a PI controller on the (smoothed) fill level.
+ *	If the ring still gets too full, the callback skips frames,
+ *	if it gets empty, it outputs zeros. Both are counted.
  */
 
 #ifndef __AUDIO_SINK
@@ -32,7 +40,10 @@
 #include	<portaudio.h>
 #include	<cstdio>
 #include	"audio-base.h"
-#include	"ringbuffer.h"
+#include	"audio-ring.h"
+#include	"newconverter.h"
+#include	<atomic>
+#include	<vector>
 
 class	QComboBox;
 
@@ -47,6 +58,11 @@ public:
 	bool		selectDevice		(int16_t);
 	bool		selectDefaultDevice();
 	int32_t		missed();
+	void		setTargetLevel		(int32_t);
+	void		telemetry		(int32_t *underruns,
+	                                         int32_t *overruns,
+	                                         int32_t *fillLevel,
+	                                         int32_t *ppm);
 private:
 	int16_t		numberofDevices();
 	QString		outputChannelwithRate	(int16_t, int32_t);
@@ -65,8 +81,18 @@ private:
 	int		paCallbackReturn;
 	int16_t		bufSize;
 	PaStream	*ostream;
-	SNDFILE		*dumpFile;
-	RingBuffer<float>	_O_Buffer;
+	audioRing	theRing;
+	newConverter	driftConverter;
+	std::vector<float>	driftBuffer;
+	int32_t		targetLevel;		// in frames
+	int32_t		maxLevel;
+	double		smoothedFill;
+	double		integral;
+	std::atomic<double>	currentRatio;
+	std::atomic<int32_t>	underrunCount;
+	std::atomic<int32_t>	overrunCount;
+	std::atomic<int32_t>	missedFrames;
+	void		adjustRatio		(int32_t);
 	PaStreamParameters	outputParameters;
 
 	int16_t		*outTable;
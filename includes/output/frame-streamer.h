@@ -0,0 +1,67 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	A compressed sink, passing the encoded frames of a service -
+ *	AAC as LATM/LOAS, MP2 as is - to any number of network
+ *	clients, using the stream server. A client decodes itself,
+ *	a stream takes the bitrate of the service rather than the
+ *	1.5 Mbit/s of the pcm samples.
+ *	Plain, the stream consists of the frames only, it can be
+ *	played directly (e.g. "ffplay -f loas tcp://host:port").
+ *	With labels, each frame - and each dynamic label - is preceded
+ *	by the 8 byte header used by the data streamer: 0xFF 0x00 0xFF
+ *	0x00, the length (2 bytes, msb first), 0x00 and the type
+ *	FRAME_AAC, FRAME_MP2 or FRAME_LABEL (utf-8 text).
+ *	Each frame is a unit for the server, so a client moving ahead
+ *	continues with a complete frame.
+ */
+#ifndef	__FRAME_STREAMER__
+#define	__FRAME_STREAMER__
+
+#include	"audio-router.h"
+#include	"stream-server.h"
+#include	<vector>
+
+#define	FRAME_AAC	ROUTE_FRAME_AAC
+#define	FRAME_MP2	ROUTE_FRAME_MP2
+#define	FRAME_LABEL	3
+
+class	frameStreamer: public pcmSink {
+public:
+			frameStreamer	(int port, bool withLabels,
+	                                 int policy = SLOW_CLIENT_SKIP);
+			~frameStreamer	();
+	bool		isOpen		();
+	bool		compressed	() { return true; }
+	void		pcmOut		(const int16_t *, int32_t, int32_t) {}
+	int		frameOut	(const uint8_t *, int32_t, int);
+	void		labelOut	(const QString &);
+	QString		description	();
+private:
+	bool		sendUnit	(const uint8_t *, int32_t, int);
+	streamChannel	*theStream;
+	int		port;
+	bool		withLabels;
+	std::vector<uint8_t>	unit;
+};
+#endif
+
@@ -32,6 +32,12 @@
 #include	<samplerate.h>
 #include	"dab-constants.h"
 
+//
+//	newConverter converts a block of 16 bit stereo samples, as
+//	delivered by the audio decoders, at once into (interleaved)
+//	float samples at the output rate. The buffers are allocated
+//	in the constructor, inSize is the size of the blocks - in
+//	frames - passed to libsamplerate, larger input is split
 class	newConverter {
 private:
 	int32_t		inRate;
@@ -42,17 +48,21 @@ private:
 	SRC_STATE	*converter;
 	SRC_DATA	src_data;
 	std::vector<float> inBuffer;
-	std::vector<float> outBuffer;
-	int32_t		inp;
+	int32_t	process		(const float *in, int32_t nFrames,
+	                                                  float *out);
 public:
 		newConverter (int32_t inRate, int32_t outRate, 
 	                      int32_t inSize);
 
 		~newConverter();
 
-	bool	convert (std::complex<float> v,
-	                       std::complex<float> *out, int32_t *amount);
-
+	int32_t	convert		(const int16_t *in, int32_t nFrames,
+	                                                  float *out);
+	int32_t	convert		(const float *in, int32_t nFrames,
+	                                                  float *out);
+	void	setRatio	(double);
+	int32_t	maxOutput	(int32_t nFrames);
+static	void	toFloat		(const int16_t *in, float *out, int32_t n);
 int32_t	getOutputsize();
 };
 
@@ -28,34 +28,23 @@
 #define	__TCP_STREAMER__
 
 #include	"dab-constants.h"
-#include	"ringbuffer.h"
-#include	<QByteArray>
-#include	<QHostAddress>
-#include	<QtNetwork>
-#include	<QTcpServer>
-#include	<QTcpSocket>
-#include	<QTimer>
+#include	<vector>
 #include	"audio-base.h"
-
+#include	"stream-server.h"
+//
+//	The pcm samples are made available, as 16 bit stereo
+//	samples msb first, to any number of clients, by the
+//	stream server
 class	tcpStreamer: public audioBase {
 Q_OBJECT
 public:
-		tcpStreamer	(int32_t);
-		~tcpStreamer	(void);
+		tcpStreamer	(int32_t port,
+	                         int policy = SLOW_CLIENT_SKIP);
+		~tcpStreamer	();
 	void	audioOutput	(float *, int32_t);
 private:
-	RingBuffer<float>	*buffer;
-	int32_t			port;
-	QTcpServer		streamer;
-	QTcpSocket		*client;
-	QTcpSocket		*streamerAddress;
-	QTimer			watchTimer;
-	bool			connected;
-public slots:
-	void			acceptConnection	(void);
-	void			processSamples		(void);
-signals:
-	void			handleSamples		(void);
+	streamChannel		*theStream;
+	std::vector<uint8_t>	sendBuffer;
 };
 #endif
 
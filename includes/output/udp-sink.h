@@ -0,0 +1,52 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	A sink for the audio router, sending the pcm samples of a
+ *	service as datagrams. It uses POSIX sockets, on Windows
+ *	there is no udp sink
+ */
+#ifndef	__UDP_SINK__
+#define	__UDP_SINK__
+#ifndef	__MINGW32__
+
+#include	"audio-router.h"
+#include	<QString>
+#include	<stdint.h>
+#include	<vector>
+//
+//	raw 16 bit stereo, little endian, in datagrams of at most
+//	UDP_FRAMES frames
+class	udpSink: public pcmSink {
+public:
+			udpSink		(const QString &host, int port);
+			~udpSink	();
+	void		pcmOut		(const int16_t *, int32_t, int32_t);
+	QString		description	();
+private:
+	QString		host;
+	int		port;
+	int		socketDesc;
+	std::vector<uint8_t>	address;
+};
+#endif
+#endif
+
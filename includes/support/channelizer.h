@@ -0,0 +1,97 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__CHANNELIZER__
+#define	__CHANNELIZER__
+/*
+ *	The channelizer splits a wideband stream of samples, e.g. from
+ *	a 10 MS/s recording, into a number of streams with a rate
+ *	of 2048000, one for each DAB channel within the band.
+ *	Each channel is shifted to baseband and decimated with
+ *	a polyphase filter. The channels are handled by a small
+ *	pool of workers, each worker handling a subset of the channels.
+ */
+#include	<QThread>
+#include	<QSemaphore>
+#include	<atomic>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"ringbuffer.h"
+#include	"polyphase-resampler.h"
+
+class	channelStream {
+public:
+			channelStream	(int32_t inputRate,
+	                                 int32_t offset,
+	                                 int32_t bufferSize);
+			~channelStream	();
+	void		process		(const std::complex<float> *, int32_t);
+	RingBuffer<std::complex<float>>	theBuffer;
+	int32_t		offset;
+	std::atomic<bool>	running;
+private:
+	polyphaseResampler	theResampler;
+	std::complex<double>	rotor;
+	std::complex<double>	rotorStep;
+	std::vector<std::complex<float>> mixBuffer;
+	std::vector<std::complex<float>> outBuffer;
+};
+
+class	channelWorker : public QThread {
+public:
+			channelWorker	(QSemaphore *);
+			~channelWorker	();
+	void		addChannel	(channelStream *);
+	void		doWork		(const std::complex<float> *, int32_t);
+	void		stop		();
+private:
+	void		run		();
+	std::vector<channelStream *> theChannels;
+	QSemaphore	workToDo;
+	QSemaphore	*workDone;
+	const std::complex<float>	*inVector;
+	int32_t		inSize;
+	std::atomic<bool>	running;
+};
+
+class	channelizer {
+public:
+			channelizer	(int32_t inputRate,
+	                                 int32_t centerFrequency,
+	                                 std::vector<int32_t> &frequencies,
+	                                 int16_t nrWorkers);
+			~channelizer	();
+	void		process		(const std::complex<float> *, int32_t);
+	int		nrChannels	();
+	int32_t		channelFrequency	(int);
+	RingBuffer<std::complex<float>>	*channelBuffer	(int);
+	void		dropChannel	(int);
+	void		stop		();
+private:
+	int32_t		centerFrequency;
+	std::vector<channelStream *>	theChannels;
+	std::vector<channelWorker *>	theWorkers;
+	QSemaphore	workDone;
+};
+#endif
+
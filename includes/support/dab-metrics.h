@@ -0,0 +1,156 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	The dabMetrics block collects the statistics of the DSP threads
+ *	(sampleReader, ofdmDecoder, ficHandler, dabProcessor and the
+ *	audio processors). Instead of emitting a signal - a queued
+ *	event for the GUI thread - per value, the threads store the
+ *	value here, the GUI (or any other reader) samples the block
+ *	on a timer. No Qt is used, a headless tool may read it as well.
+ *	- levels (corrector, snr, ...) are plain atomics, the last
+ *	  value written is the one that counts. The error rates are -1
+ *	  as long as nothing was reported;
+ *	- counters (fic blocks, constellations, ...) only increase,
+ *	  the reader takes the difference with the previous sample;
+ *	- the snr samples - each of them is drawn by the snr viewer -
+ *	  go through a small single writer, single reader event ring.
+ *	  When the ring is full the event is dropped and counted.
+ *	The decoding latency histogram of the decoderPool is a set of
+ *	counters as well, summed over the services that report to
+ *	the block.
+ */
+#ifndef	__DAB_METRICS__
+#define	__DAB_METRICS__
+
+#include	<atomic>
+#include	<cstdint>
+
+#define	METRICS_EVENTS	256		// a power of 2
+//	latency buckets: < 1, 2, 5, 10, 20, 50, 100, 200 msec, and more
+#define	LATENCY_BUCKETS	9
+static const int32_t latencyLimits [LATENCY_BUCKETS - 1] =
+	                          {1, 2, 5, 10, 20, 50, 100, 200};
+
+class	metricsEvent {
+public:
+	int32_t	kind;
+	int32_t	value;
+	float	v1;
+	float	v2;
+};
+
+#define	SNR_EVENT	1
+
+class	dabMetrics {
+public:
+			dabMetrics	() {
+	   corrector. store (0);
+	   snr. store (0);
+	   clockError. store (0);
+	   quality. store (0);
+	   iqAmount. store (0);
+	   iqCount. store (0);
+	   ficBlocks. store (0);
+	   ficSuccess. store (0);
+	   frameErrors. store (-1);
+	   rsErrors. store (-1);
+	   aacErrors. store (-1);
+	   stereo. store (-1);
+	   syncLatency. store (-1);
+	   framesOut. store (0);
+	   auBuffers. store (0);
+	   auRequests. store (0);
+	   oversizeAUs. store (0);
+	   writeIndex. store (0);
+	   readIndex. store (0);
+	   droppedEvents. store (0);
+	   for (int i = 0; i < LATENCY_BUCKETS; i ++)
+	      decodeLatency [i]. store (0);
+	   decodeDropped. store (0);
+	}
+			~dabMetrics	() {}
+//	sampleReader
+	std::atomic<int32_t>	corrector;
+//	dabProcessor
+	std::atomic<int32_t>	snr;
+	std::atomic<int32_t>	clockError;
+//	ofdmDecoder, iqAmount samples were added to the iqBuffer
+	std::atomic<float>	quality;
+	std::atomic<int32_t>	iqAmount;
+	std::atomic<uint32_t>	iqCount;
+//	ficHandler
+	std::atomic<uint32_t>	ficBlocks;
+	std::atomic<uint32_t>	ficSuccess;
+//	mp2/mp4 processors, errors per 25 frames
+	std::atomic<int32_t>	frameErrors;
+	std::atomic<int32_t>	rsErrors;
+	std::atomic<int32_t>	aacErrors;
+	std::atomic<int32_t>	stereo;
+//	mp4 processor, msec from the start (or from a loss of sync)
+//	until the first correct superframe, -1 while not known
+	std::atomic<int32_t>	syncLatency;
+//	aac frames written to the frameBuffer
+	std::atomic<uint32_t>	framesOut;
+//	mp4 processor, the buffers allocated by the (shared) AU pool and
+//	the number of AUs passed through it
+	std::atomic<uint32_t>	auBuffers;
+	std::atomic<uint32_t>	auRequests;
+//	mp4 processor, AUs larger than an auBuffer, they are skipped
+	std::atomic<uint32_t>	oversizeAUs;
+//	decoderPool, frames decoded per latency bucket (see latencyLimits)
+//	and frames dropped since the queue of the service was full
+	std::atomic<uint32_t>	decodeLatency [LATENCY_BUCKETS];
+	std::atomic<uint32_t>	decodeDropped;
+	std::atomic<uint32_t>	droppedEvents;
+
+	bool	putEvent	(int32_t kind, int32_t value,
+	                                         float v1, float v2) {
+	   uint32_t w	= writeIndex. load (std::memory_order_relaxed);
+	   if (w - readIndex. load (std::memory_order_acquire) >=
+	                                               METRICS_EVENTS) {
+	      droppedEvents. fetch_add (1, std::memory_order_relaxed);
+	      return false;
+	   }
+	   metricsEvent *e	= &theEvents [w & (METRICS_EVENTS - 1)];
+	   e -> kind	= kind;
+	   e -> value	= value;
+	   e -> v1	= v1;
+	   e -> v2	= v2;
+	   writeIndex. store (w + 1, std::memory_order_release);
+	   return true;
+	}
+
+	bool	getEvent	(metricsEvent *e) {
+	   uint32_t r	= readIndex. load (std::memory_order_relaxed);
+	   if (r == writeIndex. load (std::memory_order_acquire))
+	      return false;
+	   *e	= theEvents [r & (METRICS_EVENTS - 1)];
+	   readIndex. store (r + 1, std::memory_order_release);
+	   return true;
+	}
+private:
+	metricsEvent		theEvents [METRICS_EVENTS];
+	std::atomic<uint32_t>	writeIndex;
+	std::atomic<uint32_t>	readIndex;
+};
+#endif
+
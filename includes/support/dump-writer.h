@@ -0,0 +1,89 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__DUMP_WRITER__
+#define	__DUMP_WRITER__
+/*
+ *	The dumpWriter writes the (raw) samples for a dump to file
+ *	in a thread of its own, the producer - a device callback or
+ *	the sampleReader - just copies the data into a block.
+ *	Full blocks are handed over to the writer thread; if the
+ *	writer cannot keep up and no free block is available, the
+ *	new data is dropped (and counted) rather than that the
+ *	producer waits, put tells how many bytes were taken.
+ *	The blocks and the thread are only created on the first open.
+ *	The data goes either to a plain file (the .uff xml files),
+ *	to an sndfile (the .sdr files) or to an iqzWriter, which
+ *	then does the compression in the writer thread
+ */
+#include	<QThread>
+#include	<QSemaphore>
+#include	<QMutex>
+#include	<atomic>
+#include	<vector>
+#include	<cstdio>
+#include	<cstdint>
+#include	<sndfile.h>
+#include	"ringbuffer.h"
+#include	"iqz-format.h"
+
+#define	DUMP_BLOCKSIZE	(1 << 20)
+#define	DUMP_BLOCKS	16
+
+class	dumpWriter: public QThread {
+public:
+			dumpWriter	(int32_t blockSize = DUMP_BLOCKSIZE,
+	                                 int16_t nrBlocks = DUMP_BLOCKS);
+			~dumpWriter	();
+	void		open		(FILE *);
+	void		open		(SNDFILE *);
+	void		open		(iqzWriter *);
+	void		close		();
+	bool		isOpen		();
+	int32_t		put		(const void *, int32_t);
+	int64_t		droppedBytes	();
+private:
+	void		run		();
+	void		prepare		();
+	void		start_writing	();
+	void		writeBlock	(int16_t);
+	int32_t		blockSize;
+	int16_t		nrBlocks;
+	std::vector<uint8_t>	blocks;
+	std::vector<int32_t>	blockFill;
+	RingBuffer<int16_t>	freeBlocks;
+	RingBuffer<int16_t>	fullBlocks;
+	QSemaphore	blocksReady;
+	QMutex		producerLock;
+	int16_t		currentBlock;
+	FILE		*theFile;
+	SNDFILE		*theSndFile;
+	iqzWriter	*theIqzFile;
+	int64_t		filePosition;
+	int64_t		reservedUpto;
+	std::atomic<bool>	active;
+	std::atomic<bool>	running;
+	std::atomic<int64_t>	dropped;
+};
+#endif
+
@@ -35,10 +35,14 @@
 #define FFTW_FREE		fftwf_free
 #define FFTW_PLAN		fftwf_plan
 #define FFTW_EXECUTE		fftwf_execute
+#define FFTW_EXECUTE_DFT	fftwf_execute_dft
 #include    <fftw3.h>
 
 /*
- *  a simple wrapper
+ *  a simple wrapper.
+ *  The plans are shared, there is one plan per size and direction
+ *  for all instances - also when running more than one
+ *  dabProcessor - each instance executes it on its own vector
  */
 
 class   fftHandler {
@@ -40,8 +40,10 @@ public:
 FILE	*findContentDump_fileName	(const QString &channel);
 FILE	*findFrameDump_fileName		(const QString &service);
 SNDFILE	*findAudioDump_fileName		(const QString &service);
-SNDFILE *findRawDump_fileName		(const QString &deviceName,
+const
+QString	findRawDump_fileName		(const QString &deviceName,
 	                                       const QString &channelName);
+SNDFILE	*open_rawDump			(const QString &fileName);
 FILE	*findScanDump_fileName		();
 FILE	*findSummary_fileName		();
 const 
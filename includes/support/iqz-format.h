@@ -0,0 +1,131 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__IQZ_FORMAT__
+#define	__IQZ_FORMAT__
+/*
+ *	The iqz format is a compressed format for (long) recordings
+ *	of 16 bit I/Q samples.
+ *	The samples are stored in chunks of a fixed number of
+ *	samples, 96 msec worth, i.e. the length of a Mode I frame.
+ *	The chunks are just slices of the sample stream, they are
+ *	not aligned to the null symbols of the signal.
+ *	Each chunk is compressed on its own, with a fixed predictor
+ *	(order 0, 1 or 2, as in FLAC) per component and Rice coding
+ *	of the residuals, so the compression is lossless and any
+ *	chunk can be decoded without the preceding ones.
+ *	All numbers are little endian.
+ *
+ *	header:	"QDABIQZ1"
+ *		uint32	headerSize	(i.e. offset of the first chunk)
+ *		uint32	sampleRate
+ *		uint32	frequency
+ *		uint16	nrBits		(significant bits per component)
+ *		uint32	chunkSize	(samples per chunk)
+ *		uint32	metaSize
+ *		metaSize bytes of metadata, "key=value" lines
+ *	chunk:	"IQZC"
+ *		uint32	nrSamples
+ *		uint32	payloadSize
+ *		uint8	order I, rice parameter I, order Q, rice parameter Q
+ *		the bitstream with the residuals, I and Q interleaved
+ *	index:	per chunk uint64 fileOffset, uint64 first sample
+ *	trailer: uint64	indexOffset
+ *		uint32	nrChunks
+ *		"QDABIDX1"
+ *
+ *	If the recording was not closed properly, the trailer is missing
+ *	and the reader rebuilds the index by walking over the chunks.
+ *	The (seek) index is keyed by sample offset, the frame starts
+ *	are not part of the format, the player (iqzFiles) builds a
+ *	frame index of its own (see frame-indexer.h). Note that
+ *	samples the dumpWriter had to drop are missing from the file,
+ *	the sample offset counts what is in the file, not time.
+ */
+#include	<QString>
+#include	<cstdio>
+#include	<cstdint>
+#include	<vector>
+
+#define	IQZ_MAGIC	"QDABIQZ1"
+#define	IQZ_INDEX_MAGIC	"QDABIDX1"
+#define	IQZ_CHUNK_MAGIC	"IQZC"
+#define	IQZ_CHUNKSIZE	196608		// 96 msec at 2048000
+
+class	iqzWriter {
+public:
+			iqzWriter	(const QString &fileName,
+	                                 int32_t sampleRate,
+	                                 int32_t frequency,
+	                                 int16_t nrBits,
+	                                 const QString &metaData);
+			~iqzWriter	();
+	void		add		(const int16_t *, int32_t);
+	void		close		();
+	int64_t		bytesWritten	();
+	int64_t		samplesWritten	();
+private:
+	void		writeChunk	();
+	FILE		*theFile;
+	int32_t		chunkSize;
+	std::vector<int16_t>	chunkBuffer;
+	int32_t		chunkFill;
+	std::vector<uint8_t>	payload;
+	std::vector<uint64_t>	chunkOffsets;
+	std::vector<uint64_t>	chunkSamples;
+	int64_t		fileOffset;
+	int64_t		nrSamples;
+};
+
+class	iqzReader {
+public:
+			iqzReader	(const QString &fileName);
+			~iqzReader	();
+	int32_t		sampleRate	();
+	int32_t		frequency	();
+	int16_t		nrBits		();
+	QString		metaData	();
+	QString		metaValue	(const QString &key);
+	int64_t		nrSamples	();
+	int32_t		nrChunks	();
+	int32_t		chunkFor	(int64_t sample);
+	int64_t		chunkStart	(int32_t chunk);
+	int32_t		readChunk	(int32_t chunk, std::vector<int16_t> &);
+private:
+	bool		readIndex	();
+	void		rebuildIndex	();
+	FILE		*theFile;
+	int32_t		theRate;
+	int32_t		theFrequency;
+	int16_t		bitsperComponent;
+	int32_t		chunkSize;
+	int64_t		headerSize;
+	int64_t		fileSize;
+	int64_t		totalSamples;
+	QString		theMetaData;
+	std::vector<uint64_t>	chunkOffsets;
+	std::vector<uint64_t>	chunkSamples;
+	std::vector<uint8_t>	payload;
+};
+#endif
+
@@ -0,0 +1,67 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#ifndef	__POLYPHASE_RESAMPLER__
+#define	__POLYPHASE_RESAMPLER__
+/*
+ *	A polyphase resampler, converting a stream of complex samples
+ *	with an (arbitrary) inRate into a stream with rate outRate.
+ *	The lowpass filter (cutoff at half the lowest of the two rates)
+ *	is split into NR_PHASES subfilters, the subfilter used for
+ *	an output sample is selected by the fractional part of its
+ *	position in the input stream.
+ *	The filter banks are computed once per pair of rates,
+ *	when the first resampler for that pair is created, and
+ *	shared by all resamplers with these rates.
+ */
+#include	<cstdint>
+#include	<vector>
+#include	"dab-constants.h"
+
+#define	PHASE_BITS	9
+#define	NR_PHASES	(1 << PHASE_BITS)
+
+class	filterBank;
+
+class	polyphaseResampler {
+public:
+			polyphaseResampler	(int32_t inRate,
+	                                         int32_t outRate);
+			~polyphaseResampler	();
+	int32_t		resample		(const std::complex<float> *,
+	                                         int32_t,
+	                                         std::complex<float> *);
+	int32_t		maxOutput		(int32_t);
+	void		reset			();
+	int16_t		get_tapsperPhase	();
+private:
+	int32_t		inRate;
+	int32_t		outRate;
+	int16_t		tapsperPhase;
+	uint64_t	step;		// input samples per output, 32.32
+	uint64_t	position;	// in the workBuffer, 32.32
+	const filterBank	*theBank;
+	std::vector<std::complex<float>> workBuffer;
+};
+#endif
+
@@ -5,6 +5,7 @@
 #include	<stdint.h>
 #include	<complex>
 #include	"ringbuffer.h"
+#include	"dab-metrics.h"
 
 class	processParams {
 public:
@@ -20,6 +21,8 @@ public:
 	RingBuffer<std::complex<float>> * iqBuffer;
 	RingBuffer<std::complex<float>> * tiiBuffer;
 	RingBuffer<uint8_t> *frameBuffer;
+//	when set, the statistics go here rather than being signalled
+	dabMetrics	*metrics	= nullptr;
 };
 
 #endif
@@ -0,0 +1,124 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	mp2Bench decodes a file with captured MP2 frames - e.g. an .mp2
+ *	file, or the output of a "frames:" sink of the daemon with
+ *	the frame headers stripped - a number of times and reports
+ *	the time per frame and the number of services that one core
+ *	could decode in real time.
+ *	It also prints a checksum over the decoded samples, builds
+ *	with and without the vectorized synthesis (see mp2-bench.pro)
+ *	should give the same checksum.
+ */
+#include	<cstdio>
+#include	<cstdlib>
+#include	<cstdint>
+#include	<chrono>
+#include	<vector>
+#include	"mp2-decoder.h"
+
+#define	FRAME_MSEC	24		// 1152 samples at 48000
+
+static
+void	usage	() {
+	fprintf (stderr, "Usage: mp2Bench file [repetitions]\n");
+	exit (1);
+}
+
+int	main (int argc, char **argv) {
+FILE	*f;
+std::vector<uint8_t>	data;
+std::vector<int32_t>	frames;
+int16_t	pcm [2 * KJMP2_SAMPLES_PER_FRAME];
+uint32_t checksum	= 2166136261u;	// FNV-1a
+int	repetitions;
+int	errors		= 0;
+
+	if (argc < 2)
+	   usage ();
+	repetitions	= argc > 2 ? atoi (argv [2]) : 10;
+	if (repetitions < 1)
+	   usage ();
+
+	f	= fopen (argv [1], "rb");
+	if (f == nullptr) {
+	   fprintf (stderr, "we could not open %s\n", argv [1]);
+	   exit (1);
+	}
+	uint8_t buffer [4096];
+	int n;
+	while ((n = fread (buffer, 1, sizeof (buffer), f)) > 0)
+	   data. insert (data. end (), buffer, buffer + n);
+	fclose (f);
+//
+//	find the frames, decodeFrame without output just
+//	checks the header and tells the length
+	mp2Decoder	scanner;
+	int32_t	pos	= 0;
+	while (pos + 4 <= (int32_t)data. size ()) {
+	   int32_t length = scanner. decodeFrame (&data [pos], nullptr);
+	   if ((length == 0) || (pos + length > (int32_t)data. size ())) {
+	      pos ++;
+	      continue;
+	   }
+	   frames. push_back (pos);
+	   pos	+= length;
+	}
+	if (frames. size () == 0) {
+	   fprintf (stderr, "no MP2 frames found in %s\n", argv [1]);
+	   exit (1);
+	}
+	fprintf (stderr, "%d frames, %d kbit/s, %d Hz, %s\n",
+	               (int)frames. size (),
+	               (int)((data. size () - frames [0]) * 8 /
+	                              (frames. size () * FRAME_MSEC)),
+	               mp2Decoder::sampleRate (&data [frames [0]]),
+	               scanner. isStereo () ? "stereo" : "mono");
+//
+//	the decoder is created anew for each repetition, the
+//	checksum is over the output of the first one
+	double	usecs	= 0;
+	for (int r = 0; r < repetitions; r ++) {
+	   mp2Decoder theDecoder;
+	   auto t0	= std::chrono::steady_clock::now ();
+	   for (int i = 0; i < (int)frames. size (); i ++) {
+	      if (theDecoder. decodeFrame (&data [frames [i]], pcm) == 0) {
+	         errors ++;
+	         continue;
+	      }
+	      if (r > 0)
+	         continue;
+	      const uint8_t *p = (const uint8_t *)pcm;
+	      for (int j = 0; j < (int)sizeof (pcm); j ++)
+	         checksum = (checksum ^ p [j]) * 16777619u;
+	   }
+	   usecs += std::chrono::duration<double, std::micro>
+	                    (std::chrono::steady_clock::now () - t0). count ();
+	}
+
+	double	perFrame	= usecs / (repetitions * frames. size ());
+	printf ("%.2f usec per frame, %.1f times real time, checksum %08x\n",
+	               perFrame, FRAME_MSEC * 1000 / perFrame, checksum);
+	if (errors > 0)
+	   printf ("%d frames could not be decoded\n", errors);
+	return 0;
+}
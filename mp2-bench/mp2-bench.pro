@@ -0,0 +1,32 @@
+#
+TEMPLATE    = app
+CONFIG      += console
+CONFIG      -= app_bundle qt
+
+INCLUDEPATH += . \
+	      ../includes/backend/audio
+
+HEADERS     = ../includes/backend/audio/mp2-decoder.h
+SOURCES     = ./main.cpp \
+	      ../src/backend/audio/mp2-decoder.cpp
+TARGET      = mp2Bench
+
+#	to measure (and check) the vectorized synthesis, add
+#	sse on x86_64 or neon on an ARM (neon is standard on aarch64)
+#CONFIG	+= sse
+#CONFIG	+= neon
+
+sse {
+DEFINES		+= SSE_AVAILABLE
+QMAKE_CXXFLAGS	+= -msse2
+}
+
+neon {
+DEFINES		+= NEON_AVAILABLE
+#	on a 32 bits ARM (e.g. an RPI 2) the fpu has to be set as well
+#QMAKE_CXXFLAGS	+= -mfloat-abi=hard -mfpu=neon-vfpv4
+}
+
+unix {
+DESTDIR     = ./linux-bin
+}
@@ -0,0 +1,250 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	resamplerBench compares, for a number of input rates, the
+ *	linear interpolation with mapTables - as the airspy, colibri and
+ *	elad handlers and the xml reader did before - with the
+ *	polyphaseResampler, converting to 2048000 S/s.
+ *	The input is an OFDM like signal: tones on a 1 KHz grid with
+ *	random phases, within the 1536 KHz of an ensemble, and as many
+ *	tones outside it, in the adjacent channels.
+ *	Both rates being multiples of 1000, everything the conversion
+ *	produces - the tones, aliases of the adjacent tones, errors of
+ *	the interpolation - is on the same 1 KHz grid. The MER is the
+ *	power in the bins of the in-band tones over the power in the
+ *	other bins of the ensemble. As with the equalization of the
+ *	OFDM decoder, a different gain per tone is no error.
+ *	The time per output sample is measured on the same input.
+ */
+#include	<cstdio>
+#include	<cstdlib>
+#include	<cmath>
+#include	<chrono>
+#include	<random>
+#include	<vector>
+#include	"polyphase-resampler.h"
+
+#define	OUT_RATE	2048000
+#define	IN_BAND_TONES	24
+#define	ADJACENT_TONES	48
+#define	SETTLE_MSEC	10		// the filter has to fill
+#define	MEASURE_MSEC	200
+//
+//	the interpolation as it was in the handlers, per msec of
+//	input samples (inRate / 1000 + 1, the last one of the previous
+//	msec first) 2048 output samples are computed
+class	linearInterpolator {
+public:
+			linearInterpolator	(int32_t inRate) {
+	   convBufferSize	= inRate / 1000;
+	   for (int i = 0; i < 2048; i ++) {
+	      float inVal	= float (inRate / 1000);
+	      mapTable_int [i]	= int (floor (i * (inVal / 2048.0)));
+	      mapTable_float [i]	= i * (inVal / 2048.0) - mapTable_int [i];
+	   }
+	   convIndex	= 0;
+	   convBuffer. resize (convBufferSize + 1);
+	}
+
+	int32_t		resample	(const std::complex<float> *in,
+	                                 int32_t n,
+	                                 std::complex<float> *out) {
+	int32_t	amount	= 0;
+	   for (int i = 0; i < n; i ++) {
+	      convBuffer [convIndex ++] = in [i];
+	      if (convIndex > convBufferSize) {
+	         for (int j = 0; j < 2048; j ++) {
+	            int16_t inpBase	= mapTable_int [j];
+	            float   inpRatio	= mapTable_float [j];
+	            out [amount ++] = convBuffer [inpBase + 1] * inpRatio +
+	                              convBuffer [inpBase] * (1 - inpRatio);
+	         }
+	         convBuffer [0] = convBuffer [convBufferSize];
+	         convIndex	= 1;
+	      }
+	   }
+	   return amount;
+	}
+private:
+	int16_t		mapTable_int	[2048];
+	float		mapTable_float	[2048];
+	std::vector<std::complex<float>> convBuffer;
+	int32_t		convBufferSize;
+	int32_t		convIndex;
+};
+
+class	tone {
+public:
+	int32_t	frequency;		// Hz, a multiple of 1000
+	double	phase;
+};
+
+static
+void	generate	(int32_t rate, const std::vector<tone> &tones,
+	                 int32_t n, std::vector<std::complex<float>> &out) {
+	out. assign (n, std::complex<float> (0, 0));
+	for (auto &t : tones) {
+	   std::complex<double> v	= std::polar (1.0, t. phase);
+	   std::complex<double> step	=
+	                   std::polar (1.0, 2 * M_PI * t. frequency / rate);
+	   for (int i = 0; i < n; i ++) {
+	      out [i] += std::complex<float> (v. real (), v. imag ());
+	      v *= step;
+	      if ((i & 1023) == 0)		// stay on the unit circle
+	         v /= abs (v);
+	   }
+	}
+}
+//
+//	All tones - and their aliases - are on the 1 KHz grid, i.e.
+//	on the bins of a 2048 point DFT at the output rate. Over a whole
+//	number of msecs, the DFT of the output in these bins is the DFT
+//	of the msecs added up. The bins of the in-band tones hold the
+//	signal, the other bins within the 1536 KHz of the ensemble
+//	the error
+static
+double	mer		(const std::complex<float> *out, int32_t n,
+	                 const std::vector<tone> &tones) {
+std::vector<std::complex<double>> folded (2048, 0);
+std::vector<bool> isTone (2048, false);
+double	signal	= 0;
+double	error	= 0;
+
+	for (int i = 0; i < n; i ++)
+	   folded [i % 2048] += std::complex<double> (out [i]. real (),
+	                                               out [i]. imag ());
+	for (auto &t : tones)
+	   isTone [(t. frequency / 1000 + 2048) % 2048] = true;
+	for (int k = -768; k <= 768; k ++) {
+	   std::complex<double> X (0, 0);
+	   for (int i = 0; i < 2048; i ++)
+	      X += folded [i] * std::polar (1.0, -2 * M_PI * k * i / 2048);
+	   if (isTone [(k + 2048) % 2048])
+	      signal += norm (X) / n;
+	   else
+	      error += norm (X) / n;
+	}
+	return 10 * log10 (signal / error);
+}
+//
+//	returns the time, in nsec, per output sample
+template <class converter>
+double	measure	(converter &c, const std::vector<std::complex<float>> &in,
+	                 int32_t inRate,
+	                 std::vector<std::complex<float>> &out,
+	                 int32_t *produced) {
+int32_t	block	= inRate / 1000;	// feed per msec, as a device would
+int32_t	amount	= 0;
+
+	out. resize (OUT_RATE / 1000 * (MEASURE_MSEC + SETTLE_MSEC + 2));
+	auto t0	= std::chrono::steady_clock::now ();
+	for (int i = 0; i + block <= (int)in. size (); i += block)
+	   amount += c. resample (&in [i], block, &out [amount]);
+	double nsecs = std::chrono::duration<double, std::nano>
+	                  (std::chrono::steady_clock::now () - t0). count ();
+	*produced	= amount;
+	return nsecs / amount;
+}
+
+int	main (int argc, char **argv) {
+std::vector<int32_t> rates;
+std::mt19937	gen (1);
+std::uniform_real_distribution<double> phase (0, 2 * M_PI);
+int	repetitions	= 5;
+
+	for (int i = 1; i < argc; i ++)
+	   rates. push_back (atoi (argv [i]));
+	if (rates. size () == 0)
+	   rates = {2500000, 3000000, 3072000, 6000000, 10000000};
+
+	printf ("   rate      linear              polyphase (%s)\n",
+#ifdef	SSE_AVAILABLE
+	                                              "sse");
+#else
+	                                              "plain");
+#endif
+	for (auto inRate : rates) {
+	   if ((inRate < 2 * 1000000) || (inRate % 1000 != 0)) {
+	      fprintf (stderr, "rate %d: should be a multiple of 1000 and at least 2000000\n",
+	                                                  inRate);
+	      continue;
+	   }
+//
+//	in-band tones between -760 and 760 KHz, the adjacent ones
+//	from 850 KHz up to (almost) the edge of the input band
+	   std::vector<tone> inBand;
+	   std::vector<tone> all;
+	   int32_t edge	= inRate / 2 - 20000;
+	   for (int i = 0; i < IN_BAND_TONES; i ++) {
+	      tone t;
+	      do {
+	         t. frequency = (int32_t)(gen () % 1521) * 1000 - 760000;
+	      } while (t. frequency == 0);
+	      t. phase	= phase (gen);
+	      inBand. push_back (t);
+	      all. push_back (t);
+	   }
+	   for (int i = 0; i < ADJACENT_TONES; i ++) {
+	      tone t;
+	      int32_t f	= 850000 +
+	                   (int32_t)(gen () % ((edge - 850000) / 1000)) * 1000;
+	      t. frequency	= i & 1 ? f : -f;
+	      t. phase	= phase (gen);
+	      all. push_back (t);
+	   }
+	   std::vector<std::complex<float>> in;
+	   generate (inRate, all, inRate / 1000 * (MEASURE_MSEC + SETTLE_MSEC),
+	                                                                 in);
+	   std::vector<std::complex<float>> out;
+	   int32_t produced;
+	   double linearTime	= 1e30;
+	   double polyTime	= 1e30;
+	   double linearMer	= 0;
+	   double polyMer	= 0;
+	   int32_t skip	= OUT_RATE / 1000 * SETTLE_MSEC;
+	   int32_t length	= OUT_RATE / 1000 * (MEASURE_MSEC - 2);	// whole msecs
+//
+//	the fastest of a few runs counts
+	   for (int r = 0; r < repetitions; r ++) {
+	      linearInterpolator lin (inRate);
+	      double t	= measure (lin, in, inRate, out, &produced);
+	      if (t < linearTime)
+	         linearTime = t;
+	      if (r == 0)
+	         linearMer = mer (&out [skip], length, inBand);
+
+	      polyphaseResampler poly (inRate, OUT_RATE);
+	      t	= measure (poly, in, inRate, out, &produced);
+	      if (t < polyTime)
+	         polyTime = t;
+	      if (r == 0)
+	         polyMer = mer (&out [skip], length, inBand);
+	   }
+	   printf ("%8.3f MS/s  %5.1f dB %6.1f ns   %5.1f dB %6.1f ns (%d taps)\n",
+	               inRate / 1e6, linearMer, linearTime,
+	               polyMer, polyTime,
+	               polyphaseResampler (inRate, OUT_RATE). get_tapsperPhase ());
+	}
+	printf ("time per output sample, %d output samples per second\n",
+	                                                        OUT_RATE);
+	return 0;
+}
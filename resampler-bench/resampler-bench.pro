@@ -0,0 +1,31 @@
+#
+TEMPLATE    = app
+CONFIG      += console
+CONFIG      -= app_bundle
+QT          += core
+QT          -= gui
+
+INCLUDEPATH += . \
+	      ../includes \
+	      ../includes/support
+
+HEADERS     = ../includes/support/polyphase-resampler.h
+SOURCES     = ./main.cpp \
+	      ../src/support/polyphase-resampler.cpp
+TARGET      = resamplerBench
+
+#	the resampler has an SSE dot product, to measure that one, add
+#CONFIG	+= sse
+
+sse {
+DEFINES		+= SSE_AVAILABLE
+QMAKE_CXXFLAGS	+= -msse2
+}
+
+win32 {
+DESTDIR     = ../windows-bin
+}
+
+unix {
+DESTDIR     = ./linux-bin
+}
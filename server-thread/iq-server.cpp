@@ -0,0 +1,291 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include	"iq-server.h"
+#include	<cstdio>
+#include	<cstring>
+#include	<cerrno>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<netinet/in.h>
+#include	<arpa/inet.h>
+#include	<poll.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+//
+//	The ring holds app 4 seconds of input (2048000 I/Q pairs
+//	per second), a client lagging more than half of it is dropped,
+//	the other half is the margin for the part being sent
+#define	RING_SIZE	(16 * 1024 * 1024)
+#define	MAX_LAG		(RING_SIZE / 2)
+#define	SEND_SIZE	(256 * 1024)
+//
+//	we present ourselves as an R820T tuner, with 29 gain settings,
+//	which is what most clients expect
+#define	TUNER_R820T	5
+#define	NR_GAINS	29
+
+class	iqClient {
+public:
+	int		id;
+	int		sock;
+	std::thread	threadHandle;
+	std::atomic<bool>	finished;
+	uint64_t	readPosition;
+	uint8_t		command [5];
+	int		commandFill;
+};
+
+	iqServer::iqServer	(int port) {
+	theRing. resize (RING_SIZE);
+	ringMask	= RING_SIZE - 1;
+	writePosition. store (0);
+	activeClients. store (0);
+	controller	= -1;
+	nextId		= 0;
+	socketDesc	= -1;
+	running. store (true);
+	threadHandle	= std::thread (&iqServer::run, this, port);
+}
+
+	iqServer::~iqServer	() {
+	running. store (false);
+	threadHandle. join ();
+}
+
+int	iqServer::nrClients	() {
+	return activeClients. load ();
+}
+//
+//	putSamples is called from the thread reading the device,
+//	it just stores the samples, converted back to the 8 bits
+//	unsigned format of the rtl_tcp protocol, and moves the
+//	write position
+void	iqServer::putSamples	(const std::complex<float> *v, int32_t n) {
+uint64_t pos	= writePosition. load (std::memory_order_relaxed);
+
+	if (activeClients. load () == 0)
+	   return;
+	for (int i = 0; i < n; i ++) {
+	   int re	= (int)(real (v [i]) * 128 + 128.5);
+	   int im	= (int)(imag (v [i]) * 128 + 128.5);
+	   theRing [(pos + 2 * i)     & ringMask] =
+	                         re < 0 ? 0 : re > 255 ? 255 : re;
+	   theRing [(pos + 2 * i + 1) & ringMask] =
+	                         im < 0 ? 0 : im > 255 ? 255 : im;
+	}
+	writePosition. store (pos + 2 * n, std::memory_order_release);
+}
+
+void	iqServer::run	(int port) {
+struct sockaddr_in server;
+int	one	= 1;
+
+	socketDesc = socket (AF_INET, SOCK_STREAM, 0);
+	if (socketDesc == -1) {
+	   fprintf (stderr, "iqServer: could not create socket\n");
+	   return;
+	}
+	setsockopt (socketDesc, SOL_SOCKET, SO_REUSEADDR, &one, sizeof (one));
+	server. sin_family	= AF_INET;
+	server. sin_addr. s_addr	= INADDR_ANY;
+	server. sin_port	= htons (port);
+	if (bind (socketDesc, (struct sockaddr *)&server, sizeof (server)) < 0) {
+	   perror ("iqServer: bind failed");
+	   close (socketDesc);
+	   return;
+	}
+	listen (socketDesc, 5);
+	fprintf (stderr, "iqServer: accepting connections on port %d\n", port);
+
+	while (running. load ()) {
+	   struct pollfd pfd;
+	   pfd. fd	= socketDesc;
+	   pfd. events	= POLLIN;
+	   pfd. revents	= 0;
+	   cleanUp (false);
+	   if (poll (&pfd, 1, 100) <= 0)
+	      continue;
+	   int sock = accept (socketDesc, nullptr, nullptr);
+	   if (sock < 0)
+	      continue;
+	   iqClient *client	= new iqClient;
+	   client -> sock	= sock;
+	   client -> finished. store (false);
+	   client -> commandFill	= 0;
+	   clientLocker. lock ();
+	   client -> id		= nextId ++;
+	   if (controller == -1)
+	      controller	= client -> id;
+	   theClients. push_back (client);
+	   clientLocker. unlock ();
+	   fprintf (stderr, "iqServer: client %d connected%s\n",
+	                     client -> id,
+	                     controller == client -> id ? " (in control)" : "");
+	   client -> threadHandle =
+	               std::thread (&iqServer::serveClient, this, client);
+	}
+	cleanUp (true);
+	close (socketDesc);
+}
+//
+//	the threads of the clients that left are joined here,
+//	at the end all clients are waited for
+void	iqServer::cleanUp	(bool all) {
+std::list<iqClient *> done;
+
+	clientLocker. lock ();
+	for (std::list<iqClient *>::iterator it = theClients. begin ();
+	     it != theClients. end (); ) {
+	   if (all || (*it) -> finished. load ()) {
+	      done. push_back (*it);
+	      it = theClients. erase (it);
+	   }
+	   else
+	      it ++;
+	}
+	clientLocker. unlock ();
+	for (iqClient *c: done) {
+	   c -> threadHandle. join ();
+	   delete c;
+	}
+}
+//
+//	if the controlling client leaves, the control passes to
+//	the client that is connected for the longest time
+void	iqServer::removeClient	(iqClient *client) {
+	clientLocker. lock ();
+	if (controller == client -> id) {
+	   controller	= -1;
+	   for (iqClient *c: theClients)
+	      if ((c != client) && !c -> finished. load ()) {
+	         controller = c -> id;
+	         break;
+	      }
+	}
+	client -> finished. store (true);
+	clientLocker. unlock ();
+}
+
+void	iqServer::serveClient	(iqClient *client) {
+uint8_t	header [12]	= {'R', 'T', 'L', '0',
+	                   0, 0, 0, TUNER_R820T,
+	                   0, 0, 0, NR_GAINS};
+
+	if (send (client -> sock, header, sizeof (header), MSG_NOSIGNAL) !=
+	                                                   sizeof (header)) {
+	   close (client -> sock);
+	   removeClient (client);
+	   return;
+	}
+	fcntl (client -> sock, F_SETFL,
+	             fcntl (client -> sock, F_GETFL, 0) | O_NONBLOCK);
+//
+//	a client starts with the samples arriving after it connected,
+//	activeClients is raised first, so none of these are missed
+	activeClients. fetch_add (1);
+	client -> readPosition	= writePosition. load ();
+
+	while (running. load ()) {
+	   uint64_t available = writePosition. load (std::memory_order_acquire) -
+	                                             client -> readPosition;
+	   if (available > MAX_LAG) {
+	      fprintf (stderr, "iqServer: client %d too slow, dropped\n",
+	                                               client -> id);
+	      break;
+	   }
+	   struct pollfd pfd;
+	   pfd. fd	= client -> sock;
+	   pfd. events	= POLLIN | (available > 0 ? POLLOUT : 0);
+	   pfd. revents	= 0;
+	   if (poll (&pfd, 1, available > 0 ? 100 : 5) < 0)
+	      break;
+	   if (pfd. revents & (POLLERR | POLLHUP | POLLNVAL))
+	      break;
+	   if (pfd. revents & POLLIN) {
+	      int n = recv (client -> sock,
+	                    &client -> command [client -> commandFill],
+	                    5 - client -> commandFill, 0);
+	      if (n == 0)		// client closed the connection
+	         break;
+	      if (n > 0) {
+	         client -> commandFill += n;
+	         if (client -> commandFill == 5) {
+	            handleCommand (client, client -> command);
+	            client -> commandFill = 0;
+	         }
+	      }
+	   }
+	   if ((pfd. revents & POLLOUT) && (available > 0)) {
+	      uint64_t offset	= client -> readPosition & ringMask;
+	      uint64_t amount	= available;
+	      if (amount > RING_SIZE - offset)
+	         amount = RING_SIZE - offset;
+	      if (amount > SEND_SIZE)
+	         amount = SEND_SIZE;
+	      ssize_t n = send (client -> sock, &theRing [offset], amount,
+	                                       MSG_NOSIGNAL | MSG_DONTWAIT);
+	      if (n > 0)
+	         client -> readPosition += n;
+	      else
+	      if ((n < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+	         break;
+	   }
+	}
+	activeClients. fetch_sub (1);
+	close (client -> sock);
+	fprintf (stderr, "iqServer: client %d disconnected\n", client -> id);
+	removeClient (client);
+}
+//
+//	commands are 5 bytes, a command byte and a 32 bit parameter,
+//	msb first. Only the controlling client may retune, the
+//	frequency is passed to the GUI, that selects the channel.
+//	There is no device independent gain control, and the
+//	rate is fixed, these commands are ignored
+void	iqServer::handleCommand	(iqClient *client, const uint8_t *cmd) {
+int32_t	param	= (cmd [1] << 24) | (cmd [2] << 16) | (cmd [3] << 8) | cmd [4];
+bool	inControl;
+
+	clientLocker. lock ();
+	inControl	= controller == client -> id;
+	clientLocker. unlock ();
+	switch (cmd [0]) {
+	   case 0x01:		// set frequency
+	      if (inControl)
+	         emit frequencyRequest (param);
+	      else
+	         fprintf (stderr, "iqServer: client %d not in control\n",
+	                                                  client -> id);
+	      break;
+
+	   case 0x02:		// set sample rate
+	      if (param != 2048000)
+	         fprintf (stderr, "iqServer: rate %d not supported\n", param);
+	      break;
+
+	   default:
+	      break;
+	}
+}
+
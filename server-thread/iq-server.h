@@ -0,0 +1,77 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	An rtl_tcp compatible server, making the input samples of
+ *	qt-dab available to other programs, e.g. a second qt-dab
+ *	with the rtl_tcp client as device.
+ *	The samples are stored - as 8 bit unsigned I/Q pairs - once,
+ *	in a large ring, each client has its own read position in that
+ *	ring, so there is no copying per client.
+ *	A client that does not keep up is disconnected, the writer
+ *	never waits for a client.
+ *	Only one client - the first one connected - controls the
+ *	tuning, commands from the others are ignored.
+ */
+
+#ifndef	__IQ_SERVER__
+#define	__IQ_SERVER__
+
+#include	<QObject>
+#include	<QMutex>
+#include	<stdint.h>
+#include	<complex>
+#include	<vector>
+#include	<list>
+#include	<thread>
+#include	<atomic>
+
+class	iqClient;
+
+class	iqServer: public QObject {
+Q_OBJECT
+public:
+		iqServer	(int port);
+		~iqServer	();
+	void	putSamples	(const std::complex<float> *, int32_t);
+	int	nrClients	();
+private:
+	void	run		(int port);
+	void	serveClient	(iqClient *);
+	void	handleCommand	(iqClient *, const uint8_t *);
+	void	removeClient	(iqClient *);
+	void	cleanUp		(bool all);
+	std::vector<uint8_t>	theRing;
+	uint64_t		ringMask;
+	std::atomic<uint64_t>	writePosition;
+	std::thread		threadHandle;
+	std::atomic<bool>	running;
+	std::atomic<int>	activeClients;
+	int			socketDesc;
+	QMutex			clientLocker;
+	std::list<iqClient *>	theClients;
+	int			controller;
+	int			nextId;
+signals:
+	void	frequencyRequest	(int);
+};
+#endif
+
@@ -0,0 +1,762 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifdef	__MINGW32__		// for WSAPoll
+#ifndef	_WIN32_WINNT
+#define	_WIN32_WINNT	0x0600
+#endif
+#endif
+#include	"stream-server.h"
+#include	<cstdio>
+#include	<cstring>
+#include	<cerrno>
+#ifdef	__MINGW32__
+#include	<winsock2.h>
+#include	<ws2tcpip.h>
+#else
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<sys/uio.h>
+#include	<netinet/in.h>
+#include	<arpa/inet.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+#ifdef	__linux__
+#include	<sys/epoll.h>
+#include	<sys/eventfd.h>
+#else
+#include	<poll.h>
+#endif
+#endif
+//
+//	a client is sent at most SEND_SIZE bytes in a row, so one
+//	client with a large backlog does not delay the others.
+//	A unit may not exceed an eighth of the ring, so the current
+//	unit of a client lagging more than half the ring is still
+//	in the ring.
+#define	SEND_SIZE	(64 * 1024)
+#define	MAX_EVENTS	64
+#define	INDEX_MARGIN	64
+
+#ifndef	MSG_NOSIGNAL		// macOS, SO_NOSIGPIPE is set instead
+#define	MSG_NOSIGNAL	0
+#endif
+//
+//	the little that differs between the socket APIs
+#ifdef	__MINGW32__
+typedef	int	socklen_t;
+static inline
+void	closeSocket	(int sock) {
+	closesocket (sock);
+}
+
+static inline
+bool	wouldBlock	() {
+	return WSAGetLastError () == WSAEWOULDBLOCK;
+}
+
+static inline
+void	setNonBlocking	(int sock) {
+u_long	one	= 1;
+	ioctlsocket (sock, FIONBIO, &one);
+}
+#else
+static inline
+void	closeSocket	(int sock) {
+	close (sock);
+}
+
+static inline
+bool	wouldBlock	() {
+	return (errno == EAGAIN) || (errno == EWOULDBLOCK);
+}
+
+static inline
+void	setNonBlocking	(int sock) {
+	fcntl (sock, F_SETFL, fcntl (sock, F_GETFL) | O_NONBLOCK);
+}
+#endif
+//
+//	one or two pieces - the second one for a part wrapping around
+//	the end of the ring - are sent in a single call
+static
+int64_t	sendPieces	(int sock, const uint8_t *p0, uint64_t n0,
+	                           const uint8_t *p1, uint64_t n1) {
+#ifdef	__MINGW32__
+WSABUF	pieces [2];
+DWORD	sent;
+
+	pieces [0]. buf	= (char *)p0;
+	pieces [0]. len	= n0;
+	pieces [1]. buf	= (char *)p1;
+	pieces [1]. len	= n1;
+	if (WSASend (sock, pieces, n1 > 0 ? 2 : 1,
+	                          &sent, 0, nullptr, nullptr) != 0)
+	   return -1;
+	return sent;
+#else
+struct iovec	pieces [2];
+struct msghdr	message;
+
+	pieces [0]. iov_base	= (void *)p0;
+	pieces [0]. iov_len	= n0;
+	pieces [1]. iov_base	= (void *)p1;
+	pieces [1]. iov_len	= n1;
+	memset (&message, 0, sizeof (message));
+	message. msg_iov	= pieces;
+	message. msg_iovlen	= n1 > 0 ? 2 : 1;
+	return sendmsg (sock, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+#endif
+}
+//
+//	what the wait for events reports, a null endpoint is the wakeup
+class	streamEvent {
+public:
+	streamEndpoint	*endpoint;
+	bool		readable;
+	bool		writable;
+	bool		failed;
+};
+
+class	streamClient: public streamEndpoint {
+public:
+	int		id;
+	streamChannel	*channel;
+	uint64_t	readPosition;
+	bool		blocked;
+	bool		movingAhead;
+	std::vector<uint8_t>	pending;
+	uint64_t	pendingOffset;
+	uint64_t	bytesSent;
+	uint64_t	bytesSkipped;
+};
+
+	streamChannel::streamChannel	(int port, int policy,
+	                                 int32_t ringSize) {
+int32_t	size	= 4096;
+
+	while (size < ringSize)
+	   size <<= 1;
+	theRing. resize (size);
+	ringMask		= size - 1;
+	writePosition. store (0);
+	unitCount. store (0);
+	activeClients. store (0);
+	this	-> portNumber	= port;
+	this	-> policy	= policy;
+	isListener		= true;
+	sock			= -1;
+	closing			= false;
+	closed			= false;
+}
+
+	streamChannel::~streamChannel	() {}
+
+int	streamChannel::nrClients	() {
+	return activeClients. load ();
+}
+
+int	streamChannel::port		() {
+	return portNumber;
+}
+
+uint64_t streamChannel::bytesWritten	() {
+	return writePosition. load ();
+}
+//
+//	putData is called from the producing thread, the data is
+//	stored, the unit is recorded and the server is woken up.
+//	Without clients nothing is stored, a client starts
+//	with the first unit after it connected.
+//	The result tells whether the unit was stored
+bool	streamChannel::putData	(const uint8_t *data, int32_t n) {
+uint64_t pos	= writePosition. load (std::memory_order_relaxed);
+uint64_t count	= unitCount. load (std::memory_order_relaxed);
+uint64_t offset	= pos & ringMask;
+uint64_t first	= theRing. size () - offset;
+
+	if ((activeClients. load () == 0) || (n <= 0))
+	   return false;
+	if ((uint64_t)n > theRing. size () / 8) {
+	   fprintf (stderr, "streamServer: unit of %d bytes too large for port %d\n",
+	                                             n, portNumber);
+	   return false;
+	}
+	if (first > (uint64_t)n)
+	   first = n;
+	memcpy (&theRing [offset], data, first);
+	memcpy (&theRing [0], &data [first], n - first);
+	unitStarts [count % UNIT_INDEX]. store (pos, std::memory_order_relaxed);
+	writePosition. store (pos + n, std::memory_order_release);
+	unitCount. store (count + 1, std::memory_order_release);
+	streamServer::sharedServer () -> wakeUp ();
+	return true;
+}
+//
+//	for a position in the ring, find the start of the next unit
+//	and the start of the most recent one. The index is read
+//	while the writer extends it, the oldest entries are avoided.
+//	A position older than the index - only with lots of
+//	small units - has no boundary we know of
+bool	streamChannel::findBoundary	(uint64_t pos,
+	                                 uint64_t *next, uint64_t *newest) {
+uint64_t count	= unitCount. load (std::memory_order_acquire);
+uint64_t low	= count > UNIT_INDEX - INDEX_MARGIN ?
+	                            count - (UNIT_INDEX - INDEX_MARGIN) : 0;
+uint64_t high	= count;
+
+	if (count < 2)
+	   return false;
+	*newest	= unitStarts [(count - 1) % UNIT_INDEX]. load ();
+	if ((pos < unitStarts [low % UNIT_INDEX]. load ()) ||
+	    (pos >= *newest))
+	   return false;
+//
+//	binary search for the first unit starting beyond pos
+	while (low + 1 < high) {
+	   uint64_t mid = (low + high) / 2;
+	   if (unitStarts [mid % UNIT_INDEX]. load () <= pos)
+	      low = mid;
+	   else
+	      high = mid;
+	}
+	*next	= unitStarts [low % UNIT_INDEX]. load () == pos ? pos :
+	                        unitStarts [high % UNIT_INDEX]. load ();
+	return true;
+}
+//
+//	There is one server, with one thread, for all streams
+streamServer	*streamServer::sharedServer	() {
+static streamServer	theServer;
+	return &theServer;
+}
+
+	streamServer::streamServer	() {
+	nextId		= 0;
+	running. store (false);
+#ifdef	__MINGW32__
+WSADATA	wsaData;
+	WSAStartup (MAKEWORD (2, 2), &wsaData);
+#endif
+#ifdef	__linux__
+struct epoll_event ev;
+
+	epollDesc	= epoll_create1 (0);
+	wakeupDesc	= eventfd (0, EFD_NONBLOCK);
+	if ((epollDesc < 0) || (wakeupDesc < 0)) {
+	   fprintf (stderr, "streamServer: no epoll/eventfd, no streaming\n");
+	   return;
+	}
+	ev. events	= EPOLLIN;
+	ev. data. ptr	= nullptr;
+	epoll_ctl (epollDesc, EPOLL_CTL_ADD, wakeupDesc, &ev);
+#else
+//
+//	without eventfd, the wakeup is a datagram socket on the
+//	loopback, connected to itself
+struct sockaddr_in address;
+socklen_t length	= sizeof (address);
+
+	epollDesc	= -1;
+	wakeupDesc	= socket (AF_INET, SOCK_DGRAM, 0);
+	memset (&address, 0, sizeof (address));
+	address. sin_family		= AF_INET;
+	address. sin_addr. s_addr	= htonl (INADDR_LOOPBACK);
+	address. sin_port		= 0;
+	if ((wakeupDesc < 0) ||
+	    (bind (wakeupDesc, (struct sockaddr *)&address,
+	                                       sizeof (address)) < 0) ||
+	    (getsockname (wakeupDesc,
+	                  (struct sockaddr *)&address, &length) < 0) ||
+	    (connect (wakeupDesc, (struct sockaddr *)&address,
+	                                       sizeof (address)) < 0)) {
+	   fprintf (stderr, "streamServer: no wakeup socket, no streaming\n");
+	   return;
+	}
+	setNonBlocking (wakeupDesc);
+#endif
+	running. store (true);
+	threadHandle	= std::thread (&streamServer::run, this);
+}
+
+	streamServer::~streamServer	() {
+	if (running. load ()) {
+	   running. store (false);
+	   wakeUp ();
+	   threadHandle. join ();
+	}
+	closeChannels (true);
+	if (wakeupDesc >= 0)
+	   closeSocket (wakeupDesc);
+	if (epollDesc >= 0)
+	   close (epollDesc);
+#ifdef	__MINGW32__
+	WSACleanup ();
+#endif
+}
+
+#ifdef	__linux__
+void	streamServer::wakeUp	() {
+uint64_t one	= 1;
+	if (write (wakeupDesc, &one, sizeof (one)) < 0)
+	   return;		// counter saturated, a wakeup is pending anyway
+}
+
+void	streamServer::clearWakeUp	() {
+uint64_t counter;
+	if (read (wakeupDesc, &counter, sizeof (counter)) < 0)
+	   return;
+}
+#else
+void	streamServer::wakeUp	() {
+char	one	= 1;
+	if (send (wakeupDesc, &one, 1, 0) < 0)
+	   return;		// socket full, a wakeup is pending anyway
+}
+
+void	streamServer::clearWakeUp	() {
+char	buffer [64];
+	while (recv (wakeupDesc, buffer, sizeof (buffer), 0) > 0)
+	   ;
+}
+#endif
+//
+//	With epoll the endpoints are registered, the listeners for
+//	new clients, the clients for input (i.e. a disconnect) and -
+//	when blocked - for output.
+//	With poll the list of sockets is built each round from the
+//	channels and their clients, so there is nothing to register
+#ifdef	__linux__
+void	streamServer::addWatch	(streamEndpoint *e) {
+struct epoll_event ev;
+
+	ev. events	= e -> isListener ? EPOLLIN : EPOLLIN | EPOLLRDHUP;
+	ev. data. ptr	= e;
+	epoll_ctl (epollDesc, EPOLL_CTL_ADD, e -> sock, &ev);
+}
+
+void	streamServer::removeWatch	(streamEndpoint *e) {
+	epoll_ctl (epollDesc, EPOLL_CTL_DEL, e -> sock, nullptr);
+}
+
+void	streamServer::watchOutput	(streamClient *client, bool b) {
+struct epoll_event ev;
+
+	ev. events		= EPOLLIN | EPOLLRDHUP | (b ? EPOLLOUT : 0);
+	ev. data. ptr		= client;
+	epoll_ctl (epollDesc, EPOLL_CTL_MOD, client -> sock, &ev);
+}
+//
+//	called without the locker held
+void	streamServer::waitEvents	(std::vector<streamEvent> &res,
+	                                 int timeout) {
+struct epoll_event events [MAX_EVENTS];
+
+	res. resize (0);
+	int n = epoll_wait (epollDesc, events, MAX_EVENTS, timeout);
+	for (int i = 0; i < n; i ++) {
+	   streamEvent e;
+	   e. endpoint	= (streamEndpoint *)(events [i]. data. ptr);
+	   e. readable	= (events [i]. events & (EPOLLIN | EPOLLRDHUP)) != 0;
+	   e. writable	= (events [i]. events & EPOLLOUT) != 0;
+	   e. failed	= (events [i]. events & (EPOLLERR | EPOLLHUP)) != 0;
+	   res. push_back (e);
+	}
+}
+#else
+void	streamServer::addWatch		(streamEndpoint *e) {
+	(void)e;
+}
+
+void	streamServer::removeWatch	(streamEndpoint *e) {
+	(void)e;
+}
+
+void	streamServer::watchOutput	(streamClient *client, bool b) {
+	(void)client;
+	(void)b;
+}
+//
+//	called without the locker held. The endpoints in the list stay
+//	valid until the events are handled, channels and clients are
+//	only deleted by this thread, after a round
+void	streamServer::waitEvents	(std::vector<streamEvent> &res,
+	                                 int timeout) {
+static std::vector<struct pollfd>	fds;
+static std::vector<streamEndpoint *>	endpoints;
+struct pollfd f;
+
+	fds. resize (0);
+	endpoints. resize (0);
+	f. fd		= wakeupDesc;
+	f. events	= POLLIN;
+	f. revents	= 0;
+	fds. push_back (f);
+	endpoints. push_back (nullptr);
+	locker. lock ();
+	for (streamChannel *channel: theChannels) {
+	   if (channel -> closing)
+	      continue;
+	   f. fd	= channel -> sock;
+	   f. events	= POLLIN;
+	   fds. push_back (f);
+	   endpoints. push_back (channel);
+	   for (streamClient *client: channel -> theClients) {
+	      f. fd	= client -> sock;
+	      f. events	= POLLIN | (client -> blocked ? POLLOUT : 0);
+	      fds. push_back (f);
+	      endpoints. push_back (client);
+	   }
+	}
+	locker. unlock ();
+	res. resize (0);
+#ifdef	__MINGW32__
+	int n = WSAPoll (fds. data (), fds. size (), timeout);
+#else
+	int n = poll (fds. data (), fds. size (), timeout);
+#endif
+	for (int i = 0; (n > 0) && (i < (int)fds. size ()); i ++) {
+	   if (fds [i]. revents == 0)
+	      continue;
+	   streamEvent e;
+	   e. endpoint	= endpoints [i];
+	   e. readable	= (fds [i]. revents & POLLIN) != 0;
+	   e. writable	= (fds [i]. revents & POLLOUT) != 0;
+	   e. failed	= (fds [i]. revents &
+	                          (POLLERR | POLLHUP | POLLNVAL)) != 0;
+	   res. push_back (e);
+	   n --;
+	}
+}
+#endif
+//
+//	the listening socket is made here, so a port in use is
+//	reported to the caller, the clients are handled in the thread
+streamChannel	*streamServer::openStream	(int port, int policy,
+	                                         int32_t ringSize) {
+struct sockaddr_in server;
+int	one	= 1;
+
+	if (!running. load ())
+	   return nullptr;
+	int sock = socket (AF_INET, SOCK_STREAM, 0);
+	if (sock < 0) {
+	   fprintf (stderr, "streamServer: could not create socket\n");
+	   return nullptr;
+	}
+	setNonBlocking (sock);
+	setsockopt (sock, SOL_SOCKET, SO_REUSEADDR,
+	                            (const char *)&one, sizeof (one));
+	memset (&server, 0, sizeof (server));
+	server. sin_family	= AF_INET;
+	server. sin_addr. s_addr	= INADDR_ANY;
+	server. sin_port	= htons (port);
+	if ((bind (sock, (struct sockaddr *)&server, sizeof (server)) < 0) ||
+	    (listen (sock, 64) < 0)) {
+	   perror ("streamServer: bind failed");
+	   closeSocket (sock);
+	   return nullptr;
+	}
+	streamChannel *channel	= new streamChannel (port, policy, ringSize);
+	channel -> sock		= sock;
+	locker. lock ();
+	theChannels. push_back (channel);
+	addWatch (channel);
+	locker. unlock ();
+	wakeUp ();		// with poll, the list of sockets changed
+	fprintf (stderr, "streamServer: accepting connections on port %d\n", port);
+	return channel;
+}
+//
+//	The channel, its listener and its clients are removed by
+//	the server thread, in between two rounds of events,
+//	here we wait until that is done
+void	streamServer::closeStream	(streamChannel *channel) {
+	if (channel == nullptr)
+	   return;
+	locker. lock ();
+	channel -> closing	= true;
+	if (running. load ()) {
+	   wakeUp ();
+	   while (!channel -> closed)
+	      channelClosed. wait (&locker);
+	}
+	else
+	   closeChannels (false);
+	locker. unlock ();
+	delete channel;
+}
+//
+//	called with the locker held, or from the destructor
+void	streamServer::closeChannels	(bool all) {
+	for (std::list<streamChannel *>::iterator it = theChannels. begin ();
+	     it != theChannels. end (); ) {
+	   streamChannel *channel = *it;
+	   if (!all && !channel -> closing) {
+	      it ++;
+	      continue;
+	   }
+	   while (channel -> theClients. size () > 0)
+	      dropClient (channel -> theClients. front (), nullptr);
+	   removeWatch (channel);
+	   closeSocket (channel -> sock);
+	   channel -> closed	= true;
+	   it = theChannels. erase (it);
+	}
+	for (streamClient *c: droppedClients)
+	   delete c;
+	droppedClients. clear ();
+	channelClosed. wakeAll ();
+}
+
+void	streamServer::run	() {
+std::vector<streamEvent> events;
+bool	more	= false;
+
+	while (running. load ()) {
+//	with clients still having a backlog we do not wait
+	   waitEvents (events, more ? 0 : 100);
+	   locker. lock ();
+	   for (streamEvent &ev: events) {
+	      streamEndpoint *e = ev. endpoint;
+	      if (e == nullptr)
+	         clearWakeUp ();
+	      else
+	      if (e -> isListener) {
+	         if (!((streamChannel *)e) -> closing)
+	            acceptClients ((streamChannel *)e);
+	      }
+	      else {
+	         streamClient *client = (streamClient *)e;
+	         if (client -> channel == nullptr)	// dropped already
+	            continue;
+	         if (ev. failed)
+	            dropClient (client, "disconnected");
+	         else {
+	            if (ev. writable)
+	               setWritable (client, true);
+	            if (ev. readable)
+	               readClient (client);
+	         }
+	      }
+	   }
+//
+//	a round over all clients, each one is sent what it can take
+	   more	= false;
+	   for (streamChannel *channel: theChannels) {
+	      std::list<streamClient *>::iterator it =
+	                                 channel -> theClients. begin ();
+	      while (it != channel -> theClients. end ()) {
+	         streamClient *client = *it ++;	// it may be dropped
+	         if (serveClient (client))
+	            more = true;
+	      }
+	   }
+	   closeChannels (false);
+	   locker. unlock ();
+	}
+}
+
+void	streamServer::acceptClients	(streamChannel *channel) {
+	while (true) {
+#ifdef	__linux__
+	   int sock = accept4 (channel -> sock, nullptr, nullptr,
+	                                         SOCK_NONBLOCK);
+	   if (sock < 0)
+	      return;
+#else
+	   int sock = accept (channel -> sock, nullptr, nullptr);
+	   if (sock < 0)
+	      return;
+	   setNonBlocking (sock);
+#ifdef	SO_NOSIGPIPE
+int	one	= 1;
+	   setsockopt (sock, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof (one));
+#endif
+#endif
+	   streamClient *client	= new streamClient;
+	   client -> isListener	= false;
+	   client -> sock	= sock;
+	   client -> id		= nextId ++;
+	   client -> channel	= channel;
+	   client -> blocked	= false;
+	   client -> movingAhead	= false;
+	   client -> pendingOffset	= 0;
+	   client -> bytesSent	= 0;
+	   client -> bytesSkipped	= 0;
+//	activeClients is raised first, so no unit after this is missed
+	   channel -> activeClients. fetch_add (1);
+	   client -> readPosition	= channel -> writePosition. load ();
+	   channel -> theClients. push_back (client);
+	   addWatch (client);
+	   fprintf (stderr, "streamServer: client %d connected to port %d (%d clients)\n",
+	                      client -> id, channel -> portNumber,
+	                      channel -> activeClients. load ());
+	}
+}
+//
+//	clients are not supposed to talk, what they send is discarded
+void	streamServer::readClient	(streamClient *client) {
+uint8_t	buffer [1024];
+
+	while (true) {
+	   int n = recv (client -> sock, (char *)buffer, sizeof (buffer), 0);
+	   if (n == 0) {
+	      dropClient (client, "disconnected");
+	      return;
+	   }
+	   if (n < 0) {
+	      if (!wouldBlock ())
+	         dropClient (client, "disconnected");
+	      return;
+	   }
+	}
+}
+//
+//	a blocked client is waited for until its socket is writable
+void	streamServer::setWritable	(streamClient *client, bool b) {
+	client -> blocked	= !b;
+	watchOutput (client, !b);
+}
+//
+//	the client is deleted after the round, it may still
+//	be referred to by an event of this round
+void	streamServer::dropClient	(streamClient *client,
+	                                 const char *reason) {
+streamChannel *channel	= client -> channel;
+
+	if (reason != nullptr)
+	   fprintf (stderr, "streamServer: client %d of port %d %s, %llu bytes sent, %llu skipped\n",
+	                     client -> id, channel -> portNumber, reason,
+	                     (unsigned long long)client -> bytesSent,
+	                     (unsigned long long)client -> bytesSkipped);
+	removeWatch (client);
+	closeSocket (client -> sock);
+	channel -> theClients. remove (client);
+	channel -> activeClients. fetch_sub (1);
+	client -> channel	= nullptr;
+	droppedClients. push_back (client);
+}
+//
+//	A client lagging more than half the ring - blocked or not -
+//	is dropped, or, moving ahead, the rest of its current unit
+//	is saved, the ring part of it may be overwritten before the
+//	client gets to it
+bool	streamServer::moveAhead	(streamClient *client, uint64_t w) {
+streamChannel *channel	= client -> channel;
+uint64_t ringSize	= channel -> theRing. size ();
+uint64_t next, newest;
+
+	if ((channel -> policy == SLOW_CLIENT_DROP) ||
+	    (w - client -> readPosition > ringSize - ringSize / 8) ||
+	    !channel -> findBoundary (client -> readPosition, &next, &newest)) {
+	   dropClient (client, "too slow, dropped");
+	   return false;
+	}
+	client -> pending. resize (next - client -> readPosition);
+	for (uint64_t i = 0; i < client -> pending. size (); i ++)
+	   client -> pending [i] =
+	       channel -> theRing [(client -> readPosition + i) & channel -> ringMask];
+	client -> pendingOffset	= 0;
+	client -> readPosition	= next;
+	client -> movingAhead	= true;
+	return true;
+}
+//
+//	with the unit completed, the client continues with the
+//	most recent unit. The write position is read after the unit
+//	count, so it covers that unit
+bool	streamServer::sendPending	(streamClient *client) {
+streamChannel *channel	= client -> channel;
+
+	if (client -> pendingOffset < client -> pending. size ()) {
+	   int64_t n = sendPieces (client -> sock,
+	                     &client -> pending [client -> pendingOffset],
+	                     client -> pending. size () - client -> pendingOffset,
+	                     nullptr, 0);
+	   if ((n < 0) && !wouldBlock ()) {
+	      dropClient (client, "disconnected");
+	      return false;
+	   }
+	   if (n > 0) {
+	      client -> pendingOffset	+= n;
+	      client -> bytesSent	+= n;
+	   }
+	   if (client -> pendingOffset < client -> pending. size ()) {
+	      setWritable (client, false);
+	      return false;
+	   }
+	}
+	uint64_t count	= channel -> unitCount. load (std::memory_order_acquire);
+	uint64_t newest	= channel -> unitStarts [(count - 1) % UNIT_INDEX]. load ();
+	client -> bytesSkipped	+= newest - client -> readPosition;
+	client -> readPosition	= newest;
+	client -> movingAhead	= false;
+	client -> pending. clear ();
+	return channel -> writePosition. load (std::memory_order_acquire) > newest;
+}
+//
+//	returns true if the client has data left after this round
+bool	streamServer::serveClient	(streamClient *client) {
+streamChannel *channel	= client -> channel;
+uint64_t w	= channel -> writePosition. load (std::memory_order_acquire);
+uint64_t ringSize	= channel -> theRing. size ();
+
+	if (!client -> movingAhead &&
+	    (w - client -> readPosition > ringSize / 2) &&
+	    !moveAhead (client, w))
+	   return false;
+	if (client -> blocked)
+	   return false;
+	if (client -> movingAhead)
+	   return sendPending (client);
+	uint64_t available	= w - client -> readPosition;
+	if (available == 0)
+	   return false;
+	if (available > SEND_SIZE)
+	   available = SEND_SIZE;
+//
+//	the part to send is passed as one or - wrapping around
+//	the end of the ring - two pieces, straight from the ring
+	uint64_t offset	= client -> readPosition & channel -> ringMask;
+	uint64_t first	= ringSize - offset;
+	if (first > available)
+	   first = available;
+	int64_t n = sendPieces (client -> sock,
+	                        &channel -> theRing [offset], first,
+	                        &channel -> theRing [0], available - first);
+	if (n < 0) {
+	   if (wouldBlock ())
+	      setWritable (client, false);
+	   else
+	      dropClient (client, "disconnected");
+	   return false;
+	}
+	client -> readPosition	+= n;
+	client -> bytesSent	+= n;
+	if ((uint64_t)n < available) {		// the socket is full
+	   setWritable (client, false);
+	   return false;
+	}
+	return w - client -> readPosition > 0;
+}
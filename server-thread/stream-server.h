@@ -0,0 +1,133 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ *	A streaming server for any number of streams - pcm audio,
+ *	audio frames, data - and any number of clients per stream,
+ *	served by a single thread waiting with epoll.
+ *	The data of a stream is stored once, in a ring, each client
+ *	has its own read position in that ring and is sent its part
+ *	directly from the ring, a part wrapping around the end of the
+ *	ring as two pieces of a single sendmsg.
+ *	Writers never wait: a client that cannot take the data now is
+ *	not written to until its socket is writable again, a client
+ *	lagging more than half the ring is - depending on the policy
+ *	of the stream - disconnected or moved ahead to the most recent
+ *	data. The data passed in one putData call is a unit (a block of
+ *	samples, a frame), a client moved ahead first completes the unit
+ *	it was sending and continues with the most recent unit, so
+ *	its stream stays consistent.
+ *	On Linux the thread waits with epoll, elsewhere (macOS, Windows)
+ *	with poll, on a list of the sockets built each round.
+ */
+
+#ifndef	__STREAM_SERVER__
+#define	__STREAM_SERVER__
+
+#include	<QMutex>
+#include	<QWaitCondition>
+#include	<stdint.h>
+#include	<vector>
+#include	<list>
+#include	<thread>
+#include	<atomic>
+
+#define	SLOW_CLIENT_DROP	0
+#define	SLOW_CLIENT_SKIP	1
+//
+//	the start positions of the most recent units are kept,
+//	to find the unit boundaries for clients moving ahead
+#define	UNIT_INDEX		4096
+
+class	streamServer;
+class	streamClient;
+class	streamEvent;
+
+class	streamEndpoint {
+public:
+	bool	isListener;
+	int	sock;
+};
+
+class	streamChannel: public streamEndpoint {
+public:
+	bool	putData		(const uint8_t *, int32_t);
+	int	nrClients	();
+	int	port		();
+	uint64_t	bytesWritten	();
+private:
+	friend class	streamServer;
+			streamChannel	(int port, int policy, int32_t ringSize);
+			~streamChannel	();
+	bool		findBoundary	(uint64_t pos,
+	                                 uint64_t *next, uint64_t *newest);
+	std::vector<uint8_t>	theRing;
+	uint64_t		ringMask;
+	std::atomic<uint64_t>	writePosition;
+	std::atomic<uint64_t>	unitStarts [UNIT_INDEX];
+	std::atomic<uint64_t>	unitCount;
+	std::atomic<int>	activeClients;
+	int			portNumber;
+	int			policy;
+	bool			closing;
+	bool			closed;
+	std::list<streamClient *>	theClients;
+};
+
+class	streamServer {
+public:
+	static streamServer	*sharedServer	();
+	streamChannel	*openStream	(int port,
+	                                 int policy	= SLOW_CLIENT_SKIP,
+	                                 int32_t ringSize = 1024 * 1024);
+	void		closeStream	(streamChannel *);
+private:
+			streamServer	();
+			~streamServer	();
+	void		run		();
+	void		wakeUp		();
+	void		acceptClients	(streamChannel *);
+	void		readClient	(streamClient *);
+	bool		serveClient	(streamClient *);
+	bool		moveAhead	(streamClient *, uint64_t);
+	bool		sendPending	(streamClient *);
+	void		setWritable	(streamClient *, bool);
+	void		dropClient	(streamClient *, const char *);
+	void		closeChannels	(bool all);
+	void		clearWakeUp	();
+	void		addWatch	(streamEndpoint *);
+	void		removeWatch	(streamEndpoint *);
+	void		watchOutput	(streamClient *, bool);
+	void		waitEvents	(std::vector<streamEvent> &, int);
+	int			epollDesc;	// Linux only
+	int			wakeupDesc;
+	std::thread		threadHandle;
+	std::atomic<bool>	running;
+	QMutex			locker;
+	QWaitCondition		channelClosed;
+	std::list<streamChannel *>	theChannels;
+	std::list<streamClient *>	droppedClients;
+	int			nextId;
+	friend class	streamChannel;
+};
+#endif
+
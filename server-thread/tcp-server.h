@@ -19,34 +19,24 @@
  *    along with Qt-DAB; if not, write to the Free Software
  *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
- *	Simple streaming server, for e.g. epg data and tpg data
+ *	Simple streaming server, for e.g. epg data and tpg data,
+ *	any number of clients is served by the stream server,
+ *	each packet passed with sendData is a unit
  */
 
 #ifndef	__TCP_SERVER__
 #define	__TCP_SERVER__
 
 #include	<stdint.h>
-#include	<ringbuffer.h>
-#include	<sys/types.h>
-#include	<sys/socket.h>
-#include	<netdb.h>
-#include	<string>
-#include	<thread>
-#include	<unistd.h>
-#include	<atomic>
+#include	"stream-server.h"
 
 class	tcpServer {
 public:
-		tcpServer	(int);
-		~tcpServer	(void);
+		tcpServer	(int port, int policy = SLOW_CLIENT_SKIP);
+		~tcpServer	();
 	void	sendData	(uint8_t *, int32_t);
-	void	run		(int port);
 private:
-	std::thread	threadHandle;
-	RingBuffer<uint8_t> 	*buffer;
-	std::atomic<bool>	running;
-	std::atomic<bool>	connected;
-	int			socketDesc;
+	streamChannel	*theStream;
 };
 #endif
 
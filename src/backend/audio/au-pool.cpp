@@ -0,0 +1,107 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include	"au-pool.h"
+
+	auBuffer::auBuffer	(auPool *owner) {
+	this	-> owner	= owner;
+	auLength		= 0;
+	latmLength		= 0;
+	refCount. store (0);
+}
+
+	auBuffer::~auBuffer	() {
+}
+
+void	auBuffer::addRef	() {
+	refCount. fetch_add (1, std::memory_order_relaxed);
+}
+//
+//	the one releasing the last reference returns the buffer,
+//	the acq_rel makes the writes of the other users visible
+//	to the next one getting the buffer
+void	auBuffer::release	() {
+	if (refCount. fetch_sub (1, std::memory_order_acq_rel) == 1)
+	   owner -> putBuffer (this);
+}
+//
+//	There is one pool, a buffer may be released by another thread,
+//	or after the processor that filled it was deleted
+auPool	*auPool::sharedPool	() {
+static auPool	thePool;
+	return &thePool;
+}
+
+	auPool::auPool	() {
+	allocCount. store (0);
+	requestCount. store (0);
+	usedCount. store (0);
+	freeList. reserve (64);
+}
+
+	auPool::~auPool	() {
+	for (auBuffer *b: freeList)
+	   delete b;
+}
+//
+//	a fresh buffer has one reference, the one of the caller
+auBuffer	*auPool::getBuffer	() {
+auBuffer	*b	= nullptr;
+
+	requestCount. fetch_add (1);
+	locker. lock ();
+	if (freeList. size () > 0) {
+	   b	= freeList. back ();
+	   freeList. pop_back ();
+	}
+	locker. unlock ();
+	if (b == nullptr) {
+	   b	= new auBuffer (this);
+	   allocCount. fetch_add (1);
+	}
+	usedCount. fetch_add (1);
+	b -> auLength	= 0;
+	b -> latmLength	= 0;
+	b -> refCount. store (1, std::memory_order_relaxed);
+	return b;
+}
+
+void	auPool::putBuffer	(auBuffer *b) {
+	usedCount. fetch_sub (1);
+	locker. lock ();
+	freeList. push_back (b);
+	locker. unlock ();
+}
+
+uint32_t	auPool::allocations	() {
+	return allocCount. load ();
+}
+
+uint32_t	auPool::requests	() {
+	return requestCount. load ();
+}
+
+int32_t	auPool::inUse		() {
+	return usedCount. load ();
+}
+
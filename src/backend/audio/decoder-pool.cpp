@@ -0,0 +1,211 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include	"decoder-pool.h"
+#include	<cstdio>
+#include	<chrono>
+
+static inline
+int64_t	currentTime	() {		// in usec
+	return std::chrono::duration_cast<std::chrono::microseconds>
+	         (std::chrono::steady_clock::now (). time_since_epoch ()).
+	                                                            count ();
+}
+
+	decodeChannel::decodeChannel	(decodeClient *client,
+	                                 const QString &name,
+	                                 dabMetrics *metrics) {
+	this	-> client	= client;
+	this	-> name		= name;
+	this	-> metrics	= metrics;
+	thePool			= decoderPool::sharedPool ();
+	scheduled		= false;
+	busy			= false;
+	for (int i = 0; i < LATENCY_BUCKETS; i ++)
+	   histogram [i]. store (0);
+	droppedFrames. store (0);
+}
+//
+//	the queued frames are dropped, a frame being decoded is
+//	waited for, after that the client may be deleted
+	decodeChannel::~decodeChannel	() {
+uint32_t h [LATENCY_BUCKETS];
+
+	thePool	-> detach (this);
+	latencies (h);
+	fprintf (stderr, "%s: decoding latency (msec) <1:%u <2:%u <5:%u <10:%u <20:%u <50:%u <100:%u <200:%u >=200:%u, dropped %u\n",
+	         name. toLatin1 (). data (),
+	         h [0], h [1], h [2], h [3], h [4], h [5], h [6], h [7], h [8],
+	         droppedFrames. load ());
+}
+//
+//	the channel takes over the reference to the frame, also
+//	when the frame is dropped
+bool	decodeChannel::submit	(auBuffer *frame) {
+	if (thePool -> submit (this, frame))
+	   return true;
+	droppedFrames. fetch_add (1);
+	if (metrics != nullptr)
+	   metrics -> decodeDropped. fetch_add (1);
+	frame -> release ();
+	return false;
+}
+
+void	decodeChannel::latencies	(uint32_t *h) {
+	for (int i = 0; i < LATENCY_BUCKETS; i ++)
+	   h [i] = histogram [i]. load ();
+}
+
+uint32_t decodeChannel::dropped	() {
+	return droppedFrames. load ();
+}
+
+void	decodeChannel::record	(int64_t usec) {
+int	bucket	= 0;
+	while ((bucket < LATENCY_BUCKETS - 1) &&
+	       (usec >= latencyLimits [bucket] * 1000))
+	   bucket ++;
+	histogram [bucket]. fetch_add (1, std::memory_order_relaxed);
+	if (metrics != nullptr)
+	   metrics -> decodeLatency [bucket].
+	                        fetch_add (1, std::memory_order_relaxed);
+}
+
+	decodeWorker::decodeWorker	(decoderPool *thePool) {
+	this	-> thePool	= thePool;
+	start ();
+}
+
+	decodeWorker::~decodeWorker	() {
+	wait ();
+}
+
+void	decodeWorker::run	() {
+	while (thePool -> work ())
+	   ;
+}
+//
+//	A few workers, a decoder takes a few msec for a frame, the
+//	number of services is limited
+decoderPool	*decoderPool::sharedPool	() {
+static decoderPool	thePool;
+	return &thePool;
+}
+
+	decoderPool::decoderPool	() {
+int	nrWorkers	= QThread::idealThreadCount () / 2;
+
+	if (nrWorkers < 1)
+	   nrWorkers = 1;
+	if (nrWorkers > 4)
+	   nrWorkers = 4;
+	running	= true;
+	for (int i = 0; i < nrWorkers; i ++)
+	   workers. push_back (new decodeWorker (this));
+}
+
+	decoderPool::~decoderPool	() {
+	locker. lock ();
+	running	= false;
+	workAvailable. wakeAll ();
+	locker. unlock ();
+	for (decodeWorker *w: workers)
+	   delete w;
+}
+//
+//	a channel with work is on the readyList, unless it is
+//	being decoded, then it is put back by the worker
+bool	decoderPool::submit	(decodeChannel *c, auBuffer *frame) {
+decodeChannel::pendingFrame f;
+
+	locker. lock ();
+	if (c -> pending. size () >= CHANNEL_QUEUE) {
+	   locker. unlock ();
+	   return false;
+	}
+	f. frame	= frame;
+	f. submitTime	= currentTime ();
+	c -> pending. push_back (f);
+	if (!c -> scheduled) {
+	   c -> scheduled	= true;
+	   readyList. push_back (c);
+	   workAvailable. wakeOne ();
+	}
+	locker. unlock ();
+	return true;
+}
+
+void	decoderPool::detach	(decodeChannel *c) {
+	locker. lock ();
+	for (std::deque<decodeChannel *>::iterator it = readyList. begin ();
+	     it != readyList. end (); it ++)
+	   if (*it == c) {
+	      readyList. erase (it);
+	      break;
+	   }
+	for (decodeChannel::pendingFrame &f: c -> pending)
+	   f. frame -> release ();
+	c -> pending. clear ();
+	while (c -> busy)
+	   channelIdle. wait (&locker);
+	c -> scheduled	= false;
+	locker. unlock ();
+}
+//
+//	one frame of one channel is decoded per call, other
+//	channels get their turn in between
+bool	decoderPool::work	() {
+decodeChannel	*c;
+decodeChannel::pendingFrame f;
+
+	locker. lock ();
+	while (running && readyList. empty ())
+	   workAvailable. wait (&locker);
+	if (!running) {
+	   locker. unlock ();
+	   return false;
+	}
+	c	= readyList. front ();
+	readyList. pop_front ();
+	f	= c -> pending. front ();
+	c -> pending. pop_front ();
+	c -> busy	= true;
+	locker. unlock ();
+
+	c -> client -> decodeFrame (f. frame);
+	f. frame -> release ();
+	c -> record (currentTime () - f. submitTime);
+
+	locker. lock ();
+	c -> busy	= false;
+	if (c -> pending. size () > 0) {
+	   readyList. push_back (c);
+	   workAvailable. wakeOne ();
+	}
+	else
+	   c -> scheduled = false;
+	channelIdle. wakeAll ();
+	locker. unlock ();
+	return true;
+}
+
@@ -25,8 +25,10 @@
 #include        "radio.h"
 
         faadDecoder::faadDecoder        (RadioInterface *mr,
-                                         RingBuffer<int16_t> *buffer) {
+                                         RingBuffer<int16_t> *buffer,
+	                                 audioRoute *route) {
         this    -> audioBuffer  = buffer;
+	this	-> route	= route;
         aacCap          = NeAACDecGetCapabilities();
         aacHandle       = NeAACDecOpen();
         aacConf         = NeAACDecGetCurrentConfiguration (aacHandle);
@@ -145,21 +147,32 @@ uint8_t channels;
 	}
 
         if (channels == 2) {
-           audioBuffer  -> putDataIntoBuffer (outBuffer, samples);
-	   if (audioBuffer -> GetRingBufferReadAvailable() > (int)sampleRate / 8)
-              newAudio (sampleRate / 10, sampleRate);
+	   if (route != nullptr)
+	      route -> putSamples (outBuffer, samples / 2, sampleRate);
+	   else {
+              audioBuffer  -> putDataIntoBuffer (outBuffer, samples);
+	      if (audioBuffer -> GetRingBufferReadAvailable() >
+	                                          (int)sampleRate / 8)
+                 newAudio (sampleRate / 10, sampleRate);
+	   }
         }
         else
         if (channels == 1) {
-           int16_t *buffer = (int16_t *)alloca (2 * samples);
+//	mono: samples frames are made, of two int16's each
+           int16_t *buffer = (int16_t *)alloca (4 * samples);
            int16_t i;
            for (i = 0; i < samples; i ++) {
               buffer [2 * i]    = ((int16_t *)outBuffer) [i];
               buffer [2 * i + 1] = buffer [2 * i];
            }
-           audioBuffer  -> putDataIntoBuffer (buffer, samples);
-	   if (audioBuffer -> GetRingBufferReadAvailable() > (int)sampleRate / 8)
-              newAudio (samples, sampleRate);
+	   if (route != nullptr)
+	      route -> putSamples (buffer, samples, sampleRate);
+	   else {
+              audioBuffer  -> putDataIntoBuffer (buffer, 2 * samples);
+	      if (audioBuffer -> GetRingBufferReadAvailable() >
+	                                          (int)sampleRate / 8)
+                 newAudio (samples, sampleRate);
+	   }
         }
         else
            fprintf (stderr, "Cannot handle these channels\n");
@@ -36,8 +36,10 @@
   *	that are processed by the "faadDecoder" class
   */
 	fdkAAC::fdkAAC (RadioInterface *mr,
-                        RingBuffer<int16_t> *buffer) {
+                        RingBuffer<int16_t> *buffer,
+	                audioRoute *route) {
         this    -> audioBuffer  = buffer;
+	this	-> route	= route;
 	working			= false;
 	handle			= aacDecoder_Open (TT_MP4_LOAS, 1);
 	if (handle == nullptr)
@@ -93,23 +95,34 @@ int		output_size	= 8 * 2048;
 	   return -1;
 
         if (info -> numChannels == 2) {
-           audioBuffer  -> putDataIntoBuffer (bufp, info -> frameSize * 2);
-	   if (audioBuffer -> GetRingBufferReadAvailable() >
-	                          (int)info -> sampleRate / 8)
-              newAudio (info -> frameSize, info -> sampleRate);
+	   if (route != nullptr)
+	      route -> putSamples (bufp, info -> frameSize,
+	                                          info -> sampleRate);
+	   else {
+              audioBuffer  -> putDataIntoBuffer (bufp, info -> frameSize * 2);
+	      if (audioBuffer -> GetRingBufferReadAvailable() >
+	                             (int)info -> sampleRate / 8)
+                 newAudio (info -> frameSize, info -> sampleRate);
+	   }
         }
         else
         if (info -> numChannels == 1) {
-           int16_t *buffer = (int16_t *)alloca (2 * info -> frameSize);
+           int16_t *buffer = (int16_t *)alloca (4 * info -> frameSize);
            int16_t i;
            for (i = 0; i < info -> frameSize; i ++) {
               buffer [2 * i]	= ((int16_t *)bufp) [i];
-              buffer [2 * i + 1] = bufp [2 * i];
+              buffer [2 * i + 1] = buffer [2 * i];
            }
-           audioBuffer  -> putDataIntoBuffer (buffer, info -> frameSize * 2);
-	   if (audioBuffer -> GetRingBufferReadAvailable() >
-	                          (int)info -> sampleRate / 8)
-              newAudio (info -> frameSize, info -> sampleRate);
+	   if (route != nullptr)
+	      route -> putSamples (buffer, info -> frameSize,
+	                                          info -> sampleRate);
+	   else {
+              audioBuffer  -> putDataIntoBuffer (buffer,
+	                                         info -> frameSize * 2);
+	      if (audioBuffer -> GetRingBufferReadAvailable() >
+	                             (int)info -> sampleRate / 8)
+                 newAudio (info -> frameSize, info -> sampleRate);
+	   }
         }
         else
            fprintf (stderr, "Cannot handle these channels\n");
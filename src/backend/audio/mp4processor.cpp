@@ -35,7 +35,6 @@
 #include	<cstring>
 #include	"charsets.h"
 #include	"pad-handler.h"
-#include	"bitWriter.h"
 
 //
 /**
@@ -47,13 +46,20 @@
 	                            int16_t		bitRate,
 	                            RingBuffer<int16_t> *b,
 	                            RingBuffer<uint8_t> *frameBuffer,
-	                            uint8_t		procMode)
+	                            uint8_t		procMode,
+	                            dabMetrics		*metrics,
+	                            const QString	&serviceName,
+	                            audioRoute		*route)
 	                               :my_padhandler (mr),
  	                                my_rsDecoder (8, 0435, 0, 1, 10) {
 
 	myRadioInterface	= mr;
 	this	-> frameBuffer	= frameBuffer;
 	this	-> procMode	= procMode;
+	this	-> metrics	= metrics;
+	this	-> route	= route;
+	thePool			= auPool::sharedPool ();
+	my_padhandler. setRoute (route);
 	connect (this, SIGNAL (show_frameErrors (int)),
 	         mr, SLOT (show_frameErrors (int)));
 	connect (this, SIGNAL (show_rsErrors (int)),
@@ -67,9 +73,9 @@
 	connect (this, SIGNAL (show_rsCorrections (int)),
 	         mr, SLOT (show_rsCorrections (int)));
 #ifdef	__WITH_FDK_AAC__
-	aacDecoder		= new fdkAAC (mr, b);
+	aacDecoder		= new fdkAAC (mr, b, route);
 #else
-	aacDecoder		= new faadDecoder (mr, b);
+	aacDecoder		= new faadDecoder (mr, b, route);
 #endif
 	this	-> bitRate	= bitRate;	// input rate
 
@@ -79,17 +85,24 @@
 	outVector . resize (RSDims * 110);
 	blockFillIndex	= 0;
 	blocksInBuffer	= 0;
+	for (int i = 0; i < 5; i ++)
+	   fireCodeOK [i] = false;
+	superframeSync	= false;
+	syncBlocks	= 0;
 	frameCount	= 0;
 	frameErrors	= 0;
 	aacErrors	= 0;
+	oversizeAUs	= 0;
 	aacFrames	= 0;
 	successFrames	= 0;
 	rsErrors	= 0;
 	totalCorrections	= 0;
 	goodFrames		= 0;
+	theChannel		= new decodeChannel (this, serviceName, metrics);
 }
 
 	mp4Processor::~mp4Processor() {
+	delete theChannel;		// no decoding after this
 	delete aacDecoder;
 }
 
@@ -102,6 +115,11 @@
   *	Note that the packing in the entry vector is still one bit
   *	per Byte, nbits is the number of Bits (i.e. containing bytes)
   *	the function adds nbits bits, packed in bytes, to the frame
+  *	The fire code of a block - as start of a superframe - is
+  *	checked once, on arrival, so when looking for a superframe
+  *	all five candidate starts are known at any time, and the
+  *	superframe is found as soon as its last block is in.
+  *	syncBlocks counts the blocks needed to get (back) in sync
   */
 void	mp4Processor::addtoFrame (std::vector<uint8_t> V) {
 int16_t	i, j;
@@ -114,6 +132,10 @@ int16_t	nbits	= 24 * bitRate;
 	      temp = (temp << 1) | (V [i * 8 + j] & 01);
 	   frameBytes [blockFillIndex * nbits / 8 + i] = temp;
 	}
+	fireCodeOK [blockFillIndex] =
+	               fc. check (&frameBytes [blockFillIndex * nbits / 8]);
+	if (!superframeSync)
+	   syncBlocks ++;
 //
 	blocksInBuffer ++;
 	blockFillIndex = (blockFillIndex + 1) % 5;
@@ -125,7 +147,10 @@ int16_t	nbits	= 24 * bitRate;
 ///	first, we show the "successrate"
 	   if (++frameCount >= 25) {
 	      frameCount = 0;
-	      show_frameErrors (frameErrors);
+	      if (metrics != nullptr)
+	         metrics -> frameErrors. store (frameErrors);
+	      else
+	         show_frameErrors (frameErrors);
 	      frameErrors = 0;
 	   }
 
@@ -134,14 +159,23 @@ int16_t	nbits	= 24 * bitRate;
   *	if the firecode is OK, we handle the frame
   *	and adjust the buffer here for the next round
   */
-	   if (fc. check (&frameBytes [blockFillIndex * nbits / 8]) &&
+	   if (fireCodeOK [blockFillIndex] &&
 	       (processSuperframe (frameBytes. data(),
 	                           blockFillIndex * nbits / 8))) {
 //	since we processed a full cycle of 5 blocks, we just start a
 //	new sequence, beginning with block blockFillIndex
 	      blocksInBuffer	= 0;
+	      if (!superframeSync) {
+	         superframeSync	= true;
+	         if (metrics != nullptr)	// a block per 24 msec
+	            metrics -> syncLatency. store (syncBlocks * 24);
+	         syncBlocks	= 0;
+	      }
 	      if (++successFrames > 25) {
-	         show_rsErrors (rsErrors);
+	         if (metrics != nullptr)
+	            metrics -> rsErrors. store (rsErrors);
+	         else
+	            show_rsErrors (rsErrors);
 	         successFrames	= 0;
 	         rsErrors	= 0;
 	      }
@@ -152,6 +186,7 @@ int16_t	nbits	= 24 * bitRate;
   */
 	      blocksInBuffer  = 4;
 	      frameErrors ++;
+	      superframeSync	= false;
 	   }
 	}
 }
@@ -167,7 +202,6 @@ uint8_t		num_aus;
 int16_t		i, j, k;
 uint8_t		rsIn	[120];
 uint8_t		rsOut	[110];
-int		tmp;
 stream_parms    streamParameters;
 
 /**
@@ -280,65 +314,77 @@ stream_parms    streamParameters;
 //	      return false;
 	   }
 
+//	an AU that does not fit in an auBuffer is not a CRC failure,
+//	it is counted on its own
+	   if (aac_frame_length > AU_MAX_SIZE) {
+	      oversizeAUs ++;
+	      if (metrics != nullptr)
+	         metrics -> oversizeAUs. fetch_add (1);
+	      fprintf (stderr, "dab+ frame %d (%d) too large (%d bytes), %d so far\n",
+	                      i, num_aus, aac_frame_length, oversizeAUs);
+	      continue;
+	   }
+
 //	but first the crc check
 	   if (check_crc_bytes (&outVector [au_start [i]],
 	                                aac_frame_length)) {
 //
-//	firs prepare dumping
-	      if ((procMode == __BOTH) || (procMode == __ONLY_DATA)) {
-	         std::vector<uint8_t> fileBuffer;
-	         int segmentSize =
+//	the AU is copied once, into a buffer from the pool, the dump
+//	and the decoder get it from there. The LATM frame is only
+//	built when someone needs it, a route with compressed sinks
+//	gets the LATM frames as they are
+	      bool passFrames	= (route != nullptr) && route -> wantsFrames ();
+	      auBuffer *theAU	= thePool -> getBuffer ();
+	      memcpy (theAU -> au, &outVector [au_start [i]], aac_frame_length);
+	      memset (&theAU -> au [aac_frame_length], 0, AU_PADDING);
+	      theAU -> auLength	= aac_frame_length;
+	      theAU -> params	= streamParameters;
+#ifndef	__WITH_FDK_AAC__
+	      if ((procMode == __BOTH) || (procMode == __ONLY_DATA) ||
+	          passFrames)
+#endif
+	         theAU -> latmLength =
 	              build_aacFile (aac_frame_length,
 	                             &streamParameters,
-	                             &(outVector. data () [au_start [i]]),
-	                             fileBuffer);
-	         frameBuffer -> putDataIntoBuffer (fileBuffer. data (),
-	                                                  segmentSize);
-	         newFrame (segmentSize);
+	                             theAU -> au,
+	                             theAU -> latm);
+//
+//	first prepare dumping
+	      if ((procMode == __BOTH) || (procMode == __ONLY_DATA)) {
+	         frameBuffer -> putDataIntoBuffer (theAU -> latm,
+	                                           theAU -> latmLength);
+	         if (metrics != nullptr)
+	            metrics -> framesOut. fetch_add (1);
+	         else
+	            newFrame (theAU -> latmLength);
 	      }
+	      if (passFrames)
+	         route -> putFrame (theAU -> latm, theAU -> latmLength,
+	                                              ROUTE_FRAME_AAC);
 
 	      if ((procMode == __BOTH) || (procMode == __ONLY_SOUND)) {
 //	first handle the pad data if any
-	         if (((outVector [au_start [i + 0]] >> 5) & 07) == 4) {
-	            int16_t count = outVector [au_start [i] + 1];
+	         if (((theAU -> au [0] >> 5) & 07) == 4) {
+	            int16_t count = theAU -> au [1];
 	            uint8_t buffer [count];
-	            memcpy (buffer, &outVector [au_start [i] + 2], count);
+	            memcpy (buffer, &theAU -> au [2], count);
 	            uint8_t L0	= buffer [count - 1];
 	            uint8_t L1	= buffer [count - 2];
 	            my_padhandler. processPAD (buffer, count - 3, L1, L0);
 	         }
 //
-//	then handle the audio
-#ifdef	__WITH_FDK_AAC__
-	         std::vector<uint8_t> fileBuffer;
-	         int segmentSize =
-	              build_aacFile (aac_frame_length,
-	                             &streamParameters,
-	                             &(outVector. data () [au_start [i]]),
-	                             fileBuffer);
-	         tmp = aacDecoder -> MP42PCM (&streamParameters, 
-	                                      fileBuffer. data (), 
-	                                      segmentSize);
-#else
-	         uint8_t theAudioUnit [2 * 960 + 10];	// sure, large enough
-
-	         memcpy (theAudioUnit,
-	                    &outVector [au_start [i]], aac_frame_length);
-	         memset (&theAudioUnit [aac_frame_length], 0, 10);
-
-	         tmp = aacDecoder -> MP42PCM (&streamParameters,
-	                                      theAudioUnit,
-	                                      aac_frame_length);
-#endif
-	         emit isStereo ((streamParameters. aacChannelMode == 1) ||
-	                        (streamParameters. psFlag == 1));
-	         if (tmp <= 0) 
-	            aacErrors ++;
-	         if (++aacFrames > 25) {
-	            show_aacErrors (aacErrors);
-	            aacErrors	= 0;
-	            aacFrames	= 0;
-	         }
+//	then handle the audio, the channel takes our reference,
+//	a route with compressed sinks only is not decoded
+	         if ((route == nullptr) || route -> wantsPcm ())
+	            theChannel -> submit (theAU);
+	         else
+	            theAU -> release ();
+	      }
+	      else
+	         theAU -> release ();
+	      if (metrics != nullptr) {
+	         metrics -> auBuffers. store (thePool -> allocations ());
+	         metrics -> auRequests. store (thePool -> requests ());
 	      }
 	   }
 	   else {
@@ -352,12 +398,48 @@ stream_parms    streamParameters;
 	return true;
 }
 
+//
+//	the LATM frame is written into out, the bitWriter is kept,
+//	so after the first frames, it does not allocate any more
+//
+//	decodeFrame is called by one of the workers of the decoder
+//	pool, for a given processor the calls are sequential
+void	mp4Processor::decodeFrame	(auBuffer *theAU) {
+int	tmp;
+
+#ifdef	__WITH_FDK_AAC__
+	tmp = aacDecoder -> MP42PCM (&theAU -> params,
+	                             theAU -> latm,
+	                             theAU -> latmLength);
+#else
+	tmp = aacDecoder -> MP42PCM (&theAU -> params,
+	                             theAU -> au,
+	                             theAU -> auLength);
+#endif
+	if (metrics != nullptr)
+	   metrics -> stereo. store
+	               ((theAU -> params. aacChannelMode == 1) ||
+	                (theAU -> params. psFlag == 1));
+	else
+	   emit isStereo ((theAU -> params. aacChannelMode == 1) ||
+	                  (theAU -> params. psFlag == 1));
+	if (tmp <= 0) 
+	   aacErrors ++;
+	if (++aacFrames > 25) {
+	   if (metrics != nullptr)
+	      metrics -> aacErrors. store (aacErrors);
+	   else
+	      show_aacErrors (aacErrors);
+	   aacErrors	= 0;
+	   aacFrames	= 0;
+	}
+}
+
 int	mp4Processor::build_aacFile (int16_t aac_frame_len,
 	                             stream_parms *sp,
 	                             uint8_t *data,
-	                             std::vector<uint8_t> &fileBuffer) {
-BitWriter	au_bw;
-
+	                             uint8_t *out) {
+	au_bw. Reset ();
 	au_bw. AddBits (0x2B7, 11);	// syncword
 	au_bw. AddBits (    0, 13);	// audioMuxLengthBytes - written later
 //	AudioMuxElement(1)
@@ -397,6 +479,6 @@ BitWriter	au_bw;
 
 	au_bw. AddBytes (data, aac_frame_len);
 	au_bw. WriteAudioMuxLengthBytes ();
-	fileBuffer	= au_bw. GetData ();
-	return fileBuffer. size ();
+	memcpy (out, au_bw. Data (), au_bw. Size ());
+	return au_bw. Size ();
 }
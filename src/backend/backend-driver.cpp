@@ -32,13 +32,17 @@
 	                              descriptorType *d,
 	                              RingBuffer<int16_t> *audioBuffer,
 	                              RingBuffer<uint8_t> *dataBuffer,
-	                              RingBuffer<uint8_t> *frameBuffer) {
+	                              RingBuffer<uint8_t> *frameBuffer,
+	                              dabMetrics	*metrics) {
 	if (d -> type == AUDIO_SERVICE) {
 	   if (((audiodata *)d) -> ASCTy != 077) {
               theProcessor = new mp2Processor (mr,
 	                                       d -> bitRate,
                                                audioBuffer,
-	                                       frameBuffer);
+	                                       frameBuffer,
+	                                       metrics,
+	                                       d -> serviceName,
+	                                       ((audiodata *)d) -> route);
 	   }
            else
            if (((audiodata *)d) -> ASCTy == 077) {
@@ -46,7 +50,10 @@
 	                                       d -> bitRate,
                                                audioBuffer,
 	                                       frameBuffer,
-	                                       d -> procMode);
+	                                       d -> procMode,
+	                                       metrics,
+	                                       d -> serviceName,
+	                                       ((audiodata *)d) -> route);
 	   }
 	}
 	else
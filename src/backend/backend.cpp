@@ -34,14 +34,16 @@
 	                         descriptorType	*d,
 	                         RingBuffer<int16_t> *audiobuffer,
 	                         RingBuffer<uint8_t> *databuffer,	
-	                         RingBuffer<uint8_t> *frameBuffer):
+	                         RingBuffer<uint8_t> *frameBuffer,
+	                         dabMetrics	*metrics):
 	                                    deconvolver (d),
 	                                    outV (d -> bitRate * 24),
 	                                    driver (mr, 
 	                                            d,
 	                                            audiobuffer,
 	                                            databuffer,
-	                                            frameBuffer) 
+	                                            frameBuffer,
+	                                            metrics) 
 #ifdef	__THREADED_BACKEND
 	                                    ,freeSlots (NUMBER_SLOTS) 
 #endif 
@@ -24,6 +24,7 @@
 #include	"radio.h"
 #include	"charsets.h"
 #include	"mot-object.h"
+#include	"audio-router.h"
 /**
   *	\class padHandler
   *	Handles the pad segments passed on from mp2- and mp4Processor
@@ -35,6 +36,7 @@
 	connect (this, SIGNAL (show_motHandling (bool)),
 	         mr, SLOT (show_motHandling (bool)));
 	currentSlide	= nullptr;
+	route		= nullptr;
 //
 //	mscGroupElement indicates whether we are handling an
 //	msc datagroup or not.
@@ -57,6 +59,18 @@
 	   delete currentSlide;
 }
 
+//
+//	the labels of a routed service go to its route as well
+void	padHandler::setRoute	(audioRoute *route) {
+	this	-> route	= route;
+}
+
+void	padHandler::labelReady	() {
+	showLabel (dynamicLabelText);
+	if (route != nullptr)
+	   route -> putLabel (dynamicLabelText);
+}
+
 //	Data is stored reverse, we pass the vector and the index of the
 //	last element of the XPad data.
 //	 L0 is the "top" byte of the L field, L1 the next to top one.
@@ -119,7 +133,7 @@ int16_t	i;
 	         if (firstSegment && !lastSegment) {
 	            segmentNumber   = b [last - 2] >> 4;
 	            if (dynamicLabelText. size() > 0)
-	               showLabel (dynamicLabelText);
+	               labelReady ();
 	            dynamicLabelText. clear();
 	         }
 	         still_to_go     = b [last - 1] & 0x0F;
@@ -165,7 +179,7 @@ int16_t	i;
 //	then show it.
 	      if (!firstSegment && lastSegment) {
 	         if (dynamicLabelText. size() > 0)
-	            showLabel (dynamicLabelText);
+	            labelReady ();
 	         dynamicLabelText. clear();
 	      }
 	   }
@@ -316,7 +330,7 @@ int16_t  dataLength                = 0;
 //	if at the end, show the label
 	      if (last) {
 	         if (!moreXPad) {
-	            showLabel (dynamicLabelText);
+	            labelReady ();
 	                              
 	         }
 	         else
@@ -345,7 +359,7 @@ int16_t  dataLength                = 0;
 	                              dataLength);
 	   dynamicLabelText. append (segmentText);
 	   if (!moreXPad && isLastSegment) {
-	      showLabel (dynamicLabelText);
+	      labelReady ();
 	   }
 	}
 }
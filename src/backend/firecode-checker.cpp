@@ -45,12 +45,16 @@ uint16_t itab [8];
 	   itab [i] = run8 (regs);
 	}
 	for (i = 0; i < 256; i++) {
-	   tab [i] = 0;
+	   tab [0][i] = 0;
 	   for (j = 0; j < 8; j++) {
 	      if (i & (1 << j))
-	         tab [i] = tab [i] ^ itab [j];
+	         tab [0][i] = tab [0][i] ^ itab [j];
 	   }
 	}
+//	tab [k][b] is the contribution of byte b, followed by k more bytes
+	for (i = 1; i < 8; i++)
+	   for (j = 0; j < 256; j++)
+	      tab [i][j] = (tab [i - 1][j] << 8) ^ tab [0][tab [i - 1][j] >> 8];
 }
 
 	firecode_checker::~firecode_checker() {
@@ -74,23 +78,26 @@ uint16_t v = 0;
 	return v;
 }
 
-bool	firecode_checker::check (const uint8_t *x) {
-int16_t i;
-uint16_t state = (x[2] << 8) | x[3];
-uint16_t istate;
-
-	for (i = 4; i < 11; i++) {
-	   istate = tab [state >> 8];
-	   state = ((istate & 0x00ff) ^ x[i]) |
-	           ((istate ^ state << 8) & 0xff00);
-	}
+//
+//	The checksum is the remainder of the division of the 9 data
+//	bytes, followed by the 2 parity bytes, by g. It is computed
+//	"slice by 8": the first 8 data bytes are handled with a
+//	single lookup each and no dependency between the lookups,
+//	the remaining 3 bytes one by one
+static inline
+uint16_t	step	(const uint16_t *tab0, uint16_t state, uint8_t b) {
+	return (state << 8) ^ tab0 [(state >> 8) ^ b];
+}
 
-	for (i = 0; i < 2; i++) {
-	   istate = tab [state >> 8];
-	   state = ((istate & 0x00ff) ^ x [i]) |
-	           ((istate ^ state << 8) & 0xff00);
-	}
+bool	firecode_checker::check (const uint8_t *x) {
+uint16_t state	= tab [7][x [2]] ^ tab [6][x [3]] ^
+	          tab [5][x [4]] ^ tab [4][x [5]] ^
+	          tab [3][x [6]] ^ tab [2][x [7]] ^
+	          tab [1][x [8]] ^ tab [0][x [9]];
 
+	state	= step (tab [0], state, x [10]);
+	state	= step (tab [0], state, x [0]);
+	state	= step (tab [0], state, x [1]);
 	return state == 0;
 }
 
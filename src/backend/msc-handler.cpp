@@ -38,7 +38,8 @@ static int cifTable [] = {18, 72, 0, 36};
 //
 		mscHandler::mscHandler	(RadioInterface *mr,
 	                                 uint8_t	dabMode,
-	                                 RingBuffer<uint8_t> *frameBuffer) :
+	                                 RingBuffer<uint8_t> *frameBuffer,
+	                                 dabMetrics	*metrics) :
 	                                       params (dabMode),
 	                                       my_fftHandler (dabMode),
 	                                       myMapper (dabMode)
@@ -48,6 +49,7 @@ static int cifTable [] = {18, 72, 0, 36};
 	                                                                {
 	myRadioInterface	= mr;
 	this	-> frameBuffer	= frameBuffer;
+	this	-> metrics	= metrics;
 	cifVector. resize (55296);
 	BitsperBlock		= 2 * params. get_carriers();
 	ibits. resize (BitsperBlock);
@@ -252,7 +254,8 @@ bool	mscHandler::set_Channel (descriptorType *d,
 	                                     d,
 	                                     audioBuffer,
 	                                     dataBuffer,
-	                                     frameBuffer));
+	                                     frameBuffer,
+	                                     metrics));
 	work_to_be_done. store (true);
 	locker. unlock();
 	return true;
@@ -45,7 +45,8 @@
   */
 
 		ficHandler::ficHandler (RadioInterface *mr,
-	                                uint8_t dabMode):
+	                                uint8_t dabMode,
+	                                dabMetrics *metrics):
 	                                    fibDecoder (mr),
 	                                    params (dabMode),
 	                                    myViterbi (768, true) {
@@ -53,6 +54,7 @@ int16_t	i, j, k;
 int	local	= 0;
 int16_t	shiftRegister [9] = {1, 1, 1, 1, 1, 1, 1, 1, 1};
 
+	this	-> metrics	= metrics;
 	index		= 0;
 	BitsperBlock	= 2 * params. get_carriers();
 	ficno		= 0;
@@ -195,12 +197,17 @@ int16_t	inputCount	= 0;
 
 	for (i = ficno * 3; i < ficno * 3 + 3; i ++) {
 	   uint8_t *p = &bitBuffer_out [(i % 3) * 256];
-	   if (!check_CRC_bits (p, 256)) {
-	      show_ficSuccess (false);
-	      continue;
+	   bool ok	= check_CRC_bits (p, 256);
+	   if (metrics != nullptr) {
+	      metrics -> ficBlocks. fetch_add (1);
+	      if (ok)
+	         metrics -> ficSuccess. fetch_add (1);
 	   }
+	   else
+	      show_ficSuccess (ok);
+	   if (!ok)
+	      continue;
 
-	   show_ficSuccess (true);
 	   fibDecoder::process_FIB (p, ficno);
 	}
 }
@@ -44,12 +44,14 @@
 	ofdmDecoder::ofdmDecoder	(RadioInterface *mr,
 	                                 uint8_t	dabMode,
 	                                 int16_t	bitDepth,
-	                                 RingBuffer<std::complex<float>> *iqBuffer) :
+	                                 RingBuffer<std::complex<float>> *iqBuffer,
+	                                 dabMetrics	*metrics) :
 	                                    params (dabMode),
 	                                    my_fftHandler (dabMode),
 	                                    myMapper (dabMode) {
 	this	-> myRadioInterface	= mr;
 	this	-> iqBuffer		= iqBuffer;
+	this	-> metrics		= metrics;
 	connect (this, SIGNAL (showIQ (int)),
 	         myRadioInterface, SLOT (showIQ (int)));
 	connect (this, SIGNAL (showQuality (float)),
@@ -183,8 +185,15 @@ std::complex<float> conjVector [T_u];
 	   if (++cnt > 7) {
 	      iqBuffer	-> putDataIntoBuffer (&conjVector [T_u / 2 - carriers / 2],
 	                                      carriers);
-	      showIQ	(carriers);
-	      showQuality		(computeQuality (conjVector));
+	      if (metrics != nullptr) {
+	         metrics -> quality. store (computeQuality (conjVector));
+	         metrics -> iqAmount. store (carriers);
+	         metrics -> iqCount. fetch_add (1);
+	      }
+	      else {
+	         showIQ	(carriers);
+	         showQuality		(computeQuality (conjVector));
+	      }
 //	      compute_timeOffset	(fft_buffer, phaseReference. data ());
 //	      compute_clockOffset	(fft_buffer, phaseReference. data ());
 //	      compute_frequencyOffset	(fft_buffer, phaseReference. data ());
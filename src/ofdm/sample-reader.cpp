@@ -23,6 +23,15 @@
 #
 #include	"sample-reader.h"
 #include	"radio.h"
+#include	<QMutex>
+#ifdef	IQ_SERVER
+#include	"iq-server.h"
+#endif
+#ifdef	SSE_AVAILABLE
+#include	<emmintrin.h>
+#elif	defined (NEON_AVAILABLE)
+#include	<arm_neon.h>
+#endif
 
 static  inline
 int16_t valueFor (int16_t b) {
@@ -32,17 +41,24 @@ int16_t res     = 1;
         return res;
 }
 
+//
+//	The table is shared by all sampleReaders, it is filled once,
+//	there may be more than one dabProcessor running (daemon mode)
 static
 std::complex<float> oscillatorTable [INPUT_RATE];
+static	QMutex	oscillatorLocker;
+static	bool	oscillatorReady	= false;
 
 	sampleReader::sampleReader (RadioInterface *mr,
 	                            deviceHandler	*theRig,
-	                            RingBuffer<std::complex<float>> *spectrumBuffer
+	                            RingBuffer<std::complex<float>> *spectrumBuffer,
+	                            dabMetrics	*metrics
 	                           ) {
 int	i;
 	this	-> theRig	= theRig;
         bufferSize		= 32768;
         this    -> spectrumBuffer       = spectrumBuffer;
+	this	-> metrics		= metrics;
         connect (this, SIGNAL (show_Spectrum (int)),
                  mr, SLOT (showSpectrum (int)));
         localBuffer. resize (bufferSize);
@@ -52,16 +68,34 @@ int	i;
 	currentPhase	= 0;
 	sLevel		= 0;
 	sampleCount	= 0;
-        for (i = 0; i < INPUT_RATE; i ++)
-           oscillatorTable [i] = std::complex<float>
+	oscillatorLocker. lock ();
+	if (!oscillatorReady) {
+           for (i = 0; i < INPUT_RATE; i ++)
+              oscillatorTable [i] = std::complex<float>
 	                            (cos (2.0 * M_PI * i / INPUT_RATE),
                                      sin (2.0 * M_PI * i / INPUT_RATE));
+	   oscillatorReady	= true;
+	}
+	oscillatorLocker. unlock ();
 
 	bufferContent	= 0;
 	corrector	= 0;
-	dumpfilePointer. store (nullptr);
-	dumpIndex	= 0;
 	dumpScale	= valueFor (theRig -> bitDepth());
+	sampleFormat	= theRig -> sampleFormat ();
+	theServer. store (nullptr);
+	for (i = 0; i < 256; i ++)
+	   u8Table [i]	= (i - 128) / 128.0;
+	switch (sampleFormat) {
+	   case SAMPLES_S8:
+	      sampleScale	= 1.0 / 128;
+	      break;
+	   case SAMPLES_S16:
+	      sampleScale	= 1.0 / dumpScale;
+	      break;
+	   default:
+	      sampleScale	= 1.0;
+	      break;
+	}
 	running. store (true);
 }
 
@@ -75,6 +109,168 @@ void	sampleReader::setRunning (bool b) {
 float	sampleReader::get_sLevel() {
 	return sLevel;
 }
+//
+//	The samples are fetched in the native format of the device
+//	and converted here, in a single pass over the samples.
+//	Note that the samples are IQ pairs, so we just convert
+//	2 * n values
+int32_t	sampleReader::readSamples (std::complex<float> *v, int32_t n) {
+float	*out	= reinterpret_cast<float *>(v);
+int32_t	amount;
+
+	switch (sampleFormat) {
+	   default:
+	   case SAMPLES_CF32:
+	      return theRig -> getSamples (v, n);
+
+	   case SAMPLES_U8: {
+	      if ((int32_t)rawBuffer. size () < 2 * n)
+	         rawBuffer. resize (2 * n);
+	      uint8_t *in	= rawBuffer. data ();
+	      amount	= theRig -> getRawSamples (in, n);
+	      convert_u8 (in, out, 2 * amount);
+	      return amount;
+	   }
+
+	   case SAMPLES_S8: {
+	      if ((int32_t)rawBuffer. size () < 2 * n)
+	         rawBuffer. resize (2 * n);
+	      int8_t *in	= reinterpret_cast<int8_t *>(rawBuffer. data ());
+	      amount	= theRig -> getRawSamples (in, n);
+	      convert_s8 (in, out, 2 * amount);
+	      return amount;
+	   }
+
+	   case SAMPLES_S16: {
+	      if ((int32_t)rawBuffer. size () < 4 * n)
+	         rawBuffer. resize (4 * n);
+	      int16_t *in	= reinterpret_cast<int16_t *>(rawBuffer. data ());
+	      amount	= theRig -> getRawSamples (in, n);
+	      convert_s16 (in, out, 2 * amount);
+	      return amount;
+	   }
+	}
+}
+
+//
+//	The conversions are on the path of each sample, with SSE2 or
+//	NEON we do 16 (u8, s8) or 8 (s16) values per step.
+//	u8 (rtl_sdr, rtl_tcp) is offset binary, 128 is zero
+void	sampleReader::convert_u8	(const uint8_t *in,
+	                                 float *out, int32_t n) {
+int32_t	i	= 0;
+#ifdef	SSE_AVAILABLE
+const __m128i	zero	= _mm_setzero_si128 ();
+const __m128	offset	= _mm_set1_ps (128.0f);
+const __m128	scale	= _mm_set1_ps (1.0f / 128);
+
+	for (; i + 16 <= n; i += 16) {
+	   __m128i x	= _mm_loadu_si128 ((const __m128i *)(in + i));
+	   __m128i lo	= _mm_unpacklo_epi8 (x, zero);
+	   __m128i hi	= _mm_unpackhi_epi8 (x, zero);
+	   __m128i v [4]	= {_mm_unpacklo_epi16 (lo, zero),
+	                   _mm_unpackhi_epi16 (lo, zero),
+	                   _mm_unpacklo_epi16 (hi, zero),
+	                   _mm_unpackhi_epi16 (hi, zero)};
+	   for (int k = 0; k < 4; k ++)
+	      _mm_storeu_ps (out + i + 4 * k,
+	                     _mm_mul_ps (_mm_sub_ps (_mm_cvtepi32_ps (v [k]),
+	                                             offset), scale));
+	}
+#elif	defined (NEON_AVAILABLE)
+const float32x4_t	offset	= vdupq_n_f32 (128.0f);
+const float32x4_t	scale	= vdupq_n_f32 (1.0f / 128);
+
+	for (; i + 16 <= n; i += 16) {
+	   uint8x16_t x	= vld1q_u8 (in + i);
+	   uint16x8_t lo	= vmovl_u8 (vget_low_u8 (x));
+	   uint16x8_t hi	= vmovl_u8 (vget_high_u8 (x));
+	   uint32x4_t v [4]	= {vmovl_u16 (vget_low_u16 (lo)),
+	                   vmovl_u16 (vget_high_u16 (lo)),
+	                   vmovl_u16 (vget_low_u16 (hi)),
+	                   vmovl_u16 (vget_high_u16 (hi))};
+	   for (int k = 0; k < 4; k ++)
+	      vst1q_f32 (out + i + 4 * k,
+	                 vmulq_f32 (vsubq_f32 (vcvtq_f32_u32 (v [k]),
+	                                       offset), scale));
+	}
+#endif
+	for (; i < n; i ++)
+	   out [i] = u8Table [in [i]];
+}
+//
+//	s8 (hackrf), with SSE2 a byte is sign extended by unpacking it
+//	into the top byte of a 32 bit value and shifting it back
+void	sampleReader::convert_s8	(const int8_t *in,
+	                                 float *out, int32_t n) {
+int32_t	i	= 0;
+#ifdef	SSE_AVAILABLE
+const __m128	scale	= _mm_set1_ps (sampleScale);
+
+	for (; i + 16 <= n; i += 16) {
+	   __m128i x	= _mm_loadu_si128 ((const __m128i *)(in + i));
+	   __m128i lo	= _mm_unpacklo_epi8 (x, x);
+	   __m128i hi	= _mm_unpackhi_epi8 (x, x);
+	   __m128i v [4]	= {_mm_unpacklo_epi16 (lo, lo),
+	                   _mm_unpackhi_epi16 (lo, lo),
+	                   _mm_unpacklo_epi16 (hi, hi),
+	                   _mm_unpackhi_epi16 (hi, hi)};
+	   for (int k = 0; k < 4; k ++)
+	      _mm_storeu_ps (out + i + 4 * k,
+	                     _mm_mul_ps (_mm_cvtepi32_ps (
+	                                   _mm_srai_epi32 (v [k], 24)), scale));
+	}
+#elif	defined (NEON_AVAILABLE)
+const float32x4_t	scale	= vdupq_n_f32 (sampleScale);
+
+	for (; i + 16 <= n; i += 16) {
+	   int8x16_t x	= vld1q_s8 (in + i);
+	   int16x8_t lo	= vmovl_s8 (vget_low_s8 (x));
+	   int16x8_t hi	= vmovl_s8 (vget_high_s8 (x));
+	   int32x4_t v [4]	= {vmovl_s16 (vget_low_s16 (lo)),
+	                   vmovl_s16 (vget_high_s16 (lo)),
+	                   vmovl_s16 (vget_low_s16 (hi)),
+	                   vmovl_s16 (vget_high_s16 (hi))};
+	   for (int k = 0; k < 4; k ++)
+	      vst1q_f32 (out + i + 4 * k,
+	                 vmulq_f32 (vcvtq_f32_s32 (v [k]), scale));
+	}
+#endif
+	for (; i < n; i ++)
+	   out [i] = in [i] * sampleScale;
+}
+//
+//	s16, scaled by the bit depth of the device
+void	sampleReader::convert_s16	(const int16_t *in,
+	                                 float *out, int32_t n) {
+int32_t	i	= 0;
+#ifdef	SSE_AVAILABLE
+const __m128	scale	= _mm_set1_ps (sampleScale);
+
+	for (; i + 8 <= n; i += 8) {
+	   __m128i x	= _mm_loadu_si128 ((const __m128i *)(in + i));
+	   __m128i lo	= _mm_srai_epi32 (_mm_unpacklo_epi16 (x, x), 16);
+	   __m128i hi	= _mm_srai_epi32 (_mm_unpackhi_epi16 (x, x), 16);
+	   _mm_storeu_ps (out + i, _mm_mul_ps (_mm_cvtepi32_ps (lo), scale));
+	   _mm_storeu_ps (out + i + 4,
+	                        _mm_mul_ps (_mm_cvtepi32_ps (hi), scale));
+	}
+#elif	defined (NEON_AVAILABLE)
+const float32x4_t	scale	= vdupq_n_f32 (sampleScale);
+
+	for (; i + 8 <= n; i += 8) {
+	   int16x8_t x	= vld1q_s16 (in + i);
+	   vst1q_f32 (out + i,
+	              vmulq_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_low_s16 (x))),
+	                         scale));
+	   vst1q_f32 (out + i + 4,
+	              vmulq_f32 (vcvtq_f32_s32 (vmovl_s16 (vget_high_s16 (x))),
+	                         scale));
+	}
+#endif
+	for (; i < n; i ++)
+	   out [i] = in [i] * sampleScale;
+}
 
 std::complex<float> sampleReader::getSample (int32_t phaseOffset) {
 std::complex<float> temp;
@@ -96,17 +292,15 @@ std::complex<float> temp;
 	   throw 20;
 //
 //	so here, bufferContent > 0
-	theRig -> getSamples (&temp, 1);
+	readSamples (&temp, 1);
 	bufferContent --;
-	if (dumpfilePointer. load() != nullptr) {
-	   dumpBuffer [2 * dumpIndex    ] = real (temp) * dumpScale;
-	   dumpBuffer [2 * dumpIndex + 1] = imag (temp) * dumpScale;
-	   if ( ++dumpIndex >= DUMPSIZE / 2) {
-	      sf_writef_short (dumpfilePointer. load(),
-	                       dumpBuffer, dumpIndex);
-	      dumpIndex = 0;
-	   }
-	}
+	if (theDumper. isOpen ())
+	   dumpSamples (&temp, 1);
+#ifdef	IQ_SERVER
+	iqServer *server	= theServer. load ();
+	if (server != nullptr)
+	   server -> putSamples (&temp, 1);
+#endif
 
 	if (localCounter < bufferSize)
 	   localBuffer [localCounter ++]        = temp;
@@ -120,7 +314,10 @@ std::complex<float> temp;
 	sLevel		= 0.00001 * jan_abs (temp) + (1 - 0.00001) * sLevel;
 #define	N	5
 	if (++ sampleCount > INPUT_RATE / N) {
-	   show_Corrector	(corrector);
+	   if (metrics != nullptr)
+	      metrics -> corrector. store (corrector);
+	   else
+	      show_Corrector	(corrector);
 	   sampleCount = 0;
 	   if (spectrumBuffer != nullptr) {
               spectrumBuffer -> putDataIntoBuffer (localBuffer. data(),
@@ -151,19 +348,15 @@ int32_t		i;
 	   throw 20;
 //
 //	so here, bufferContent >= n
-	n	= theRig -> getSamples (v, n);
+	n	= readSamples (v, n);
 	bufferContent -= n;
-	if (dumpfilePointer. load() != nullptr) {
-	   for (i = 0; i < n; i ++) {
-	      dumpBuffer [2 * dumpIndex    ] = real (v [i]) * dumpScale;
-	      dumpBuffer [2 * dumpIndex + 1] = imag (v [i]) * dumpScale;
-	      if (++dumpIndex >= DUMPSIZE / 2) {
-	         sf_writef_short (dumpfilePointer. load(),
-	                          dumpBuffer, dumpIndex);
-	         dumpIndex = 0;
-	      }
-	   }
-	}
+	if (theDumper. isOpen ())
+	   dumpSamples (v, n);
+#ifdef	IQ_SERVER
+	iqServer *server	= theServer. load ();
+	if (server != nullptr)
+	   server -> putSamples (v, n);
+#endif
 
 //	OK, we have samples!!
 //	first: adjust frequency. We need Hz accuracy
@@ -180,7 +373,10 @@ int32_t		i;
 
 	sampleCount	+= n;
 	if (sampleCount > INPUT_RATE / N) {
-	   show_Corrector	(corrector);
+	   if (metrics != nullptr)
+	      metrics -> corrector. store (corrector);
+	   else
+	      show_Corrector	(corrector);
 	   if (spectrumBuffer != nullptr) {
 	      spectrumBuffer -> putDataIntoBuffer (localBuffer. data(),
 	                                                       bufferSize);
@@ -191,11 +387,39 @@ int32_t		i;
 	}
 }
 
+//
+//	the actual writing is done by the dumpWriter, in a thread
+//	of its own, so a slow disk does not stall the processing
+void	sampleReader::dumpSamples (const std::complex<float> *v, int32_t n) {
+	while (n > 0) {
+	   int32_t amount = n < DUMPSIZE / 2 ? n : DUMPSIZE / 2;
+	   for (int i = 0; i < amount; i ++) {
+	      dumpBuffer [2 * i    ] = real (v [i]) * dumpScale;
+	      dumpBuffer [2 * i + 1] = imag (v [i]) * dumpScale;
+	   }
+	   theDumper. put (dumpBuffer, 2 * amount * sizeof (int16_t));
+	   v	+= amount;
+	   n	-= amount;
+	}
+}
+
 void	sampleReader::startDumping (SNDFILE *f) {
-	dumpfilePointer. store (f);
+	theDumper. open (f);
 }
 
+void	sampleReader::startDumping (iqzWriter *f) {
+	theDumper. open (f);
+}
+//
+//	after stopDumping the caller may close the file,
+//	all samples are written by then
 void	sampleReader::stopDumping() {
-	dumpfilePointer. store (nullptr);
+	theDumper. close ();
+}
+//
+//	the samples, as they come from the device, are also
+//	handed over to the iqServer, if any
+void	sampleReader::set_iqServer	(iqServer *s) {
+	theServer. store (s);
 }
 
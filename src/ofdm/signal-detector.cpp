@@ -0,0 +1,135 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"signal-detector.h"
+#include	"sample-reader.h"
+#include	<cstring>
+
+//	A DAB signal is recognized by two cheap properties
+//	a. the power within the 1.536 MHz of the ensemble is
+//	   significantly higher than the power in the remaining bins
+//	   of the 2.048 MHz spectrum,
+//	b. once per frame there is a null period, a dip in the
+//	   amplitude of (at least) 3 / 4 T_null samples
+//	If neither of them is found, we consider the channel empty
+#define	OCCUPANCY_THRESHOLD	4.0	// app 6 dB
+#define	DIP_THRESHOLD		0.55	// as in the timeSyncer
+
+	signalDetector::signalDetector (sampleReader *mr, uint8_t dabMode):
+	                                   params (dabMode),
+	                                   my_fftHandler (dabMode) {
+	this	-> myReader	= mr;
+	this	-> T_u		= params. get_T_u ();
+	this	-> T_null	= params. get_T_null ();
+	this	-> T_F		= params. get_T_F ();
+	this	-> carriers	= params. get_carriers ();
+	this	-> segmentSize	= T_null / 4;
+	fft_buffer		= my_fftHandler. getVector ();
+//
+//	we look at a frame and a null period, so that we are sure
+//	that one full null period is in the buffer
+	inBuffer. resize	((T_F + T_null + T_u - 1) / T_u * T_u);
+	powerSpectrum. resize	(T_u);
+	segmentLevels. resize	(inBuffer. size () / segmentSize);
+	occupancy		= 0;
+	dipLevel		= 1;
+}
+
+	signalDetector::~signalDetector	() {
+}
+
+bool	signalDetector::signalPresent	() {
+	for (int i = 0; i < (int)inBuffer. size (); i += T_u)
+	   myReader -> getSamples (&inBuffer [i], T_u, 0);
+	compute_occupancy	();
+	compute_dipLevel	();
+	return (occupancy > OCCUPANCY_THRESHOLD) ||
+	                     (dipLevel < DIP_THRESHOLD);
+}
+
+float	signalDetector::get_occupancy	() {
+	return occupancy;
+}
+
+float	signalDetector::get_dipLevel	() {
+	return dipLevel;
+}
+//
+//	the average power of the bins carrying the "carriers" carriers
+//	is compared to the average power of the bins outside,
+//	where the bins adjacent to the edges of the ensemble are ignored
+void	signalDetector::compute_occupancy	() {
+int	guard	= (T_u - carriers) / 8;
+float	inBand	= 0;
+float	outBand	= 0;
+
+	for (int i = 0; i < T_u; i ++)
+	   powerSpectrum [i] = 0;
+	for (int block = 0; block < (int)inBuffer. size () / T_u; block ++) {
+	   memcpy (fft_buffer, &inBuffer [block * T_u],
+	                          T_u * sizeof (std::complex<float>));
+	   my_fftHandler. do_FFT ();
+	   for (int i = 0; i < T_u; i ++)
+	      powerSpectrum [i] += norm (fft_buffer [i]);
+	}
+
+	for (int i = 1; i <= carriers / 2; i ++)
+	   inBand += powerSpectrum [i] + powerSpectrum [T_u - i];
+	inBand	/= carriers;
+	for (int i = carriers / 2 + guard; i < T_u - carriers / 2 - guard; i ++)
+	   outBand += powerSpectrum [i];
+	outBand	/= T_u - carriers - 2 * guard;
+	occupancy	= outBand > 0 ? inBand / outBand : 0;
+}
+//
+//	The buffer is split into segments of T_null / 4 samples,
+//	a null period covers at least 3 subsequent segments.
+//	dipLevel is the lowest average over 3 subsequent segments,
+//	relative to the overall average
+void	signalDetector::compute_dipLevel	() {
+float	sum	= 0;
+float	minLevel;
+
+	for (int s = 0; s < (int)segmentLevels. size (); s ++) {
+	   float segSum	= 0;
+	   for (int i = 0; i < segmentSize; i ++)
+	      segSum += jan_abs (inBuffer [s * segmentSize + i]);
+	   segmentLevels [s] = segSum / segmentSize;
+	   sum	+= segmentLevels [s];
+	}
+	sum	/= segmentLevels. size ();
+	if (sum <= 0) {
+	   dipLevel	= 1;
+	   return;
+	}
+
+	minLevel	= sum;
+	for (int s = 0; s + 2 < (int)segmentLevels. size (); s ++) {
+	   float l = (segmentLevels [s] + segmentLevels [s + 1] +
+	                                  segmentLevels [s + 2]) / 3;
+	   if (l < minLevel)
+	      minLevel = l;
+	}
+	dipLevel	= minLevel / sum;
+}
+
@@ -0,0 +1,104 @@
+#
+/*
+ *    Copyright (C) 2013 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"tii-processor.h"
+#include	"process-params.h"
+#include	"dab-params.h"
+#include	"radio.h"
+//
+//	room for a few null periods, if the detector is lagging
+//	the null periods are dropped rather than waited for
+#define	NULL_BUFFERSIZE	32768
+
+	tiiProcessor::tiiProcessor (RadioInterface	*mr,
+	                            processParams	*p):
+	                              my_TII_Detector (p -> dabMode,
+	                                               p -> tii_depth),
+	                              nullBuffer (NULL_BUFFERSIZE) {
+dabParams	params (p -> dabMode);
+
+	this	-> tiiBuffer	= p -> tiiBuffer;
+	this	-> tii_delay	= p -> tii_delay;
+	this	-> T_u		= params. get_T_u ();
+	tii_counter		= 0;
+	theNull. resize (T_u);
+	resetRequest. store (false);
+	running. store (false);
+	connect (this, SIGNAL (show_tii (int, int, float)),
+	         mr, SLOT (show_tii (int, int, float)));
+	start ();
+}
+
+	tiiProcessor::~tiiProcessor	() {
+	stop ();
+}
+
+void	tiiProcessor::stop	() {
+	running. store (false);
+	while (isRunning ())
+	   wait (100);
+}
+//
+//	called from the dabProcessor, never blocks
+void	tiiProcessor::addNull	(const std::complex<float> *v) {
+	if (!my_TII_Detector. is_supported ())
+	   return;
+	if (nullBuffer. GetRingBufferWriteAvailable () < T_u)
+	   return;
+	nullBuffer. putDataIntoBuffer (v, T_u);
+	nullsAvailable. release (1);
+}
+//
+//	the detector itself is reset by the thread that uses it
+void	tiiProcessor::reset	() {
+	resetRequest. store (true);
+}
+
+void	tiiProcessor::run	() {
+	running. store (true);
+	while (running. load ()) {
+	   while (!nullsAvailable. tryAcquire (1, 200))
+	      if (!running. load ())
+	         return;
+	   if (resetRequest. load ()) {
+	      resetRequest. store (false);
+	      nullBuffer. AdvanceRingBufferReadIndex (
+	                         nullBuffer. GetRingBufferReadAvailable ());
+	      my_TII_Detector. reset ();
+	      tii_counter	= 0;
+	   }
+	   if (nullBuffer. GetRingBufferReadAvailable () < T_u)
+	      continue;
+	   nullBuffer. getDataFromBuffer (theNull. data (), T_u);
+	   my_TII_Detector. addBuffer (theNull);
+	   if (++tii_counter < tii_delay)
+	      continue;
+	   std::vector<tiiResult> res = my_TII_Detector. processNULL ();
+	   if (res. size () > 0)
+	      tiiBuffer -> putDataIntoBuffer (theNull. data (), T_u);
+	   for (auto &r : res)
+	      show_tii (r. mainId, r. subId, r. strength);
+	   tii_counter = 0;
+	   my_TII_Detector. reset ();
+	}
+}
@@ -24,7 +24,25 @@
 #include	"tii_detector.h"
 #include	<cstdio>
 #include	<cinttypes>
+#include	<cstring>
+#include	<algorithm>
+#ifdef	SSE_AVAILABLE
+#include	<xmmintrin.h>
+#endif
 //
+//	The TII comb consists of pairs of carriers, 8 groups of
+//	24 pairs (i.e. 384 carriers) that are repeated over the
+//	ensemble: 4 times in Mode I, twice in Mode IV and once
+//	in Mode II. Mode III has too few carriers for it.
+#define	NUM_GROUPS	8
+#define	GROUPSIZE	24
+#define	TII_PAIRS	(NUM_GROUPS * GROUPSIZE)
+//
+//	a pair counts as switched on if its value is over NOISE_FACTOR
+//	times the noise level of its group, and not more than
+//	30 dB below the strongest one
+#define	NOISE_FACTOR	5.0f
+#define	MIN_LEVEL	0.001f
 
 static
 uint8_t table [] = {
@@ -116,22 +134,93 @@ int16_t	i;
 	this	-> T_u		= params. get_T_u();
 	carriers		= params. get_carriers();
 	theBuffer. resize	(T_u);
+	pairBuffer. resize	(TII_PAIRS);
 	fft_buffer		= my_fftHandler. getVector();	
-	window. resize 		(T_u);
-	for (i = 0; i < T_u; i ++)
-	   window [i]  = (0.42 -
-	            0.5 * cos (2 * M_PI * (float)i / T_u) +
-	            0.08 * cos (4 * M_PI * (float)i / T_u));
-
+//
+//	Repetition r of the comb starts at carrier -K / 2 + 2 * TII_PAIRS * r,
+//	pair i of that repetition consists of carriers carr and carr + 1,
+//	with carr = start + 2 * i, skipping carrier 0.
+//	In the (not reordered) fft output, a repetition maps onto
+//	one or - if it contains carrier 0 - two contiguous runs,
+//	these runs are computed once here
+	for (int r = 0; r < carriers / (2 * TII_PAIRS); r ++) {
+	   int start	= - carriers / 2 + 2 * TII_PAIRS * r;
+	   int i	= 0;
+	   while (i < TII_PAIRS) {
+	      int carr		= start + 2 * i;
+	      tiiRun run;
+	      run. pairIndex	= i;
+	      run. fftIndex	= carr < 0 ? T_u + carr : carr + 1;
+	      run. length	= carr < 0 ?
+	                          std::min (TII_PAIRS - i, - carr / 2) :
+	                          TII_PAIRS - i;
+	      runs. push_back (run);
+	      i += run. length;
+	   }
+	}
+//
+//	only 70 of the 256 byte values are patterns (the ones with
+//	four bits set), all others are marked invalid
+	for (i = 0; i < 256; i ++)
+	   invTable [i] = 0xFF;
 	for (i = 0; i < 70; ++i) 
 	    invTable [table [i]] = i;
-	for (i = 71; i < 256; i ++)
-	   invTable [i] = -1;
 }
 
 		TII_Detector::~TII_Detector() {
 }
 
+//
+//	The vector operations on the spectra.
+//	With SSE available, 4 floats are handled at a time,
+//	the scalar loops handle the remainder (or everything)
+static inline
+void	addVector	(float *out, const float *in, int n) {
+int	i	= 0;
+#ifdef	SSE_AVAILABLE
+	for (; i + 4 <= n; i += 4)
+	   _mm_storeu_ps (out + i, _mm_add_ps (_mm_loadu_ps (out + i),
+	                                       _mm_loadu_ps (in + i)));
+#endif
+	for (; i < n; i ++)
+	   out [i] += in [i];
+}
+
+//
+//	for n subsequent pairs of carriers, starting at v, compute
+//	real (v [2 * i] * conj (v [2 * i + 1])).
+//	The two carriers of a pair carry the same phase, so for a
+//	pair that is switched on the product is positive (unless the
+//	timing is off by more than T_u / 4). Products of noise
+//	have a random sign, so the sign is kept here and these
+//	contributions cancel when the repetitions are summed
+static inline
+void	pairDots	(const std::complex<float> *v, int n, float *out) {
+const float *p	= (const float *)v;
+int	i	= 0;
+#ifdef	SSE_AVAILABLE
+	for (; i + 4 <= n; i += 4) {
+	   __m128 v0	= _mm_loadu_ps (p + 4 * i);
+	   __m128 v1	= _mm_loadu_ps (p + 4 * i + 4);
+	   __m128 v2	= _mm_loadu_ps (p + 4 * i + 8);
+	   __m128 v3	= _mm_loadu_ps (p + 4 * i + 12);
+//	p01 = re x0 * re y0, im x0 * im y0, re x1 * re y1, im x1 * im y1
+	   __m128 p01	= _mm_mul_ps (
+	                     _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (1, 0, 1, 0)),
+	                     _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (3, 2, 3, 2)));
+	   __m128 p23	= _mm_mul_ps (
+	                     _mm_shuffle_ps (v2, v3, _MM_SHUFFLE (1, 0, 1, 0)),
+	                     _mm_shuffle_ps (v2, v3, _MM_SHUFFLE (3, 2, 3, 2)));
+	   __m128 d	= _mm_add_ps (
+	                     _mm_shuffle_ps (p01, p23, _MM_SHUFFLE (2, 0, 2, 0)),
+	                     _mm_shuffle_ps (p01, p23, _MM_SHUFFLE (3, 1, 3, 1)));
+	   _mm_storeu_ps (out + i, d);
+	}
+#endif
+	for (; i < n; i ++)
+	   out [i] = p [4 * i] * p [4 * i + 2] +
+	                   p [4 * i + 1] * p [4 * i + 3];
+}
 
 void	TII_Detector::reset() {
 	for (int i = 0; i < T_u; i ++)
@@ -140,139 +229,149 @@ void	TII_Detector::reset() {
 
 //	To eliminate (reduce?) noise in the input signal, we might
 //	add a few spectra before computing (up to the user)
-void	TII_Detector::addBuffer (std::vector<std::complex<float>> v) {
+//	The null symbol is not windowed: any window spreads a pair over
+//	the neighbouring pairs, and the transmitters of an SFN may well
+//	have adjacent subIds. Without a window the carriers are
+//	orthogonal, the TII signal is periodic over the whole null period
+void	TII_Detector::addBuffer (const std::vector<std::complex<float>> &v) {
 int	i;
 
 	for (i = 0; i < T_u; i ++)
-	   fft_buffer [i] = cmul (v [i], window [i]);
+	   fft_buffer [i] = v [i];
 	my_fftHandler. do_FFT();
 
-	for (i = 0; i < T_u; i ++)
-	   theBuffer [i] += fft_buffer [i];
+	addVector ((float *)theBuffer. data (),
+	                 (const float *)fft_buffer, 2 * T_u);
 }
 //
-//	Note that the input is fft output, not yet reodered
-void	TII_Detector::collapse (std::complex<float> *inVec, float *outVec) {
-int	i;
-	for (i = 0; i < carriers / 8; i ++) {	
-	   int carr = - carriers / 2 + 2 * i;
-	   outVec [i] = abs (real (inVec [(T_u + carr) % T_u] *
-	                            conj (inVec [(T_u + carr + 1) % T_u])));
-	   carr	= - carriers / 2 + 1 * carriers / 4 + 2 * i;
-	   outVec [i] += abs (real (inVec [(T_u + carr) % T_u] *
-	                            conj (inVec [(T_u + carr + 1) % T_u])));
-	   carr	= - carriers / 2 + 2 * carriers / 4 + 2 * i + 1;
-	   outVec [i] += abs (real (inVec [(T_u + carr) % T_u] *
-	                            conj (inVec [(T_u + carr + 1) % T_u])));
-
-	   carr	= - carriers / 2 + 3 * carriers / 4 + 2 * i + 1;
-	   outVec [i] += abs (real (inVec [(T_u + carr) % T_u] *
-	                            conj (inVec [(T_u + carr + 1) % T_u])));
+//	Note that the input is fft output, not yet reodered.
+//	Each run of pairs is a contiguous range in the fft output,
+//	so it can be handled as a vector
+void	TII_Detector::collapse (const std::complex<float> *inVec,
+	                                             float *outVec) {
+	memset (outVec, 0, TII_PAIRS * sizeof (float));
+	for (auto &run : runs) {
+	   pairDots (&inVec [run. fftIndex], run. length, pairBuffer. data ());
+	   addVector (&outVec [run. pairIndex],
+	                                pairBuffer. data (), run. length);
 	}
 }
 
+bool	TII_Detector::is_supported	() {
+	return runs. size () > 0;
+}
+
 static
 uint8_t bits [] = {0x80, 0x40, 0x20, 0x10 , 0x08, 0x04, 0x02, 0x01};
 
-#define	NUM_GROUPS	8
-#define	GROUPSIZE	24
-uint16_t	TII_Detector::processNULL () {
+std::vector<tiiResult>	TII_Detector::processNULL () {
 int i, j;
-float	hulpTable	[NUM_GROUPS * GROUPSIZE]; // collapses values
-float	C_table		[GROUPSIZE];	// contains the values
+float	hulpTable	[TII_PAIRS];	// collapses values
 int	D_table		[GROUPSIZE];	// count of indices in C_table with data
-float	avgTable	[NUM_GROUPS];
+float	noiseTable	[NUM_GROUPS];
+std::vector<tiiResult> results;
+std::vector<float>	levels;
 
 //	we map the "carriers" carriers (complex values) onto
-//	a collapsed vector of "carriers / 8" length, 
+//	a collapsed vector of TII_PAIRS length, 
 //	considered to consist of 8 segments of 24 values
-//	Each "value" is the sum of 4 pairs of subsequent carriers,
-//	taken from the 4 quadrants -768 .. 385, 384 .. -1, 1 .. 384, 385 .. 768
+//	Each "value" is the sum of the pairs of subsequent carriers
+//	at the same position in the repetitions of the comb,
+//	for Mode I taken from -768 .. 385, 384 .. -1, 1 .. 384, 385 .. 768
+	if (!is_supported ())
+	   return results;
 
 	collapse (theBuffer. data(), hulpTable);
 //
-//	since the "energy levels" in the different GROUPSIZE'd values
-//	may differ, we compute an average for each of the
-//	NUM_GROUPS GROUPSIZE - value groups. 
-
-	memset (avgTable, 0, NUM_GROUPS * sizeof (float));
+//	since the noise levels in the different GROUPSIZE'd values
+//	may differ, we compute a level for each of the
+//	NUM_GROUPS GROUPSIZE - value groups.
+//	A pair that is switched on never gives a negative value,
+//	so the negative values are noise only. Unlike an average
+//	over the whole group, their level is not raised by the
+//	transmitters, strong ones would hide the weaker ones
+	float	maxValue	= 0;
 	for (i = 0; i < NUM_GROUPS; i ++) {
-	   avgTable [i] = 0;
-	   for (j = 0; j < GROUPSIZE; j ++) 
-	      avgTable [i] += hulpTable [i * GROUPSIZE + j];
-
-	   avgTable [i] /= GROUPSIZE;
+	   float *group	= &hulpTable [i * GROUPSIZE];
+	   float sum	= 0;
+	   int	count	= 0;
+	   for (j = 0; j < GROUPSIZE; j ++) {
+	      if (group [j] < 0) {
+	         sum	-= group [j];
+	         count	++;
+	      }
+	      else
+	      if (group [j] > maxValue)
+	         maxValue = group [j];
+	   }
+	   noiseTable [i] = count > 0 ? sum / count : 0;
 	}
+//	what is negative is not a pair that is switched on
+	for (i = 0; i < TII_PAIRS; i ++)
+	   if (hulpTable [i] < 0)
+	      hulpTable [i] = 0;
 //
-//	Determining the offset is then easy, look at the corresponding
-//	elements in the NUM_GROUPS sections and mark the highest ones.
-//	The summation of the high values are stored in the C_table,
-//	the number of times the limit is reached in the group
-//	is recorded in the D_table
-//
-//	So, basically we look into GROUPSIZE colums of NUMGROUPS
-//	values and look for the maximum
-//	Threshold 4 * avgTable is 6 dB, we consider that a minimum
-//	measurement shows that that is a reasonable value,
-//	alternatively, we could take the "minValue" as reference
-//	and "raise" the threshold. However, that might be
-//	too  much for 8-bit incoming values
+//	For each of the GROUPSIZE columns of NUM_GROUPS values,
+//	we count the number of values above the threshold of its group.
+//	A column with at least 4 of these values contains
+//	the comb of a transmitter.
+//	Unlike the "strongest only" approach, all columns
+//	meeting the constraint are taken into account,
+//	in an SFN the transmitters usually differ in the subId only
 	memset (D_table, 0, GROUPSIZE * sizeof (int));
-	memset (C_table, 0, GROUPSIZE * sizeof (float));
-//
-//	We gebruiken C en D table alleen maar om de begin offset
-//	te kunnen vinden
 	for (i = 0; i < GROUPSIZE; i ++) {
 	   for (j = 0; j < NUM_GROUPS; j ++) {
-	      if (hulpTable [j * GROUPSIZE + i] > 4 * avgTable [j]) {
-	         C_table [i] += hulpTable [j * GROUPSIZE + i];
+	      float threshold = std::max (NOISE_FACTOR * noiseTable [j],
+	                                  MIN_LEVEL * maxValue);
+	      if (hulpTable [j * GROUPSIZE + i] > threshold)
 	         D_table [i] ++;
-	      }
 	   }
 	}
 
-//	we extract from this result the highest values that
-//	meet the constraint of 4 values being sufficiently high
-	float	maxTable	= 0;
-	int	maxIndex	= -1;
-	
+	float	maxLevel	= 0;
 	for (j = 0; j < GROUPSIZE; j ++) {
-	   if ((D_table [j] >= 4) && (C_table [j] > maxTable)) {
-	      maxTable = C_table [j];
-	      maxIndex = j;
-	      break;
-	   }
-	}
+	   if (D_table [j] < 4)
+	      continue;
 //
-	if (maxIndex < 0)
-	   return 0;
-
 //	The - almost - final step is then to figure out which
-//	group contributed most, obviously only where maxIndex  > 0
-//	we start with collecting the values of the correct
-//	elements of the NUM_GROUPS groups
+//	groups contributed most, we extract the four max values as bits
+	   float x [NUM_GROUPS];
+	   for (i = 0; i < NUM_GROUPS; i ++) 
+	      x [i] = hulpTable [j + GROUPSIZE * i];
 
-	float x [NUM_GROUPS];
-	for (i = 0; i < NUM_GROUPS; i ++) 
-	   x [i] = hulpTable [maxIndex + GROUPSIZE * i];
-//
-//	we extract the four max values as bits
-	uint16_t pattern	= 0;
-	for (i = 0; i < 4; i ++) {
-	   float mmax	= 0;
-	   int ind		= -1;
-	   for (int k = 0; k < NUM_GROUPS; k ++) {
-	      if (x [k] > mmax) {
-	         mmax = x [k];
-	         ind  = k;
+	   uint16_t pattern	= 0;
+	   float level		= 0;
+	   for (i = 0; i < 4; i ++) {
+	      float mmax	= 0;
+	      int ind		= -1;
+	      for (int k = 0; k < NUM_GROUPS; k ++) {
+	         if (x [k] > mmax) {
+	            mmax = x [k];
+	            ind  = k;
+	         }
 	      }
-	   }
 
-	   if (ind != -1) {
-	      x [ind] = 0;
-	      pattern |= bits [ind];
+	      if (ind != -1) {
+	         x [ind] = 0;
+	         pattern |= bits [ind];
+	         level	+= mmax;
+	      }
 	   }
+	   if (invTable [pattern] == 0xFF)
+	      continue;
+	   tiiResult r;
+	   r. mainId	= invTable [pattern];
+	   r. subId	= j;
+	   results. push_back (r);
+	   levels. push_back (level);
+	   if (level > maxLevel)
+	      maxLevel = level;
 	}
-	return  maxIndex + (invTable [pattern]) * 256;
-}
 
+	for (i = 0; i < (int)results. size (); i ++)
+	   results [i]. strength = 10 * log10 (levels [i] / maxLevel);
+	std::sort (results. begin (), results. end (),
+	           [] (const tiiResult &a, const tiiResult &b) {
+	              return a. strength > b. strength; });
+	return results;
+}
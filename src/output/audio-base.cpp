@@ -34,10 +34,12 @@
 	                              converter_16 (16000, 48000, 2 * 1600),
 	                              converter_24 (24000, 48000, 2 * 2400),
 	                              converter_32 (32000, 48000, 2 * 3200) {
-	dumpFile		= nullptr;
+	dumper			= nullptr;
+	outBuffer. resize (2 * 8192);
 }
 
 	audioBase::~audioBase() {
+	stopDumping ();
 }
 
 void	audioBase::restart() {
@@ -48,137 +50,71 @@ void	audioBase::stop() {
 //
 //	This one is a hack for handling different baudrates coming from
 //	the aac decoder. call is from the GUI, triggered by the
-//	aac decoder or the mp3 decoder
+//	aac decoder or the mp3 decoder.
+//	The block - amount is the number of int16 values, i.e.
+//	2 * the number of stereo frames - is converted at once,
+//	other rates than 48000 are converted to 48000
 void	audioBase::audioOut	(int16_t *V, int32_t amount, int32_t rate) {
-//int16_t V [rate / 5];
+newConverter	*converter;
+int32_t	frames	= amount / 2;
+int32_t	result;
 
 	switch (rate) {
 	   case 16000:	
-	      audioOut_16000 (V, amount / 2);
-	      return;
+	      converter	= &converter_16;
+	      break;
 	   case 24000:
-	      audioOut_24000 (V, amount / 2);
-	      return;
+	      converter	= &converter_24;
+	      break;
 	   case 32000:
-	      audioOut_32000 (V, amount / 2);
-	      return;
+	      converter	= &converter_32;
+	      break;
 	   default:
 	   case 48000:
-	      audioOut_48000 (V, amount / 2);
-	      return;
-	}
-}
-//
-//	scale up from 16 -> 48
-//	amount gives number of pairs
-void	audioBase::audioOut_16000	(int16_t *V, int32_t amount) {
-std::complex<float> outputBuffer [converter_16. getOutputsize()];
-float      buffer       [2 * converter_16. getOutputsize()];
-int16_t	i, j;
-int32_t	result;
-
-	for (i = 0; i < amount; i ++)
-	   if (converter_16.
-	            convert (std::complex<float> (V [2 * i] / 32767.0,
-	                                          V [2 * i + 1] / 32767.0),
-	                              outputBuffer, &result)) {
-	      for (j = 0; j < result; j ++) {
-	         buffer [2 * j    ] = real (outputBuffer [j]);
-	         buffer [2 * j + 1] = imag (outputBuffer [j]);
-	      }
-	   
-	      myLocker. lock();
-	      if (dumpFile != nullptr)
-	         sf_writef_float (dumpFile, (float *)buffer, result);
-	      myLocker. unlock();
-
-	      audioOutput (buffer, result);
-	   }
-}
-
-//	scale up from 24000 -> 48000
-//	amount gives number of pairs
-void	audioBase::audioOut_24000	(int16_t *V, int32_t amount) {
-std::complex<float> outputBuffer [converter_24. getOutputsize()];
-float      buffer       [2 * converter_24. getOutputsize()];
-int16_t	i, j;
-int32_t	result;
-
-	for (i = 0; i < amount; i ++)
-	   if (converter_24.
-	            convert (std::complex<float> (V [2 * i] / 32767.0,
-	                                          V [2 * i + 1] / 32767.0),
-	                              outputBuffer, &result)) {
-	      for (j = 0; j < result; j ++) {
-	         buffer [2 * j    ] = real (outputBuffer [j]);
-	         buffer [2 * j + 1] = imag (outputBuffer [j]);
-	      }
-	   
-	      myLocker. lock();
-	      if (dumpFile != nullptr)
-	         sf_writef_float (dumpFile, (float *)buffer, result);
-	      myLocker. unlock();
-
-	      audioOutput (buffer, result);
-	   }
-}
-
-//	scale up from 32000 -> 48000
-//	amount is number of pairs
-void	audioBase::audioOut_32000	(int16_t *V, int32_t amount) {
-std::complex<float> outputBuffer [converter_32. getOutputsize()];
-float      buffer       [2 * converter_32. getOutputsize()];
-int32_t	i, j;
-int32_t	result;
-
-	for (i = 0; i < amount; i ++) {
-	   if (converter_32.
-	            convert (std::complex<float> (V [2 * i] / 32767.0,
-	                                          V [2 * i + 1] / 32767.0),
-	                              outputBuffer, &result)) {
-	      for (j = 0; j < result; j ++) {
-	         buffer [2 * j    ] = real (outputBuffer [j]);
-	         buffer [2 * j + 1] = imag (outputBuffer [j]);
-	      }
-	   
-	      myLocker. lock();
-	      if (dumpFile != nullptr)
-	         sf_writef_float (dumpFile, (float *)buffer, result);
-	      myLocker. unlock();
-//	      fprintf (stderr, "result %d\n", result);
-	      audioOutput (buffer, result);
-	   }
+	      converter	= nullptr;
+	      break;
 	}
-}
 
-void	audioBase::audioOut_48000	(int16_t *V, int32_t amount) {
-float *buffer = (float *)alloca (2 * amount * sizeof (float));
-int32_t	i;
-
-	for (i = 0; i < amount; i ++) {
-	   buffer [2 * i]	= V [2 * i] / 32767.0;
-	   buffer [2 * i + 1]	= V [2 * i + 1] / 32767.0;
+	int32_t needed	= converter == nullptr ? frames :
+	                               converter -> maxOutput (frames);
+	if ((int32_t)outBuffer. size () < 2 * needed)
+	   outBuffer. resize (2 * needed);
+	if (converter == nullptr) {
+	   newConverter::toFloat (V, outBuffer. data (), 2 * frames);
+	   result	= frames;
 	}
-
+	else
+	   result	= converter -> convert (V, frames, outBuffer. data ());
+	if (result <= 0)
+	   return;
+//
+//	the dumper is only a ringbuffer, the file is written elsewhere
 	myLocker. lock();
-	if (dumpFile != nullptr)
-	   sf_writef_float (dumpFile, (float *)buffer, amount);
+	if (dumper != nullptr)
+	   dumper -> putSamples (outBuffer. data (), result);
 	myLocker. unlock();
-	audioOutput (buffer, amount);
+	audioOutput (outBuffer. data (), result);
 }
 //
-//	we ensure that no one is fiddling with the dumpfile
-//	while we are writing
+//	we ensure that no one is fiddling with the dumper
+//	while the audio is passed to it
 void	audioBase::startDumping	(SNDFILE *f) {
+audioDumpWriter *d	= new audioDumpWriter (f);
 	myLocker. lock();
-	dumpFile	= f;
+	audioDumpWriter *old	= dumper;
+	dumper	= d;
 	myLocker. unlock();
+	delete old;
 }
-
+//
+//	deleting the dumper writes what is still in its buffer,
+//	the caller closes the file afterwards
 void	audioBase::stopDumping() {
 	myLocker. lock();
-	dumpFile	= nullptr;
+	audioDumpWriter *old	= dumper;
+	dumper	= nullptr;
 	myLocker. unlock();
+	delete old;
 }
 
 //
@@ -0,0 +1,82 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include	"audio-dump-writer.h"
+#include	<cstdio>
+//
+//	app 2 seconds of stereo audio at 48000, written
+//	in chunks of app 1/10 second
+#define	DUMP_BUFFER	(2 * 2 * 65536)
+#define	DUMP_CHUNK	(2 * 4800)
+
+	audioDumpWriter::audioDumpWriter	(SNDFILE *f):
+	                                   dumpBuffer (DUMP_BUFFER) {
+	dumpFile	= f;
+	droppedFrames. store (0);
+	running. store (true);
+	start ();
+}
+//
+//	what is in the buffer when stopping is still written
+	audioDumpWriter::~audioDumpWriter	() {
+	running. store (false);
+	wait ();
+	if (droppedFrames. load () > 0)
+	   fprintf (stderr, "audioDumpWriter: %d frames not written\n",
+	                                     droppedFrames. load ());
+}
+//
+//	amount is in (stereo) frames
+void	audioDumpWriter::putSamples	(const float *v, int32_t amount) {
+	if (dumpBuffer. GetRingBufferWriteAvailable () < 2 * amount) {
+	   droppedFrames. fetch_add (amount);
+	   return;
+	}
+	dumpBuffer. putDataIntoBuffer (v, 2 * amount);
+}
+
+int32_t	audioDumpWriter::dropped	() {
+	return droppedFrames. load ();
+}
+
+void	audioDumpWriter::run	() {
+std::vector<float> buffer (DUMP_CHUNK);
+
+	while (true) {
+	   bool stopping	= !running. load ();
+	   int32_t amount	= dumpBuffer. GetRingBufferReadAvailable ();
+	   if (amount > DUMP_CHUNK)
+	      amount = DUMP_CHUNK;
+	   amount	&= ~01;
+	   if (amount > 0) {
+	      dumpBuffer. getDataFromBuffer (buffer. data (), amount);
+	      sf_writef_float (dumpFile, buffer. data (), amount / 2);
+	   }
+	   if (amount == DUMP_CHUNK)
+	      continue;
+	   if (stopping)
+	      return;
+	   msleep (50);
+	}
+}
+
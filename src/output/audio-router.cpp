@@ -0,0 +1,368 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include	"audio-router.h"
+#include	"audio-base.h"
+#include	<cstdio>
+#include	<cstring>
+#include	<chrono>
+#include	<thread>
+//
+//	The ring of a route holds app 1.4 seconds of audio at 48000,
+//	a sink lagging more than half of it skips ahead.
+//	A gap of more than UNDERRUN_GAP msec in the input of a route
+//	that was running counts as an underrun, a DAB+ service delivers
+//	its audio per superframe, i.e. once per 120 msec
+#define	ROUTE_FRAMES	65536
+#define	MAX_LAG		(ROUTE_FRAMES / 2)
+#define	ROUTER_INTERVAL	20
+#define	UNDERRUN_GAP	300
+#define	MAX_PART	4096
+
+typedef	std::chrono::steady_clock	routeClock;
+//
+//	a routeOutput passes the audio of a route to its sink,
+//	the statistics are read by the router, hence the atomics
+class	routeOutput {
+public:
+			routeOutput	(audioRoute *, pcmSink *);
+			~routeOutput	();
+	pcmSink		*theSink;
+	std::atomic<int64_t>	frames;
+	std::atomic<int32_t>	underruns;
+	std::atomic<int64_t>	overrunFrames;
+	std::atomic<int64_t>	latencySum;
+	std::atomic<int32_t>	latencyCount;
+	std::atomic<int32_t>	maxLatency;
+private:
+	void		run		();
+	void		serve		();
+	audioRoute	*theRoute;
+	uint64_t	readPosition;
+	bool		fed;
+	bool		starved;
+	routeClock::time_point	lastData;
+	std::thread	threadHandle;
+	std::atomic<bool>	running;
+};
+//
+//	a frameOutput passes the encoded frames of a route to a
+//	compressed sink, in the thread of the processor
+class	frameOutput {
+public:
+			frameOutput	(pcmSink *s) {
+	   theSink	= s;
+	   sentFrames. store (0);
+	   droppedFrames. store (0);
+	}
+			~frameOutput	() {
+	   delete theSink;
+	}
+	pcmSink		*theSink;
+	std::atomic<int64_t>	sentFrames;
+	std::atomic<int64_t>	droppedFrames;
+};
+
+	fileSink::fileSink	(const QString &fileName) {
+	this	-> fileName	= fileName;
+	theFile		= nullptr;
+	fileRate	= 0;
+	failed		= false;
+}
+
+	fileSink::~fileSink	() {
+	if (theFile != nullptr)
+	   sf_close (theFile);
+}
+//
+//	a wav file has one rate, a change of rate is reported,
+//	the samples are written anyway
+void	fileSink::pcmOut	(const int16_t *v, int32_t n, int32_t rate) {
+	if (failed)
+	   return;
+	if (theFile == nullptr) {
+	   SF_INFO	sf_info;
+	   memset (&sf_info, 0, sizeof (sf_info));
+	   sf_info. samplerate	= rate;
+	   sf_info. channels	= 2;
+	   sf_info. format	= SF_FORMAT_WAV | SF_FORMAT_PCM_16;
+	   theFile	= sf_open (fileName. toUtf8 (). data (),
+	                                           SFM_WRITE, &sf_info);
+	   if (theFile == nullptr) {
+	      fprintf (stderr, "fileSink: cannot open %s\n",
+	                                 fileName. toUtf8 (). data ());
+	      failed	= true;
+	      return;
+	   }
+	   fileRate	= rate;
+	}
+	if (rate != fileRate) {
+	   fprintf (stderr, "fileSink: %s changes rate from %d to %d\n",
+	                     fileName. toUtf8 (). data (), fileRate, rate);
+	   fileRate	= rate;
+	}
+	sf_writef_short (theFile, v, n);
+}
+
+QString	fileSink::description	() {
+	return fileName;
+}
+
+	deviceSink::deviceSink	(audioBase *theDevice, const QString &name) {
+	this	-> theDevice	= theDevice;
+	this	-> name		= name;
+}
+
+	deviceSink::~deviceSink	() {
+	theDevice	-> stop ();
+	delete theDevice;
+}
+//
+//	audioOut takes the number of samples, not frames
+void	deviceSink::pcmOut	(const int16_t *v, int32_t n, int32_t rate) {
+	theDevice -> audioOut (const_cast<int16_t *>(v), 2 * n, rate);
+}
+
+QString	deviceSink::description	() {
+	return name;
+}
+
+	audioRoute::audioRoute	(const QString &service) {
+	this	-> service	= service;
+	theRing. resize (2 * ROUTE_FRAMES);
+	ringMask	= ROUTE_FRAMES - 1;
+	writePosition. store (0);
+	rate. store (48000);
+}
+
+	audioRoute::~audioRoute	() {
+	for (auto o : outputs)
+	   delete o;
+	for (auto f : frameSinks)
+	   delete f;
+}
+
+QString	audioRoute::serviceName	() {
+	return service;
+}
+//
+//	the samples are stored once, the write position is moved
+//	after the samples are in place
+void	audioRoute::putSamples	(const int16_t *v, int32_t n,
+	                                              int32_t rate) {
+uint64_t pos	= writePosition. load (std::memory_order_relaxed);
+uint64_t offset	= pos & ringMask;
+int32_t	first	= n < (int32_t)(ROUTE_FRAMES - offset) ?
+	                          n : (int32_t)(ROUTE_FRAMES - offset);
+
+	this	-> rate. store (rate);
+	memcpy (&theRing [2 * offset], v, 2 * first * sizeof (int16_t));
+	memcpy (theRing. data (), &v [2 * first],
+	                          2 * (n - first) * sizeof (int16_t));
+	writePosition. store (pos + n, std::memory_order_release);
+}
+
+void	audioRoute::putFrame	(const uint8_t *frame, int32_t length,
+	                                                   int kind) {
+	for (auto f : frameSinks) {
+	   int result	= f -> theSink -> frameOut (frame, length, kind);
+	   if (result == FRAME_SENT)
+	      f -> sentFrames. fetch_add (1, std::memory_order_relaxed);
+	   else
+	   if (result == FRAME_DROPPED)
+	      f -> droppedFrames. fetch_add (1, std::memory_order_relaxed);
+	}
+}
+
+void	audioRoute::putLabel	(const QString &label) {
+	for (auto f : frameSinks)
+	   f -> theSink -> labelOut (label);
+}
+
+bool	audioRoute::wantsPcm	() {
+	return outputs. size () > 0;
+}
+
+bool	audioRoute::wantsFrames	() {
+	return frameSinks. size () > 0;
+}
+
+//
+//	a new sink starts with the frames arriving after it is added
+	routeOutput::routeOutput	(audioRoute *r, pcmSink *s) {
+	theRoute	= r;
+	theSink		= s;
+	readPosition	= r -> writePosition. load ();
+	fed		= false;
+	starved		= false;
+	frames. store (0);
+	underruns. store (0);
+	overrunFrames. store (0);
+	latencySum. store (0);
+	latencyCount. store (0);
+	maxLatency. store (0);
+	running. store (true);
+	threadHandle	= std::thread (&routeOutput::run, this);
+}
+
+	routeOutput::~routeOutput	() {
+	running. store (false);
+	threadHandle. join ();
+	delete theSink;
+}
+
+void	routeOutput::run	() {
+	while (running. load ()) {
+	   serve ();
+	   std::this_thread::sleep_for
+	                  (std::chrono::milliseconds (ROUTER_INTERVAL));
+	}
+}
+//
+//	the latency is the amount of audio that is waiting for the
+//	sink at the moment a part is passed on.
+//	The audio is passed in parts of at most MAX_PART frames, the lag
+//	is checked for each part, so the decoder cannot overwrite what
+//	is being passed, unless the sink itself blocks for a long time
+void	routeOutput::serve	() {
+uint64_t w	= theRoute -> writePosition. load (std::memory_order_acquire);
+uint64_t available	= w - readPosition;
+int32_t	rate	= theRoute -> rate. load ();
+routeClock::time_point now	= routeClock::now ();
+
+	if (available == 0) {
+	   if (fed && !starved &&
+	       (std::chrono::duration_cast<std::chrono::milliseconds>
+	                 (now - lastData). count () > UNDERRUN_GAP)) {
+	      underruns. fetch_add (1);
+	      starved	= true;
+	   }
+	   return;
+	}
+	fed		= true;
+	starved		= false;
+	lastData	= now;
+	while (available > 0) {
+	   if (available > MAX_LAG) {
+	      overrunFrames. fetch_add (available);
+	      readPosition	= w;
+	      return;
+	   }
+	   int32_t latency	= available * 1000 / rate;
+	   latencySum. fetch_add (latency);
+	   latencyCount. fetch_add (1);
+	   if (latency > maxLatency. load ())
+	      maxLatency. store (latency);
+	   uint64_t offset	= readPosition & theRoute -> ringMask;
+	   uint64_t amount	= available;
+	   if (amount > ROUTE_FRAMES - offset)
+	      amount = ROUTE_FRAMES - offset;
+	   if (amount > MAX_PART)
+	      amount = MAX_PART;
+	   theSink -> pcmOut (&theRoute -> theRing [2 * offset], amount, rate);
+	   readPosition	+= amount;
+	   frames. fetch_add (amount);
+	   w		= theRoute -> writePosition.
+	                                  load (std::memory_order_acquire);
+	   available	= w - readPosition;
+	}
+}
+
+	audioRouter::audioRouter	() {
+}
+
+	audioRouter::~audioRouter	() {
+	for (auto r : theRoutes)
+	   delete r;
+}
+
+audioRoute	*audioRouter::addRoute	(const QString &service) {
+audioRoute	*r	= new audioRoute (service);
+	locker. lock ();
+	theRoutes. push_back (r);
+	locker. unlock ();
+	return r;
+}
+//
+//	precondition: the decoder of the service is gone
+void	audioRouter::removeRoute	(audioRoute *r) {
+	locker. lock ();
+	for (int i = 0; i < (int)theRoutes. size (); i ++)
+	   if (theRoutes [i] == r) {
+	      theRoutes. erase (theRoutes. begin () + i);
+	      break;
+	   }
+	locker. unlock ();
+	delete r;
+}
+
+//
+//	a compressed sink has no thread of its own, it gets the
+//	encoded frames as they come
+void	audioRouter::addSink	(audioRoute *r, pcmSink *s) {
+	locker. lock ();
+	if (s -> compressed ())
+	   r -> frameSinks. push_back (new frameOutput (s));
+	else
+	   r -> outputs. push_back (new routeOutput (r, s));
+	locker. unlock ();
+}
+
+std::vector<routeStats>	audioRouter::statistics	() {
+std::vector<routeStats> res;
+
+	locker. lock ();
+	for (auto r : theRoutes) {
+	   for (auto o : r -> outputs) {
+	      routeStats s;
+	      int32_t count	= o -> latencyCount. load ();
+	      s. service	= r -> service;
+	      s. sink		= o -> theSink -> description ();
+	      s. frames		= o -> frames. load ();
+	      s. underruns	= o -> underruns. load ();
+	      s. overrunFrames	= o -> overrunFrames. load ();
+	      s. droppedFrames	= 0;
+	      s. latency	= count == 0 ? 0 :
+	                             o -> latencySum. load () / count;
+	      s. maxLatency	= o -> maxLatency. load ();
+	      res. push_back (s);
+	   }
+//	for a compressed sink, the frames are the encoded frames
+//	it sent, the ones it could not send are dropped
+	   for (auto f : r -> frameSinks) {
+	      routeStats s;
+	      s. service	= r -> service;
+	      s. sink		= f -> theSink -> description ();
+	      s. frames		= f -> sentFrames. load ();
+	      s. underruns	= 0;
+	      s. overrunFrames	= 0;
+	      s. droppedFrames	= f -> droppedFrames. load ();
+	      s. latency	= 0;
+	      s. maxLatency	= 0;
+	      res. push_back (s);
+	   }
+	}
+	locker. unlock ();
+	return res;
+}
+
@@ -27,14 +27,27 @@
 #include	<QMessageBox>
 #include	<QComboBox>
 
+//
+//	the target fill level is 100 msec, skipping starts at three
+//	times the target. The ratio is never more than 2000 ppm
+//	away from 1, that is not audible
+#define	DEFAULT_LEVEL	100
+#define	MAX_CORRECTION	0.002
+
 	audioSink::audioSink	(int16_t latency):
-	                           _O_Buffer (8 * 32768) {
+	                           theRing (8 * 32768),
+	                           driftConverter (48000, 48000, 4800) {
 int32_t	i;
 	this	-> latency	= latency;
 	if (latency <= 0)
 	   latency = 1;
 
 	this	-> CardRate	= 48000;
+	underrunCount. store (0);
+	overrunCount. store (0);
+	missedFrames. store (0);
+	driftBuffer. resize (2 * 8192);
+	setTargetLevel (DEFAULT_LEVEL);
 	portAudio		= false;
 	writerRunning		= false;
 	if (Pa_Initialize() != paNoError) {
@@ -147,7 +160,7 @@ PaError err;
 	if (!Pa_IsStreamStopped (ostream))
 	   return;
 
-	_O_Buffer. FlushRingBuffer();
+	theRing. flush ();
 	paCallbackReturn = paContinue;
 	err = Pa_StartStream (ostream);
 	if (err == paNoError)
@@ -182,8 +195,6 @@ PaStreamParameters *outputParameters =
 /*
  * 	... and the callback
  */
-static	int	theMissed	= 0;
-
 int	audioSink::paCallback_o (
 		const void*			inputBuffer,
                 void*				outputBuffer,
@@ -191,33 +202,93 @@ int	audioSink::paCallback_o (
 		const PaStreamCallbackTimeInfo	*timeInfo,
 	        PaStreamCallbackFlags		statusFlags,
 	        void				*userData) {
-RingBuffer<float>	*outB;
 float	*outp		= (float *)outputBuffer;
 audioSink *ud		= reinterpret_cast <audioSink *>(userData);
-uint32_t	actualSize;
-uint32_t	i;
+int32_t	actualSize;
 	(void)statusFlags;
 	(void)inputBuffer;
 	(void)timeInfo;
 	if (ud -> paCallbackReturn == paContinue) {
-	   outB = &((reinterpret_cast < audioSink *> (userData)) -> _O_Buffer);
-	   actualSize = outB -> getDataFromBuffer (outp, 2 * framesPerBuffer);
-	   theMissed += 2 * framesPerBuffer - actualSize;
-	   for (i = actualSize; i < 2 * framesPerBuffer; i ++)
-	      outp [i] = 0;
+	   int32_t fill	= ud -> theRing. fill ();
+	   if (fill > ud -> maxLevel) {
+	      ud -> theRing. skip (fill - ud -> targetLevel);
+	      ud -> overrunCount. fetch_add (1, std::memory_order_relaxed);
+	   }
+	   actualSize = ud -> theRing. get (outp, framesPerBuffer);
+	   if (actualSize < (int32_t)framesPerBuffer) {
+	      int32_t shortage	= framesPerBuffer - actualSize;
+	      ud -> underrunCount. fetch_add (1, std::memory_order_relaxed);
+	      ud -> missedFrames. fetch_add (shortage,
+	                                       std::memory_order_relaxed);
+	      memset (&outp [2 * actualSize], 0, 2 * shortage * sizeof (float));
+	   }
 	}
 
 	return ud -> paCallbackReturn;
 }
 
 int32_t	audioSink::missed() {
-int32_t	h	= theMissed;
-	theMissed = 0;
-	return h / 2;
+	return missedFrames. exchange (0);
+}
+//
+//	the target level is in msec
+void	audioSink::setTargetLevel	(int32_t level) {
+	if (level < 20)
+	   level = 20;
+	targetLevel	= level * CardRate / 1000;
+	if (3 * targetLevel > theRing. capacity ())
+	   targetLevel = theRing. capacity () / 3;
+	maxLevel	= 3 * targetLevel;
+	smoothedFill	= targetLevel;
+	integral	= 0;
+	currentRatio. store (1.0);
+	driftConverter. setRatio (1.0);
+}
+
+void	audioSink::telemetry	(int32_t *underruns, int32_t *overruns,
+	                         int32_t *fillLevel, int32_t *ppm) {
+	*underruns	= underrunCount. load ();
+	*overruns	= overrunCount. load ();
+	*fillLevel	= theRing. fill () * 1000 / CardRate;
+	*ppm		= (int32_t)((currentRatio. load () - 1) * 1000000);
+}
+//
+//	The fill level, seen when writing, jumps with the size of the
+//	blocks written and read, it is smoothed first. The error is
+//	relative to the target, the integral takes care of the
+//	(constant) clock difference, the proportional part of the
+//	deviations. A full ring makes the ratio smaller, less
+//	samples are produced.
+//	As long as the correction is at its limit, the integral is
+//	not extended, otherwise it would take minutes to unwind it
+void	audioSink::adjustRatio	(int32_t amount) {
+double	error;
+double	dt	= (double)amount / CardRate;
+
+	smoothedFill	+= 0.02 * (theRing. fill () - smoothedFill);
+	error		= (smoothedFill - targetLevel) / targetLevel;
+	double correction	= 0.005 * error + 0.0005 * (integral + error * dt);
+	if (correction > MAX_CORRECTION)
+	   correction = MAX_CORRECTION;
+	else
+	if (correction < -MAX_CORRECTION)
+	   correction = -MAX_CORRECTION;
+	else
+	   integral += error * dt;
+	currentRatio. store (1 - correction);
+	driftConverter. setRatio (1 - correction);
 }
 
 void	audioSink::audioOutput	(float *b, int32_t amount) {
-	_O_Buffer. putDataIntoBuffer (b, 2 * amount);
+int32_t	needed	= driftConverter. maxOutput (amount);
+
+	adjustRatio (amount);
+	if ((int32_t)driftBuffer. size () < 2 * needed)
+	   driftBuffer. resize (2 * needed);
+	int32_t n	= driftConverter. convert (b, amount, driftBuffer. data ());
+	int32_t written	= theRing. put (driftBuffer. data (), n);
+	if (written < n)
+	   overrunCount. fetch_add (1);
 }
 
 QString audioSink::outputChannelwithRate (int16_t ch, int32_t rate) {
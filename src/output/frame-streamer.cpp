@@ -0,0 +1,94 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include	"frame-streamer.h"
+#include	<QByteArray>
+#include	<cstring>
+
+#define	HEADER_SIZE	8
+
+	frameStreamer::frameStreamer	(int port, bool withLabels,
+	                                 int policy) {
+	this	-> port		= port;
+	this	-> withLabels	= withLabels;
+	theStream	= streamServer::sharedServer () ->
+	                                 openStream (port, policy, 256 * 1024);
+}
+
+	frameStreamer::~frameStreamer	() {
+	streamServer::sharedServer () -> closeStream (theStream);
+}
+
+bool	frameStreamer::isOpen		() {
+	return theStream != nullptr;
+}
+
+QString	frameStreamer::description	() {
+	return QString (withLabels ? "frames:%1:labels" : "frames:%1").
+	                                                       arg (port);
+}
+//
+//	called from the thread of the processor, the server
+//	never waits, neither do we. Without clients the frame is
+//	just not sent, a frame that the server does not take - too
+//	large - is dropped. The clients may have left in between
+int	frameStreamer::frameOut	(const uint8_t *frame,
+	                                 int32_t length, int kind) {
+bool	sent;
+
+	if ((theStream == nullptr) || (theStream -> nrClients () == 0))
+	   return FRAME_IDLE;
+	if (!withLabels)
+	   sent	= theStream -> putData (frame, length);
+	else
+	   sent	= sendUnit (frame, length, kind);
+	if (sent)
+	   return FRAME_SENT;
+	return theStream -> nrClients () == 0 ? FRAME_IDLE : FRAME_DROPPED;
+}
+
+void	frameStreamer::labelOut	(const QString &label) {
+	if ((theStream == nullptr) || !withLabels ||
+	                         (theStream -> nrClients () == 0))
+	   return;
+	QByteArray text	= label. toUtf8 ();
+	sendUnit ((const uint8_t *)text. data (), text. size (), FRAME_LABEL);
+}
+//
+//	header and payload go as one unit
+bool	frameStreamer::sendUnit	(const uint8_t *data,
+	                                 int32_t length, int type) {
+	if (length > 0xFFFF)
+	   return false;
+	unit. resize (HEADER_SIZE + length);
+	unit [0]	= 0xFF;
+	unit [1]	= 0x00;
+	unit [2]	= 0xFF;
+	unit [3]	= 0x00;
+	unit [4]	= (length >> 8) & 0xFF;
+	unit [5]	= length & 0xFF;
+	unit [6]	= 0x00;
+	unit [7]	= type;
+	memcpy (&unit [HEADER_SIZE], data, length);
+	return theStream -> putData (unit. data (), HEADER_SIZE + length);
+}
@@ -23,6 +23,12 @@
 
 #include	"newconverter.h"
 #include	<cstdio>
+#ifdef	SSE_AVAILABLE
+#include	<emmintrin.h>
+#endif
+#ifdef	NEON_AVAILABLE
+#include	<arm_neon.h>
+#endif
 
 	newConverter::newConverter (int32_t inRate, int32_t outRate, 
 	                            int32_t inSize) {
@@ -36,45 +42,103 @@ int	err;
 //	converter		= src_new (SRC_SINC_BEST_QUALITY, 2, &err);
 	converter		= src_new (SRC_LINEAR, 2, &err);
 //	converter		= src_new (SRC_SINC_MEDIUM_QUALITY, 2, &err);
-	inBuffer.  resize (2 * inputLimit + 20);
-	outBuffer. resize (2 * outputLimit + 20);
-	src_data.  data_in	= inBuffer. data();
-	src_data.  data_out	= outBuffer. data();
+	inBuffer.  resize (2 * inputLimit);
 	src_data.  src_ratio	= ratio;
 	src_data.  end_of_input	= 0;
-	inp			= 0;
 }
 
 	newConverter::~newConverter() {
 	src_delete	(converter);
 }
+//
+//	the input is converted in parts of at most inputLimit frames,
+//	for each part libsamplerate writes directly into out.
+//	out should have room for maxOutput (nFrames) frames, the
+//	result is the number of frames written
+int32_t	newConverter::convert (const int16_t *in, int32_t nFrames,
+	                                                    float *out) {
+int32_t	framesOut	= 0;
 
-bool	newConverter::convert (std::complex<float> v,
-	                       std::complex<float> *out, int32_t *amount) {
-int32_t	i;
-int32_t	framesOut;
-int	res;
+	while (nFrames > 0) {
+	   int32_t n	= nFrames < inputLimit ? nFrames : inputLimit;
+	   toFloat (in, inBuffer. data (), 2 * n);
+	   int32_t res	= process (inBuffer. data (), n, &out [2 * framesOut]);
+	   if (res < 0)
+	      return framesOut;
+	   framesOut	+= res;
+	   in		+= 2 * n;
+	   nFrames	-= n;
+	}
+	return framesOut;
+}
 
-	inBuffer [2 * inp]	= real (v);
-	inBuffer [2 * inp + 1]	= imag (v);
-	inp ++;
-	if (inp < inputLimit)
-	   return false;
+int32_t	newConverter::convert (const float *in, int32_t nFrames,
+	                                                    float *out) {
+int32_t	res	= process (in, nFrames, out);
+	return res < 0 ? 0 : res;
+}
+//
+//	The ratio may be changed between calls, libsamplerate
+//	moves smoothly from the old to the new one
+void	newConverter::setRatio	(double ratio) {
+	this	-> ratio	= ratio;
+	src_data. src_ratio	= ratio;
+}
 
-	src_data.	input_frames	= inp;
-	src_data.	output_frames	= outputLimit + 10;
-	res		= src_process (converter, &src_data);
-	if (res != 0) {
-	   fprintf (stderr, "error %s\n", src_strerror (res));
-	   return false;
+int32_t	newConverter::process	(const float *in, int32_t nFrames,
+	                                                    float *out) {
+int32_t	framesOut	= 0;
+int	res;
+
+	src_data.	data_in		= in;
+	src_data.	input_frames	= nFrames;
+	while (src_data. input_frames > 0) {
+	   src_data.	data_out	= &out [2 * framesOut];
+	   src_data.	output_frames	= (int32_t)(nFrames * ratio) + 10;
+	   res	= src_process (converter, &src_data);
+	   if (res != 0) {
+	      fprintf (stderr, "error %s\n", src_strerror (res));
+	      return -1;
+	   }
+	   framesOut	+= src_data. output_frames_gen;
+	   src_data. data_in		+= 2 * src_data. input_frames_used;
+	   src_data. input_frames	-= src_data. input_frames_used;
+	   if (src_data. input_frames_used == 0)
+	      break;
+	}
+	return framesOut;
+}
+//
+//	with a changing ratio, the output may be slightly more
+//	than the current ratio suggests
+int32_t	newConverter::maxOutput	(int32_t nFrames) {
+	return (int32_t)(nFrames * ratio * 1.01) +
+	                     10 * (nFrames / inputLimit + 1) + 10;
+}
+//
+//	int16 to float, with the scaling of the original code
+void	newConverter::toFloat	(const int16_t *in, float *out, int32_t n) {
+int32_t	i	= 0;
+#if	defined (SSE_AVAILABLE)
+const __m128	scale	= _mm_set1_ps (1.0f / 32767);
+	for (; i + 8 <= n; i += 8) {
+	   __m128i x	= _mm_loadu_si128 ((const __m128i *)&in [i]);
+	   __m128i lo	= _mm_srai_epi32 (_mm_unpacklo_epi16 (x, x), 16);
+	   __m128i hi	= _mm_srai_epi32 (_mm_unpackhi_epi16 (x, x), 16);
+	   _mm_storeu_ps (&out [i],     _mm_mul_ps (_mm_cvtepi32_ps (lo), scale));
+	   _mm_storeu_ps (&out [i + 4], _mm_mul_ps (_mm_cvtepi32_ps (hi), scale));
+	}
+#elif	defined (NEON_AVAILABLE)
+	for (; i + 8 <= n; i += 8) {
+	   int16x8_t x	= vld1q_s16 (&in [i]);
+	   vst1q_f32 (&out [i], vmulq_n_f32 (vcvtq_f32_s32 (
+	                        vmovl_s16 (vget_low_s16 (x))), 1.0f / 32767));
+	   vst1q_f32 (&out [i + 4], vmulq_n_f32 (vcvtq_f32_s32 (
+	                        vmovl_s16 (vget_high_s16 (x))), 1.0f / 32767));
 	}
-	inp		= 0;
-	framesOut	= src_data.	output_frames_gen;
-	for (i = 0; i < framesOut; i ++)
-	   out [i] = std::complex<float> (outBuffer [2 * i],
-	                                  outBuffer [2 * i + 1]);
-	*amount		= framesOut;
-	return true;
+#endif
+	for (; i < n; i ++)
+	   out [i] = in [i] * (1.0f / 32767);
 }
 
 int32_t		newConverter::getOutputsize() {
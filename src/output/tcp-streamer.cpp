@@ -23,84 +23,40 @@
 
 #include	"tcp-streamer.h"
 
-		tcpStreamer::tcpStreamer	(int32_t port) {
-	buffer			= new RingBuffer<float> (2 * 32768);
-	this	-> port		= port;
-	connected		= false;
-//	Now for the communication
-	connect (&streamer, SIGNAL (newConnection (void)),
-	                this, SLOT (acceptConnection (void)));
-	streamer. listen (QHostAddress::Any, port);
-	connect (this, SIGNAL (handleSamples (void)),
-	         this, SLOT (processSamples (void)));
+		tcpStreamer::tcpStreamer	(int32_t port, int policy) {
+	theStream	= streamServer::sharedServer () ->
+	                                 openStream (port, policy, 256 * 1024);
 }
 
-		tcpStreamer::~tcpStreamer	(void) {
+		tcpStreamer::~tcpStreamer	() {
+	streamServer::sharedServer () -> closeStream (theStream);
 }
 
-void	tcpStreamer::acceptConnection (void) {
-	if (connected) {
-	   fprintf (stderr, "attempt to bind, but already occuppied\n");
-	   return;
-	}
-
-	streamerAddress = streamer. nextPendingConnection();
-	QHostAddress s = streamerAddress -> peerAddress();
-	fprintf (stderr, "Accepted a client %s\n", s.toString(). toLatin1(). data());
-	connected	= true;
-}
-
-//
-//	sendSamples is called and acts when we are connected
-
 #define	largeValue	32768.0
-#define	bufferSize	(2 * 4096)
+#define	UNIT_FRAMES	2048
 //
-//	
+//	an encoded sample takes 2 input values and delivers 4 bytes.
+//	The samples are passed to the server in units of at most
+//	UNIT_FRAMES frames, a client moving ahead stays on a frame
+//	boundary.
+//	It is assumed that the "sound values" do not exceed 16 bits
 void	tcpStreamer::audioOutput (float *b, int32_t amount) {
-	if (!connected)
+	if ((theStream == nullptr) || (theStream -> nrClients () == 0))
 	   return;
-	buffer -> putDataIntoBuffer (b, 2 * amount);
-	if (buffer -> GetRingBufferReadAvailable() > bufferSize)
-	   emit handleSamples();
-}
-
-
-void	tcpStreamer::processSamples (void) {
-QByteArray	datagram;
-float		localBuffer [bufferSize];
-int16_t	i;
-int32_t		amount;
-	if (!connected) {
-	   buffer -> FlushRingBuffer();
-	   return;
-	}
-//	an encoded sample takes 2 input values and delivers 4 bytes
-//	It is assumed that the "sound values" do not exceed 16 bits
-	datagram. resize (2 * bufferSize);
-	while (buffer -> GetRingBufferReadAvailable() > bufferSize) {
-	   amount = buffer -> getDataFromBuffer (localBuffer, bufferSize);
-	   for (i = 0; i < amount / 2; i ++) {
-	      int16_t re = localBuffer [2 * i] * largeValue;
-	      int16_t im = localBuffer [2 * i + 1] * largeValue;
-	      datagram [4 * i + 0] = ((re & 0xFF00) >>  8) & 0xFF;
-	      datagram [4 * i + 1] =  (re & 0x00FF) & 0xFF;
-
-	      datagram [4 * i + 2] = ((im & 0xFF00) >>  8) & 0xFF;
-	      datagram [4 * i + 3] =  (im & 0x00FF) & 0xFF;
+	sendBuffer. resize (4 * UNIT_FRAMES);
+	while (amount > 0) {
+	   int32_t n = amount < UNIT_FRAMES ? amount : UNIT_FRAMES;
+	   for (int i = 0; i < n; i ++) {
+	      int16_t re = b [2 * i] * largeValue;
+	      int16_t im = b [2 * i + 1] * largeValue;
+	      sendBuffer [4 * i + 0] = ((re & 0xFF00) >>  8) & 0xFF;
+	      sendBuffer [4 * i + 1] =  (re & 0x00FF) & 0xFF;
+	      sendBuffer [4 * i + 2] = ((im & 0xFF00) >>  8) & 0xFF;
+	      sendBuffer [4 * i + 3] =  (im & 0x00FF) & 0xFF;
 	   }
-
-	   if (streamerAddress -> state() ==
-	                   QAbstractSocket::UnconnectedState) {
-	      fprintf (stderr, "unconnected state\n");
-	      streamer. close();
-	      streamer. listen (QHostAddress::Any, port);
-	      connected	= false;
-	      return;
-	   }
-
-	   streamerAddress -> write (datagram. data(), datagram. size());
+	   theStream -> putData (sendBuffer. data (), 4 * n);
+	   b		+= 2 * n;
+	   amount	-= n;
 	}
 }
 
-
@@ -0,0 +1,84 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include	"udp-sink.h"
+#ifndef	__MINGW32__
+#include	<cstdio>
+#include	<cstring>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+#include	<netdb.h>
+#include	<unistd.h>
+
+#define	UDP_FRAMES	288
+
+	udpSink::udpSink	(const QString &host, int port) {
+struct addrinfo hints;
+struct addrinfo	*res;
+
+	this	-> host	= host;
+	this	-> port	= port;
+	socketDesc	= -1;
+	memset (&hints, 0, sizeof (hints));
+	hints. ai_family	= AF_UNSPEC;
+	hints. ai_socktype	= SOCK_DGRAM;
+	if (getaddrinfo (host. toUtf8 (). data (),
+	                 QString::number (port). toUtf8 (). data (),
+	                 &hints, &res) != 0) {
+	   fprintf (stderr, "udpSink: cannot resolve %s\n",
+	                                  host. toUtf8 (). data ());
+	   return;
+	}
+	socketDesc	= socket (res -> ai_family, SOCK_DGRAM, 0);
+	if (socketDesc >= 0) {
+	   address. resize (res -> ai_addrlen);
+	   memcpy (address. data (), res -> ai_addr, res -> ai_addrlen);
+	}
+	freeaddrinfo (res);
+}
+
+	udpSink::~udpSink	() {
+	if (socketDesc >= 0)
+	   close (socketDesc);
+}
+//
+//	a datagram that cannot be sent right now is lost,
+//	the sink never waits
+void	udpSink::pcmOut	(const int16_t *v, int32_t n, int32_t rate) {
+	(void)rate;
+	if (socketDesc < 0)
+	   return;
+	while (n > 0) {
+	   int32_t amount	= n < UDP_FRAMES ? n : UDP_FRAMES;
+	   sendto (socketDesc, v, 4 * amount, MSG_DONTWAIT,
+	           (const struct sockaddr *)address. data (), address. size ());
+	   v	+= 2 * amount;
+	   n	-= amount;
+	}
+}
+
+QString	udpSink::description	() {
+	return "udp:" + host + ":" + QString::number (port);
+}
+#endif
+
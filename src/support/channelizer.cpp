@@ -0,0 +1,180 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"channelizer.h"
+#include	<unistd.h>
+//
+//	DAB channels in Band III are not on a regular grid
+//	(e.g. 5D - 6A is 1.728 MHz apart, 12D - 13A only 1.696 MHz),
+//	so rather than a uniform FFT filterbank, each channel gets its
+//	own oscillator followed by a polyphase decimator
+	channelStream::channelStream (int32_t	inputRate,
+	                              int32_t	offset,
+	                              int32_t	bufferSize):
+	                                theBuffer (bufferSize),
+	                                theResampler (inputRate, INPUT_RATE) {
+	this	-> offset	= offset;
+	rotor			= std::complex<double> (1, 0);
+	rotorStep		= std::complex<double> (
+	                             cos (- 2 * M_PI * offset / inputRate),
+	                             sin (- 2 * M_PI * offset / inputRate));
+	running. store (true);
+}
+
+	channelStream::~channelStream	() {
+}
+
+void	channelStream::process	(const std::complex<float> *v,
+	                                         int32_t size) {
+int32_t	amount;
+
+	if (!running. load ())
+	   return;
+	if ((int32_t)mixBuffer. size () < size) {
+	   mixBuffer. resize (size);
+	   outBuffer. resize (theResampler. maxOutput (size));
+	}
+	for (int i = 0; i < size; i ++) {
+	   mixBuffer [i] = v [i] * std::complex<float> (real (rotor),
+	                                                   imag (rotor));
+	   rotor	*= rotorStep;
+	}
+//	keep the oscillator on the unit circle
+	rotor	/= abs (rotor);
+	amount	= theResampler. resample (mixBuffer. data (), size,
+	                                           outBuffer. data ());
+//
+//	If the dabProcessor for this channel is lagging, we wait,
+//	skipping samples would cost the synchronization
+	while (running. load () && (theBuffer. GetRingBufferWriteAvailable () < amount))
+	   usleep (1000);
+	theBuffer. putDataIntoBuffer (outBuffer. data (), amount);
+}
+
+	channelWorker::channelWorker	(QSemaphore *workDone) {
+	this	-> workDone	= workDone;
+	inVector		= nullptr;
+	inSize			= 0;
+	running. store (false);
+}
+
+	channelWorker::~channelWorker	() {
+	stop ();
+}
+
+void	channelWorker::addChannel	(channelStream *s) {
+	theChannels. push_back (s);
+}
+
+void	channelWorker::doWork		(const std::complex<float> *v,
+	                                         int32_t size) {
+	inVector	= v;
+	inSize		= size;
+	workToDo. release (1);
+}
+
+void	channelWorker::stop		() {
+	if (!isRunning ())
+	   return;
+	running. store (false);
+	workToDo. release (1);
+	while (isRunning ())
+	   usleep (1000);
+}
+
+void	channelWorker::run		() {
+	running. store (true);
+	while (true) {
+	   workToDo. acquire (1);
+	   if (!running. load ())
+	      break;
+	   for (auto s : theChannels)
+	      s -> process (inVector, inSize);
+	   workDone -> release (1);
+	}
+}
+
+	channelizer::channelizer (int32_t inputRate,
+	                          int32_t centerFrequency,
+	                          std::vector<int32_t> &frequencies,
+	                          int16_t nrWorkers) {
+	this	-> centerFrequency	= centerFrequency;
+	for (auto f : frequencies)
+	   theChannels. push_back (new channelStream (inputRate,
+	                                             f - centerFrequency,
+	                                             8 * 32768));
+	if (nrWorkers < 1)
+	   nrWorkers = 1;
+	if (nrWorkers > (int)theChannels. size ())
+	   nrWorkers = theChannels. size ();
+	for (int i = 0; i < nrWorkers; i ++)
+	   theWorkers. push_back (new channelWorker (&workDone));
+//
+//	the channels are distributed round robin over the workers
+	for (int i = 0; i < (int)theChannels. size (); i ++)
+	   theWorkers [i % nrWorkers] -> addChannel (theChannels [i]);
+	for (auto w : theWorkers)
+	   w -> start ();
+}
+
+	channelizer::~channelizer	() {
+	stop ();
+	for (auto w : theWorkers)
+	   delete w;
+	for (auto s : theChannels)
+	   delete s;
+}
+//
+//	all workers work on the same input vector, process
+//	returns when all of them are done with it
+void	channelizer::process	(const std::complex<float> *v,
+	                                      int32_t size) {
+	if (theWorkers. size () == 0)
+	   return;
+	for (auto w : theWorkers)
+	   w -> doWork (v, size);
+	workDone. acquire (theWorkers. size ());
+}
+
+int	channelizer::nrChannels	() {
+	return theChannels. size ();
+}
+
+int32_t	channelizer::channelFrequency	(int n) {
+	return centerFrequency + theChannels [n] -> offset;
+}
+
+RingBuffer<std::complex<float>> *channelizer::channelBuffer (int n) {
+	return &theChannels [n] -> theBuffer;
+}
+
+void	channelizer::dropChannel	(int n) {
+	theChannels [n] -> running. store (false);
+}
+
+void	channelizer::stop	() {
+	for (auto s : theChannels)
+	   s -> running. store (false);
+	for (auto w : theWorkers)
+	   w -> stop ();
+}
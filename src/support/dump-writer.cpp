@@ -0,0 +1,224 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"dump-writer.h"
+#include	<cstring>
+#include	<unistd.h>
+#ifdef	__linux__
+#include	<fcntl.h>
+#endif
+//
+//	on linux the space for the file is reserved in large
+//	chunks ahead of the writing, without changing the file size
+#define	RESERVE_SIZE	(64 * 1024 * 1024)
+
+static inline
+int32_t	ringSize	(int16_t n) {
+int32_t	res	= 1;
+	while (res <= n)
+	   res <<= 1;
+	return res;
+}
+
+	dumpWriter::dumpWriter	(int32_t blockSize, int16_t nrBlocks):
+	                            freeBlocks (ringSize (nrBlocks)),
+	                            fullBlocks (ringSize (nrBlocks)) {
+	this	-> blockSize	= blockSize;
+	this	-> nrBlocks	= nrBlocks;
+	currentBlock	= -1;
+	theFile		= nullptr;
+	theSndFile	= nullptr;
+	theIqzFile	= nullptr;
+	filePosition	= 0;
+	reservedUpto	= 0;
+	dropped. store (0);
+	active. store (false);
+	running. store (false);
+}
+
+	dumpWriter::~dumpWriter	() {
+	close ();
+	running. store (false);
+	while (isRunning ())
+	   wait (100);
+}
+//
+//	most owners never dump, so the blocks are only allocated
+//	- and the writer thread is only started - on the first open
+void	dumpWriter::prepare	() {
+	if (blocks. size () == 0) {
+	   blocks. resize ((int64_t)blockSize * nrBlocks);
+	   blockFill. resize (nrBlocks);
+	   for (int16_t i = 0; i < nrBlocks; i ++)
+	      freeBlocks. putDataIntoBuffer (&i, 1);
+	}
+	if (!isRunning ()) {
+	   running. store (true);
+	   start ();
+	}
+}
+
+void	dumpWriter::open	(FILE *f) {
+	close ();
+	theFile		= f;
+	filePosition	= ftell (f);
+	reservedUpto	= filePosition;
+	start_writing ();
+}
+
+void	dumpWriter::open	(SNDFILE *f) {
+	close ();
+	theSndFile	= f;
+	start_writing ();
+}
+
+//
+//	the samples for an iqz file are 16 bit I/Q pairs
+void	dumpWriter::open	(iqzWriter *f) {
+	close ();
+	theIqzFile	= f;
+	start_writing ();
+}
+
+void	dumpWriter::start_writing	() {
+	prepare ();
+	freeBlocks. getDataFromBuffer (&currentBlock, 1);
+	blockFill [currentBlock]	= 0;
+	dropped. store (0);
+	active. store (true);
+}
+//
+//	close hands over the current block and waits until the
+//	writer has written all blocks, after that the caller may
+//	close the file
+void	dumpWriter::close	() {
+	if (!active. load ())
+	   return;
+	producerLock. lock ();
+	active. store (false);
+	fullBlocks. putDataIntoBuffer (&currentBlock, 1);
+	blocksReady. release (1);
+	currentBlock	= -1;
+	producerLock. unlock ();
+	while (freeBlocks. GetRingBufferReadAvailable () < nrBlocks)
+	   usleep (1000);
+	if (theFile != nullptr)
+	   fflush (theFile);
+	theFile		= nullptr;
+	theSndFile	= nullptr;
+	theIqzFile	= nullptr;
+	if (dropped. load () > 0)
+	   fprintf (stderr, "dump: %lld bytes were dropped\n",
+	                            (long long)dropped. load ());
+}
+
+bool	dumpWriter::isOpen	() {
+	return active. load ();
+}
+
+int64_t	dumpWriter::droppedBytes	() {
+	return dropped. load ();
+}
+//
+//	called by the producer, never waits: if close is busy, or
+//	if the writer is behind and no free block is available, the
+//	(rest of the) data is ignored. The return value is the number
+//	of bytes that were actually taken, so the caller can keep
+//	its administration in line with what ends up in the file
+int32_t	dumpWriter::put	(const void *data, int32_t amount) {
+const uint8_t *p	= (const uint8_t *)data;
+int32_t	taken		= 0;
+
+	if (!active. load ())
+	   return 0;
+	if (!producerLock. tryLock ()) {
+	   dropped	+= amount;
+	   return 0;
+	}
+	if (!active. load ()) {
+	   producerLock. unlock ();
+	   return 0;
+	}
+	while (amount > 0) {
+	   if (blockFill [currentBlock] >= blockSize) {
+	      if (freeBlocks. GetRingBufferReadAvailable () == 0) {
+	         dropped	+= amount;
+	         break;
+	      }
+	      fullBlocks. putDataIntoBuffer (&currentBlock, 1);
+	      blocksReady. release (1);
+	      freeBlocks. getDataFromBuffer (&currentBlock, 1);
+	      blockFill [currentBlock]	= 0;
+	   }
+	   int32_t n	= blockSize - blockFill [currentBlock];
+	   if (n > amount)
+	      n = amount;
+	   memcpy (&blocks [(int64_t)currentBlock * blockSize +
+	                                   blockFill [currentBlock]], p, n);
+	   blockFill [currentBlock] += n;
+	   p		+= n;
+	   amount	-= n;
+	   taken	+= n;
+	}
+	producerLock. unlock ();
+	return taken;
+}
+
+void	dumpWriter::run	() {
+int16_t	block;
+
+	while (running. load ()) {
+	   while (!blocksReady. tryAcquire (1, 200))
+	      if (!running. load ())
+	         return;
+	   fullBlocks. getDataFromBuffer (&block, 1);
+	   writeBlock (block);
+	   freeBlocks. putDataIntoBuffer (&block, 1);
+	}
+}
+
+void	dumpWriter::writeBlock	(int16_t block) {
+const uint8_t *p	= &blocks [(int64_t)block * blockSize];
+int32_t	amount		= blockFill [block];
+
+	if (theSndFile != nullptr) {
+	   sf_write_short (theSndFile, (const int16_t *)p, amount / 2);
+	   return;
+	}
+	if (theIqzFile != nullptr) {
+	   theIqzFile -> add ((const int16_t *)p, amount / 4);
+	   return;
+	}
+	if (theFile == nullptr)
+	   return;
+#ifdef	__linux__
+	if (filePosition + amount > reservedUpto) {
+	   (void)fallocate (fileno (theFile), FALLOC_FL_KEEP_SIZE,
+	                    reservedUpto, RESERVE_SIZE);
+	   reservedUpto += RESERVE_SIZE;
+	}
+#endif
+	fwrite (p, 1, amount, theFile);
+	filePosition	+= amount;
+}
+
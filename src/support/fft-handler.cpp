@@ -22,25 +22,50 @@
  */
 #include	"fft-handler.h"
 #include	<cstring>
+#include	<map>
+#include	<utility>
+#include	<QMutex>
 //
 //	The basic idea was to have a single instance of the
 //	fftHandler, for all DFT's. Makes sense, since they are all
 //	of size T_u.
 //	However, in the concurrent version this does not work,
-//	it seems some locking there is inevitable
-//
+//	it seems some locking there is inevitable.
+//	What we do share is the plan: the fftw planner is not
+//	thread safe, executing a plan on different vectors is.
+//	The plans are never destroyed, there are only a few of them
+static	QMutex	planLocker;
+static	std::map<std::pair<int32_t, int>, FFTW_PLAN> thePlans;
+
+static
+FFTW_PLAN	getPlan	(int32_t size, int direction) {
+FFTW_PLAN	res;
+	planLocker. lock ();
+	std::map<std::pair<int32_t, int>, FFTW_PLAN>::iterator it =
+	                 thePlans. find (std::make_pair (size, direction));
+	if (it != thePlans. end ())
+	   res	= it -> second;
+	else {
+//	the vectors of the users are allocated by FFTW_MALLOC as well,
+//	so they have the alignment the plan was made for
+	   fftwf_complex *v	= (fftwf_complex *)
+	                  FFTW_MALLOC (sizeof (fftwf_complex) * size);
+	   res	= FFTW_PLAN_DFT_1D (size, v, v, direction, FFTW_ESTIMATE);
+	   FFTW_FREE (v);
+	   thePlans [std::make_pair (size, direction)] = res;
+	}
+	planLocker. unlock ();
+	return res;
+}
+
 	fftHandler::fftHandler (uint8_t mode): p (mode) {
 	this	-> fftSize = p. get_T_u();
 	vector	= (std::complex<float> *)
 	          FFTW_MALLOC (sizeof (std::complex<float>) * fftSize);
-	plan	= FFTW_PLAN_DFT_1D (fftSize,
-	                            reinterpret_cast <fftwf_complex *>(vector),
-	                            reinterpret_cast <fftwf_complex *>(vector),
-	                            FFTW_FORWARD, FFTW_ESTIMATE);
+	plan	= getPlan (fftSize, FFTW_FORWARD);
 }
 
 	fftHandler::~fftHandler() {
-	   FFTW_DESTROY_PLAN (plan);
 	   FFTW_FREE (vector);
 }
 
@@ -49,7 +74,8 @@ std::complex<float>	*fftHandler::getVector() {
 }
 
 void	fftHandler::do_FFT() {
-	FFTW_EXECUTE (plan);
+	FFTW_EXECUTE_DFT (plan, reinterpret_cast <fftwf_complex *>(vector),
+	                        reinterpret_cast <fftwf_complex *>(vector));
 }
 //
 //	Note that we do not scale here, not needed
@@ -59,7 +85,7 @@ int16_t i;
 
 	for (i = 0; i < fftSize; i ++)
 	   vector [i] = conj (vector [i]);
-	FFTW_EXECUTE (plan);
+	do_FFT ();
 	for (i = 0; i < fftSize; i ++)
 	   vector [i] = conj (vector [i]);
 }
@@ -72,14 +98,10 @@ int32_t	i;
 	vector	= (std::complex<float> *)FFTW_MALLOC (sizeof (std::complex<float>) * fft_size);
 	for (i = 0; i < fft_size; i ++)
 	   vector [i] = 0;
-	plan	= FFTW_PLAN_DFT_1D (fft_size,
-	                            reinterpret_cast <fftwf_complex *>(vector),
-	                            reinterpret_cast <fftwf_complex *>(vector),
-	                            FFTW_BACKWARD, FFTW_ESTIMATE);
+	plan	= getPlan (fft_size, FFTW_BACKWARD);
 }
 
 	common_ifft::~common_ifft() {
-	   FFTW_DESTROY_PLAN (plan);
 	   FFTW_FREE (vector);
 }
 
@@ -88,6 +110,7 @@ std::complex<float>	*common_ifft::getVector() {
 }
 
 void	common_ifft::do_IFFT() {
-	FFTW_EXECUTE	(plan);
+	FFTW_EXECUTE_DFT (plan, reinterpret_cast <fftwf_complex *>(vector),
+	                        reinterpret_cast <fftwf_complex *>(vector));
 }
 
@@ -156,13 +156,16 @@ QString	saveDir	 = dabSettings -> value ("saveDir_audioDump",
 	return theFile;
 }
 
-SNDFILE *findfileNames::findRawDump_fileName (const QString &deviceName,
-	                                       const QString &channelName) {
-SF_INFO *sf_info        = (SF_INFO *)alloca (sizeof (SF_INFO));
+//
+//	the raw dump is either an .sdr file (i.e. a wav file) or
+//	a compressed .iqz file, the extension tells
+const
+QString	findfileNames::findRawDump_fileName (const QString &deviceName,
+	                                     const QString &channelName) {
 QString theTime		= QDateTime::currentDateTime (). toString ();
 QString	saveDir		= dabSettings -> value ("saveDir_rawDump",
 	                                        QDir::homePath ()). toString ();
-SNDFILE	*theFile;
+QString	selectedFilter;
 	for (int i = 0; i < theTime. length (); i ++)
 	   if (!isValid (theTime. at (i)))
 	      theTime. replace (i, 1, '-');
@@ -176,32 +179,42 @@ SNDFILE	*theFile;
 	QString file = QFileDialog::getSaveFileName (nullptr,
 	                                             "Save file ...",
 	                                             suggestedFileName,
-	                                             "raw data (*.sdr)");
+	                                             "raw data (*.sdr);;compressed iq (*.iqz)",
+	                                             &selectedFilter);
 
 	if (file == QString (""))       // apparently cancelled
-	   return nullptr;
-	if (!file.endsWith (".sdr", Qt::CaseInsensitive))
+	   return "";
+	if (selectedFilter. contains ("iqz")) {
+	   if (file. endsWith (".sdr", Qt::CaseInsensitive))
+	      file. chop (4);
+	   if (!file. endsWith (".iqz", Qt::CaseInsensitive))
+	      file. append (".iqz");
+	}
+	else
+	if (!file.endsWith (".sdr", Qt::CaseInsensitive) &&
+	    !file.endsWith (".iqz", Qt::CaseInsensitive))
 	   file.append (".sdr");
 
-	file	= QDir::toNativeSeparators (file);
+	QString dumper	= QDir::fromNativeSeparators (file);
+	int x		= dumper. lastIndexOf ("/");
+	saveDir		= dumper. remove (x, dumper. count () - x);
+	dabSettings	-> setValue ("saveDir_rawDump", saveDir);
+	return QDir::toNativeSeparators (file);
+}
+
+SNDFILE	*findfileNames::open_rawDump	(const QString &file) {
+SF_INFO *sf_info        = (SF_INFO *)alloca (sizeof (SF_INFO));
+SNDFILE	*theFile;
+
 	sf_info -> samplerate   = INPUT_RATE;
 	sf_info -> channels     = 2;
 	sf_info -> format       = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
 	theFile = sf_open (file. toUtf8 (). data(),
 	                                   SFM_WRITE, sf_info);
-	fprintf (stderr, "the file %s is open?\n", 
-	                              file. toUtf8 (). data ());
 	if (theFile == nullptr) {
-	   fprintf (stderr, "foute boel\n");
 	   qDebug() << "cannot open " << file. toUtf8(). data();
 	   return nullptr;
 	}
-
-	QString dumper	= QDir::fromNativeSeparators (file);
-	int x		= dumper. lastIndexOf ("/");
-	saveDir		= dumper. remove (x, dumper. count () - x);
-	dabSettings	-> setValue ("saveDir_rawDump", saveDir);
-	fprintf (stderr, "theffile is open\n");
 	return theFile;
 }
 
@@ -0,0 +1,545 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"iqz-format.h"
+#include	<QStringList>
+#include	<cstring>
+//
+//	A residual is coded as the quotient (residual >> riceParameter),
+//	in unary, followed by the riceParameter low order bits.
+//	Quotients of ESCAPE and larger - only seen with very strong
+//	signals - are coded as ESCAPE ones followed by the plain value
+#define	ESCAPE		24
+#define	ESCAPE_BITS	24
+#define	MAX_RICE	20
+#define	FIXED_HEADER	30		// the header without the metadata
+#define	CHUNK_HEADER	12
+#define	TRAILER_SIZE	20
+
+static inline
+void	put16	(uint8_t *p, uint16_t v) {
+	p [0]	= v & 0xFF;
+	p [1]	= (v >> 8) & 0xFF;
+}
+
+static inline
+void	put32	(uint8_t *p, uint32_t v) {
+	for (int i = 0; i < 4; i ++)
+	   p [i] = (v >> (8 * i)) & 0xFF;
+}
+
+static inline
+void	put64	(uint8_t *p, uint64_t v) {
+	for (int i = 0; i < 8; i ++)
+	   p [i] = (v >> (8 * i)) & 0xFF;
+}
+
+static inline
+uint16_t get16	(const uint8_t *p) {
+	return p [0] | (p [1] << 8);
+}
+
+static inline
+uint32_t get32	(const uint8_t *p) {
+uint32_t res	= 0;
+	for (int i = 3; i >= 0; i --)
+	   res	= (res << 8) | p [i];
+	return res;
+}
+
+static inline
+uint64_t get64	(const uint8_t *p) {
+uint64_t res	= 0;
+	for (int i = 7; i >= 0; i --)
+	   res	= (res << 8) | p [i];
+	return res;
+}
+
+static inline
+uint32_t zigzag	(int32_t v) {
+	return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline
+int32_t	unzigzag	(uint32_t v) {
+	return (int32_t)(v >> 1) ^ -(int32_t)(v & 01);
+}
+
+class	bitWriter {
+public:
+	bitWriter	(std::vector<uint8_t> &out): out (out) {
+	   acc		= 0;
+	   nrBits	= 0;
+	}
+	void	put	(uint32_t v, int n) {
+	   acc		= (acc << n) | (v & (((uint64_t)1 << n) - 1));
+	   nrBits	+= n;
+	   while (nrBits >= 8) {
+	      nrBits	-= 8;
+	      out. push_back ((uint8_t)(acc >> nrBits));
+	   }
+	}
+	void	putResidual	(uint32_t u, int k) {
+	   uint32_t q	= u >> k;
+	   if (q < ESCAPE) {
+	      put (((1 << q) - 1) << 1, q + 1);
+	      if (k > 0)
+	         put (u, k);
+	   }
+	   else {
+	      put ((1 << ESCAPE) - 1, ESCAPE);
+	      put (u, ESCAPE_BITS);
+	   }
+	}
+	void	flush	() {
+	   if (nrBits > 0)
+	      out. push_back ((uint8_t)(acc << (8 - nrBits)));
+	   nrBits	= 0;
+	}
+private:
+	std::vector<uint8_t> &out;
+	uint64_t	acc;
+	int		nrBits;
+};
+
+class	bitReader {
+public:
+	bitReader	(const uint8_t *data, int32_t size) {
+	   this	-> data	= data;
+	   this	-> size	= size;
+	   pos		= 0;
+	   acc		= 0;
+	   nrBits	= 0;
+	}
+	uint32_t	get	(int n) {
+	   if (nrBits < n)
+	      refill ();
+	   nrBits	-= n;
+	   return (acc >> nrBits) & (((uint64_t)1 << n) - 1);
+	}
+	uint32_t	getResidual	(int k) {
+	   uint32_t q	= 0;
+	   while (q < ESCAPE) {
+	      if (nrBits == 0)
+	         refill ();
+	      nrBits --;
+	      if (((acc >> nrBits) & 01) == 0)
+	         break;
+	      q ++;
+	   }
+	   if (q == ESCAPE)
+	      return get (ESCAPE_BITS);
+	   return k > 0 ? (q << k) | get (k) : q;
+	}
+//	we allow the reader to run a few bytes over the end,
+//	the padding is zero, anything beyond is an error
+	bool	overrun	() {
+	   return pos > size + 8;
+	}
+private:
+	void	refill	() {
+	   while (nrBits <= 56) {
+	      acc	= (acc << 8) | (pos < size ? data [pos] : 0);
+	      pos ++;
+	      nrBits	+= 8;
+	   }
+	}
+	const uint8_t	*data;
+	int32_t		size;
+	int32_t		pos;
+	uint64_t	acc;
+	int		nrBits;
+};
+//
+//	the predictors of order 0, 1 and 2 are tried, the one
+//	with the smallest sum of (zigzagged) residuals is taken
+static
+int	selectOrder	(const int32_t *x, int32_t n, uint64_t *sum) {
+uint64_t sums [3]	= {0, 0, 0};
+int32_t	x1	= 0;
+int32_t	x2	= 0;
+int	best	= 0;
+	for (int i = 0; i < n; i ++) {
+	   sums [0]	+= zigzag (x [i]);
+	   sums [1]	+= zigzag (x [i] - x1);
+	   sums [2]	+= zigzag (x [i] - 2 * x1 + x2);
+	   x2	= x1;
+	   x1	= x [i];
+	}
+	for (int i = 1; i < 3; i ++)
+	   if (sums [i] < sums [best])
+	      best = i;
+	*sum	= sums [best];
+	return best;
+}
+
+static inline
+int32_t	residual	(const int32_t *x, int i, int order) {
+int32_t	x1	= i >= 1 ? x [i - 1] : 0;
+int32_t	x2	= i >= 2 ? x [i - 2] : 0;
+	switch (order) {
+	   default:
+	   case 0:	return x [i];
+	   case 1:	return x [i] - x1;
+	   case 2:	return x [i] - 2 * x1 + x2;
+	}
+}
+//
+//	the estimate from the mean is checked against its lower
+//	neighbour by computing the (exact) size of the coded residuals
+static
+int	selectRice	(const int32_t *x, int32_t n, int order, uint64_t sum) {
+int	k	= 0;
+	while ((k < MAX_RICE) && (((uint64_t)n << (k + 1)) <= sum))
+	   k ++;
+	if (k == 0)
+	   return 0;
+uint64_t cost [2]	= {0, 0};
+	for (int i = 0; i < n; i ++) {
+	   uint32_t u	= zigzag (residual (x, i, order));
+	   cost [0]	+= u >> (k - 1);
+	   cost [1]	+= u >> k;
+	}
+	return cost [0] + (uint64_t)n * (k - 1) < cost [1] + (uint64_t)n * k ?
+	                                                   k - 1 : k;
+}
+
+	iqzWriter::iqzWriter	(const QString &fileName,
+	                         int32_t sampleRate,
+	                         int32_t frequency,
+	                         int16_t nrBits,
+	                         const QString &metaData) {
+QByteArray meta	= metaData. toUtf8 ();
+std::vector<uint8_t> header (FIXED_HEADER + meta. size ());
+
+	theFile	= fopen (fileName. toUtf8 (). data (), "wb");
+	if (theFile == nullptr) {
+	   fprintf (stderr, "cannot open %s\n", fileName. toUtf8 (). data ());
+	   throw (31);
+	}
+	chunkSize	= sampleRate == 2048000 ? IQZ_CHUNKSIZE :
+	                             (int32_t)((int64_t)sampleRate * 96 / 1000);
+	chunkBuffer. resize (2 * chunkSize);
+	chunkFill	= 0;
+	nrSamples	= 0;
+
+	memcpy (&header [0], IQZ_MAGIC, 8);
+	put32 (&header [8],  header. size ());
+	put32 (&header [12], sampleRate);
+	put32 (&header [16], frequency);
+	put16 (&header [20], nrBits);
+	put32 (&header [22], chunkSize);
+	put32 (&header [26], meta. size ());
+	memcpy (&header [FIXED_HEADER], meta. data (), meta. size ());
+	fwrite (header. data (), 1, header. size (), theFile);
+	fileOffset	= header. size ();
+}
+
+	iqzWriter::~iqzWriter	() {
+	close ();
+}
+//
+//	nrSamples is in I/Q pairs
+void	iqzWriter::add	(const int16_t *data, int32_t n) {
+	if (theFile == nullptr)
+	   return;
+	while (n > 0) {
+	   int32_t amount = chunkSize - chunkFill;
+	   if (amount > n)
+	      amount = n;
+	   memcpy (&chunkBuffer [2 * chunkFill], data,
+	                               2 * amount * sizeof (int16_t));
+	   chunkFill	+= amount;
+	   data		+= 2 * amount;
+	   n		-= amount;
+	   if (chunkFill == chunkSize)
+	      writeChunk ();
+	}
+}
+
+void	iqzWriter::writeChunk	() {
+std::vector<int32_t> component [2];
+int	order [2];
+int	rice [2];
+uint8_t	header [CHUNK_HEADER];
+
+	if (chunkFill == 0)
+	   return;
+	for (int c = 0; c < 2; c ++) {
+	   uint64_t sum;
+	   component [c]. resize (chunkFill);
+	   for (int i = 0; i < chunkFill; i ++)
+	      component [c][i] = chunkBuffer [2 * i + c];
+	   order [c]	= selectOrder (component [c]. data (), chunkFill, &sum);
+	   rice [c]	= selectRice (component [c]. data (), chunkFill,
+	                                                 order [c], sum);
+	}
+
+	payload. resize (0);
+	payload. push_back (order [0]);
+	payload. push_back (rice [0]);
+	payload. push_back (order [1]);
+	payload. push_back (rice [1]);
+	bitWriter theBits (payload);
+	for (int i = 0; i < chunkFill; i ++)
+	   for (int c = 0; c < 2; c ++)
+	      theBits. putResidual (zigzag (residual (component [c]. data (),
+	                                              i, order [c])), rice [c]);
+	theBits. flush ();
+
+	memcpy (header, IQZ_CHUNK_MAGIC, 4);
+	put32 (&header [4], chunkFill);
+	put32 (&header [8], payload. size ());
+	fwrite (header, 1, CHUNK_HEADER, theFile);
+	fwrite (payload. data (), 1, payload. size (), theFile);
+	chunkOffsets. push_back (fileOffset);
+	chunkSamples. push_back (nrSamples);
+	fileOffset	+= CHUNK_HEADER + payload. size ();
+	nrSamples	+= chunkFill;
+	chunkFill	= 0;
+}
+//
+//	writes the remaining samples, the index and the trailer
+void	iqzWriter::close	() {
+	if (theFile == nullptr)
+	   return;
+	writeChunk ();
+	std::vector<uint8_t> index (16 * chunkOffsets. size () + TRAILER_SIZE);
+	for (int i = 0; i < (int)chunkOffsets. size (); i ++) {
+	   put64 (&index [16 * i], chunkOffsets [i]);
+	   put64 (&index [16 * i + 8], chunkSamples [i]);
+	}
+	uint8_t *trailer	= &index [16 * chunkOffsets. size ()];
+	put64 (trailer, fileOffset);
+	put32 (&trailer [8], chunkOffsets. size ());
+	memcpy (&trailer [12], IQZ_INDEX_MAGIC, 8);
+	fwrite (index. data (), 1, index. size (), theFile);
+	fclose (theFile);
+	theFile		= nullptr;
+}
+
+int64_t	iqzWriter::bytesWritten	() {
+	return fileOffset;
+}
+
+int64_t	iqzWriter::samplesWritten	() {
+	return nrSamples + chunkFill;
+}
+
+	iqzReader::iqzReader	(const QString &fileName) {
+uint8_t	header [FIXED_HEADER];
+
+	theFile	= fopen (fileName. toUtf8 (). data (), "rb");
+	if (theFile == nullptr) {
+	   fprintf (stderr, "cannot open %s\n", fileName. toUtf8 (). data ());
+	   throw (31);
+	}
+	if ((fread (header, 1, FIXED_HEADER, theFile) != FIXED_HEADER) ||
+	                  (memcmp (header, IQZ_MAGIC, 8) != 0)) {
+	   fprintf (stderr, "%s is not an iqz file\n",
+	                                  fileName. toUtf8 (). data ());
+	   fclose (theFile);
+	   throw (32);
+	}
+	headerSize	= get32 (&header [8]);
+	theRate		= get32 (&header [12]);
+	theFrequency	= get32 (&header [16]);
+	bitsperComponent	= get16 (&header [20]);
+	chunkSize	= get32 (&header [22]);
+	std::vector<char> meta (get32 (&header [26]) + 1);
+	meta [meta. size () - 1] = 0;
+	if (fread (meta. data (), 1, meta. size () - 1, theFile) !=
+	                                             meta. size () - 1) {
+	   fclose (theFile);
+	   throw (32);
+	}
+	theMetaData	= QString::fromUtf8 (meta. data ());
+	fseeko (theFile, 0, SEEK_END);
+	fileSize	= ftello (theFile);
+	if (!readIndex ())
+	   rebuildIndex ();
+	totalSamples	= 0;
+	if (chunkOffsets. size () > 0) {
+	   uint8_t h [CHUNK_HEADER];
+	   fseeko (theFile, chunkOffsets. back (), SEEK_SET);
+	   if (fread (h, 1, CHUNK_HEADER, theFile) == CHUNK_HEADER)
+	      totalSamples = chunkSamples. back () + get32 (&h [4]);
+	}
+}
+
+	iqzReader::~iqzReader	() {
+	fclose (theFile);
+}
+
+bool	iqzReader::readIndex	() {
+uint8_t	trailer [TRAILER_SIZE];
+
+	if (fileSize < headerSize + TRAILER_SIZE)
+	   return false;
+	fseeko (theFile, fileSize - TRAILER_SIZE, SEEK_SET);
+	if ((fread (trailer, 1, TRAILER_SIZE, theFile) != TRAILER_SIZE) ||
+	           (memcmp (&trailer [12], IQZ_INDEX_MAGIC, 8) != 0))
+	   return false;
+	int64_t	indexOffset	= get64 (trailer);
+	int32_t	n		= get32 (&trailer [8]);
+	if (indexOffset + 16 * (int64_t)n + TRAILER_SIZE != fileSize)
+	   return false;
+	std::vector<uint8_t> index (16 * n);
+	fseeko (theFile, indexOffset, SEEK_SET);
+	if (fread (index. data (), 1, index. size (), theFile) != index. size ())
+	   return false;
+	chunkOffsets. resize (n);
+	chunkSamples. resize (n);
+	for (int i = 0; i < n; i ++) {
+	   chunkOffsets [i]	= get64 (&index [16 * i]);
+	   chunkSamples [i]	= get64 (&index [16 * i + 8]);
+	}
+	return true;
+}
+//
+//	no (valid) trailer, the recording was probably interrupted.
+//	We walk over the chunks, a chunk that is not complete is ignored
+void	iqzReader::rebuildIndex	() {
+int64_t	offset	= headerSize;
+int64_t	sample	= 0;
+uint8_t	h [CHUNK_HEADER];
+
+	fprintf (stderr, "iqz file without index, rebuilding\n");
+	chunkOffsets. resize (0);
+	chunkSamples. resize (0);
+	while (offset + CHUNK_HEADER <= fileSize) {
+	   fseeko (theFile, offset, SEEK_SET);
+	   if ((fread (h, 1, CHUNK_HEADER, theFile) != CHUNK_HEADER) ||
+	                    (memcmp (h, IQZ_CHUNK_MAGIC, 4) != 0))
+	      break;
+	   int64_t next	= offset + CHUNK_HEADER + get32 (&h [8]);
+	   if (next > fileSize)
+	      break;
+	   chunkOffsets. push_back (offset);
+	   chunkSamples. push_back (sample);
+	   sample	+= get32 (&h [4]);
+	   offset	= next;
+	}
+}
+
+int32_t	iqzReader::sampleRate	() {
+	return theRate;
+}
+
+int32_t	iqzReader::frequency	() {
+	return theFrequency;
+}
+
+int16_t	iqzReader::nrBits	() {
+	return bitsperComponent;
+}
+
+QString	iqzReader::metaData	() {
+	return theMetaData;
+}
+
+QString	iqzReader::metaValue	(const QString &key) {
+QStringList lines	= theMetaData. split ('\n');
+	for (int i = 0; i < (int)lines. size (); i ++)
+	   if (lines [i]. startsWith (key + "="))
+	      return lines [i]. mid (key. size () + 1);
+	return "";
+}
+
+int64_t	iqzReader::nrSamples	() {
+	return totalSamples;
+}
+
+int32_t	iqzReader::nrChunks	() {
+	return chunkOffsets. size ();
+}
+//
+//	the chunk containing sample "sample", a binary search
+//	in the index
+int32_t	iqzReader::chunkFor	(int64_t sample) {
+int32_t	low	= 0;
+int32_t	high	= chunkOffsets. size () - 1;
+
+	if (high < 0)
+	   return -1;
+	while (low < high) {
+	   int32_t mid	= (low + high + 1) / 2;
+	   if ((int64_t)chunkSamples [mid] <= sample)
+	      low = mid;
+	   else
+	      high = mid - 1;
+	}
+	return low;
+}
+
+int64_t	iqzReader::chunkStart	(int32_t chunk) {
+	return chunkSamples [chunk];
+}
+//
+//	decodes the chunk into I/Q pairs, returns the number of
+//	pairs, or 0 if the chunk could not be read
+int32_t	iqzReader::readChunk	(int32_t chunk, std::vector<int16_t> &out) {
+uint8_t	h [CHUNK_HEADER];
+int32_t	order [2];
+int32_t	rice [2];
+int32_t	x1 [2]	= {0, 0};
+int32_t	x2 [2]	= {0, 0};
+
+	if ((chunk < 0) || (chunk >= (int32_t)chunkOffsets. size ()))
+	   return 0;
+	fseeko (theFile, chunkOffsets [chunk], SEEK_SET);
+	if ((fread (h, 1, CHUNK_HEADER, theFile) != CHUNK_HEADER) ||
+	                      (memcmp (h, IQZ_CHUNK_MAGIC, 4) != 0))
+	   return 0;
+	int32_t n	= get32 (&h [4]);
+	payload. resize (get32 (&h [8]));
+	if ((payload. size () < 4) ||
+	    (fread (payload. data (), 1, payload. size (), theFile) !=
+	                                               payload. size ()))
+	   return 0;
+	for (int c = 0; c < 2; c ++) {
+	   order [c]	= payload [2 * c];
+	   rice [c]	= payload [2 * c + 1];
+	   if ((order [c] > 2) || (rice [c] > MAX_RICE))
+	      return 0;
+	}
+
+	out. resize (2 * n);
+	bitReader theBits (&payload [4], payload. size () - 4);
+	for (int i = 0; i < n; i ++) {
+	   for (int c = 0; c < 2; c ++) {
+	      int32_t e	= unzigzag (theBits. getResidual (rice [c]));
+	      int32_t x;
+	      switch (order [c]) {
+	         default:
+	         case 0:	x = e; break;
+	         case 1:	x = e + x1 [c]; break;
+	         case 2:	x = e + 2 * x1 [c] - x2 [c]; break;
+	      }
+	      x2 [c]	= x1 [c];
+	      x1 [c]	= x;
+	      out [2 * i + c] = x;
+	   }
+	}
+	return theBits. overrun () ? 0 : n;
+}
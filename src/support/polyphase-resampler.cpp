@@ -0,0 +1,206 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2020
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#
+#include	"polyphase-resampler.h"
+#include	<cstring>
+#include	<map>
+#include	<utility>
+#include	<QMutex>
+#ifdef	SSE_AVAILABLE
+#include	<xmmintrin.h>
+#endif
+//
+//	The transition band of the filter is app a quarter of the
+//	lowest rate, for a DAB signal, sampled at 2048000, that
+//	leaves the 1536000 Hz of the ensemble untouched
+#define	TRANSITION	0.25
+//
+//	A filterBank contains the NR_PHASES subfilters for a pair of
+//	rates. Per phase the coefficients are stored in reversed order,
+//	each coefficient twice, so that the output sample is a plain
+//	dot product of the coefficients with the I/Q values
+//	of the last tapsperPhase input samples
+class	filterBank {
+public:
+			filterBank	(int32_t inRate, int32_t outRate);
+	int16_t		tapsperPhase;
+	std::vector<float>	coefficients;
+};
+
+	filterBank::filterBank	(int32_t inRate, int32_t outRate) {
+int32_t	lowRate		= inRate < outRate ? inRate : outRate;
+int32_t	highRate	= inRate < outRate ? outRate : inRate;
+int	filterSize;
+double	cutOff;
+double	sum		= 0;
+//
+//	a Blackman window needs app 5.5 / N for its transition band,
+//	an even number of taps makes the dot product a multiple of 4 floats
+	tapsperPhase	= (int16_t)(5.5 * highRate /
+	                                    (TRANSITION * lowRate) + 1);
+	if (tapsperPhase < 16)
+	   tapsperPhase = 16;
+	tapsperPhase	= (tapsperPhase + 1) & ~01;
+	filterSize	= tapsperPhase * NR_PHASES;
+//
+//	the prototype filter runs at NR_PHASES * inRate
+	cutOff		= 0.5 * lowRate / ((double)inRate * NR_PHASES);
+	std::vector<double> proto (filterSize);
+	for (int i = 0; i < filterSize; i ++) {
+	   double t	= i - (filterSize - 1) / 2.0;
+	   double sinc	= t == 0 ? 2 * cutOff :
+	                     sin (2 * M_PI * cutOff * t) / (M_PI * t);
+	   double w	= 0.42 - 0.5 * cos (2 * M_PI * i / (filterSize - 1)) +
+	                   0.08 * cos (4 * M_PI * i / (filterSize - 1));
+	   proto [i]	= sinc * w;
+	   sum		+= proto [i];
+	}
+//
+//	each of the subfilters should have a gain of (app) 1,
+//	coefficient j of a phase applies to the input sample
+//	j positions back
+	coefficients. resize (2 * filterSize);
+	for (int phase = 0; phase < NR_PHASES; phase ++) {
+	   float *f	= &coefficients [2 * phase * tapsperPhase];
+	   for (int j = 0; j < tapsperPhase; j ++) {
+	      float c	= proto [j * NR_PHASES + phase] * NR_PHASES / sum;
+	      f [2 * (tapsperPhase - 1 - j)]	= c;
+	      f [2 * (tapsperPhase - 1 - j) + 1]	= c;
+	   }
+	}
+}
+//
+//	The banks are never deleted, there are only a few
+//	of them and they may be used from different threads
+static	QMutex	bankLocker;
+static	std::map<std::pair<int32_t, int32_t>, filterBank *> theBanks;
+
+static
+const filterBank	*getBank	(int32_t inRate, int32_t outRate) {
+filterBank	*res;
+	bankLocker. lock ();
+	std::map<std::pair<int32_t, int32_t>, filterBank *>::iterator it =
+	                 theBanks. find (std::make_pair (inRate, outRate));
+	if (it != theBanks. end ())
+	   res	= it -> second;
+	else {
+	   res	= new filterBank (inRate, outRate);
+	   theBanks [std::make_pair (inRate, outRate)] = res;
+	}
+	bankLocker. unlock ();
+	return res;
+}
+
+	polyphaseResampler::polyphaseResampler (int32_t inRate,
+	                                        int32_t outRate) {
+	this	-> inRate	= inRate;
+	this	-> outRate	= outRate;
+	theBank		= getBank (inRate, outRate);
+	tapsperPhase	= theBank -> tapsperPhase;
+	step		= (uint64_t)((double)inRate / outRate *
+	                                         ((uint64_t)1 << 32));
+	reset ();
+}
+
+	polyphaseResampler::~polyphaseResampler	() {
+}
+
+void	polyphaseResampler::reset	() {
+	workBuffer. resize (tapsperPhase - 1);
+	for (int i = 0; i < tapsperPhase - 1; i ++)
+	   workBuffer [i] = std::complex<float> (0, 0);
+	position	= (uint64_t)(tapsperPhase - 1) << 32;
+}
+
+int16_t	polyphaseResampler::get_tapsperPhase	() {
+	return tapsperPhase;
+}
+//
+//	an upper bound for the number of samples resulting from
+//	n input samples
+int32_t	polyphaseResampler::maxOutput	(int32_t n) {
+	return (int32_t)((int64_t)n * outRate / inRate) + 2;
+}
+//
+//	the dot product of n (a multiple of 4) floats,
+//	the even elements give the I, the odd ones the Q component
+static inline
+std::complex<float> dotProduct	(const float *f, const float *x, int n) {
+#ifdef	SSE_AVAILABLE
+__m128	acc0	= _mm_setzero_ps ();
+__m128	acc1	= _mm_setzero_ps ();
+float	part [4];
+int	i	= 0;
+	for (; i + 8 <= n; i += 8) {
+	   acc0	= _mm_add_ps (acc0, _mm_mul_ps (_mm_loadu_ps (f + i),
+	                                        _mm_loadu_ps (x + i)));
+	   acc1	= _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (f + i + 4),
+	                                        _mm_loadu_ps (x + i + 4)));
+	}
+	for (; i < n; i += 4)
+	   acc0	= _mm_add_ps (acc0, _mm_mul_ps (_mm_loadu_ps (f + i),
+	                                        _mm_loadu_ps (x + i)));
+	_mm_storeu_ps (part, _mm_add_ps (acc0, acc1));
+	return std::complex<float> (part [0] + part [2], part [1] + part [3]);
+#else
+float	acc [4]	= {0, 0, 0, 0};
+	for (int i = 0; i < n; i += 4)
+	   for (int k = 0; k < 4; k ++)
+	      acc [k] += f [i + k] * x [i + k];
+	return std::complex<float> (acc [0] + acc [2], acc [1] + acc [3]);
+#endif
+}
+//
+//	the output sample at (fractional) position t in the
+//	workBuffer is computed from the input samples at
+//	floor (t), floor (t) - 1, ..., using the subfilter selected
+//	by the fraction of t
+int32_t	polyphaseResampler::resample	(const std::complex<float> *in,
+	                                 int32_t	nIn,
+	                                 std::complex<float> *out) {
+int32_t	nOut	= 0;
+int32_t	history	= tapsperPhase - 1;
+const float *bank	= theBank -> coefficients. data ();
+
+	workBuffer. resize (history + nIn);
+	memcpy (&workBuffer [history], in, nIn * sizeof (std::complex<float>));
+	const float *x	= reinterpret_cast<const float *>(workBuffer. data ());
+
+	while ((int32_t)(position >> 32) < history + nIn) {
+	   int32_t index	= position >> 32;
+	   int32_t phase	= (position >> (32 - PHASE_BITS)) &
+	                                               (NR_PHASES - 1);
+	   out [nOut ++] = dotProduct (&bank [2 * phase * tapsperPhase],
+	                               &x [2 * (index - history)],
+	                               2 * tapsperPhase);
+	   position	+= step;
+	}
+//
+//	keep the last tapsperPhase - 1 samples as history
+	memmove (workBuffer. data (), &workBuffer [nIn],
+	                   history * sizeof (std::complex<float>));
+	workBuffer. resize (history);
+	position	-= (uint64_t)nIn << 32;
+	return nOut;
+}
+
@@ -0,0 +1,284 @@
+#
+/*
+ *    Copyright (C) 2014 .. 2017
+ *    Jan van Katwijk (J.vanKatwijk@gmail.com)
+ *    Lazy Chair Computing
+ *
+ *    This file is part of the Qt-DAB program
+ *
+ *    Qt-DAB is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    Qt-DAB is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with Qt-DAB; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *	tiiTester synthesises the null symbols of an SFN with a number
+ *	of transmitters, for each of the DAB modes, and checks that
+ *	the TII_Detector finds them, it reports the hit rate and the
+ *	time taken by processNULL.
+ *	Next to random SFNs, a few fixed cases are tried: adjacent
+ *	subIds (also across two groups), and transmitters sharing a
+ *	mainId. A trial only counts as detected if the results are
+ *	exactly the transmitters, no more (ghosts), no less.
+ *	The exit status is non zero if, for one of the supported modes,
+ *	less than 95 percent of the trials of a case were detected
+ *	correctly
+ */
+#include	<cstdio>
+#include	<cstdlib>
+#include	<cmath>
+#include	<chrono>
+#include	<random>
+#include	<vector>
+#include	"dab-constants.h"
+#include	"dab-params.h"
+#include	"fft-handler.h"
+#include	"tii_detector.h"
+#include	"phasetable.h"
+
+#define	NUM_GROUPS	8
+#define	GROUPSIZE	24
+#define	TII_PAIRS	(NUM_GROUPS * GROUPSIZE)
+#define	MAX_TX		4
+
+class	transmitter {
+public:
+	int	mainId;
+	int	subId;
+	float	amplitude;
+	float	phase;
+	int	delay;		// in samples
+};
+//
+//	the fixed cases, the transmitters get weaker by 3 dB each
+class	testCase {
+public:
+	const char	*name;
+	int		mainId;
+	std::vector<int>	subIds;
+};
+
+static
+std::vector<testCase> fixedCases = {
+	{"adjacent subIds",		5,	{3, 4}},
+	{"adjacent over groups",	12,	{23, 0}},
+	{"three adjacent subIds",	40,	{8, 7, 9}},
+	{"shared mainId",		0,	{1, 13}},
+	{"shared mainId, four",		69,	{20, 2, 21, 11}}
+};
+//
+//	the patterns of the mainIds are the 70 bytes with 4 bits set,
+//	in increasing order
+static
+uint8_t	pattern		(int mainId) {
+int	n	= 0;
+	for (int v = 0; v < 256; v ++) {
+	   int bits = 0;
+	   for (int b = 0; b < 8; b ++)
+	      if (v & (1 << b))
+	         bits ++;
+	   if (bits != 4)
+	      continue;
+	   if (n == mainId)
+	      return v;
+	   n ++;
+	}
+	return 0;
+}
+//
+//	As in EN 300 401 (14.8), the comb of a transmitter is in
+//	group b (i.e. bit 7 - b of the pattern) at the carrier pairs
+//	k, k + 1 with k = - K / 2 + 2 * subId + 48 * b + 2 * TII_PAIRS * z,
+//	for the repetitions z. Carrier 0 is not used, so from there on
+//	the carriers shift up by one. Both carriers of a pair get the
+//	phase of carrier k in the phase reference symbol. The phase and
+//	the delay of the transmitter rotate all its carriers.
+//	Carrier k > 0 is at fft index k, k < 0 at T_u + k
+static
+void	synthesize	(dabParams &params,
+	                 phaseTable &phases,
+	                 fftHandler &ifft,
+	                 const std::vector<transmitter> &tx,
+	                 float snr,
+	                 std::mt19937 &gen,
+	                 std::vector<std::complex<float>> &out) {
+int	T_u		= params. get_T_u ();
+int	K		= params. get_carriers ();
+std::complex<float> *v	= ifft. getVector ();
+std::normal_distribution<float> noise (0, 1);
+
+	for (int i = 0; i < T_u; i ++)
+	   v [i] = std::complex<float> (0, 0);
+	for (auto &t : tx) {
+	   uint8_t p	= pattern (t. mainId);
+	   for (int z = 0; z < K / (2 * TII_PAIRS); z ++) {
+	      for (int b = 0; b < NUM_GROUPS; b ++) {
+	         if ((p & (0x80 >> b)) == 0)
+	            continue;
+	         int k	= - K / 2 + 2 * t. subId + 48 * b + 2 * TII_PAIRS * z;
+	         if (k >= 0)
+	            k ++;
+	         float phi	= phases. get_Phi (k);
+	         for (int c = k; c <= k + 1; c ++) {
+	            float rot	= t. phase - 2 * M_PI * c * t. delay / T_u;
+	            v [c < 0 ? T_u + c : c] +=
+	                          std::polar (t. amplitude, phi + rot);
+	         }
+	      }
+	   }
+	}
+	ifft. do_IFFT ();
+
+	float	power	= 0;
+	for (int i = 0; i < T_u; i ++)
+	   power += norm (v [i]);
+	power	/= T_u;
+	float	sigma	= sqrt (power / pow (10, snr / 10) / 2);
+	out. resize (T_u);
+	for (int i = 0; i < T_u; i ++)
+	   out [i] = v [i] + std::complex<float> (sigma * noise (gen),
+	                                          sigma * noise (gen));
+}
+
+//
+//	the results should be exactly the transmitters
+static
+bool	check		(const std::vector<transmitter> &tx,
+	                 const std::vector<tiiResult> &res) {
+	if (res. size () != tx. size ())
+	   return false;
+	for (auto &t : tx) {
+	   bool found	= false;
+	   for (auto &r : res)
+	      if ((r. mainId == t. mainId) && (r. subId == t. subId))
+	         found = true;
+	   if (!found)
+	      return false;
+	}
+//	the strongest one should be reported first
+	return (res [0]. mainId == tx [0]. mainId) &&
+	       (res [0]. subId == tx [0]. subId);
+}
+
+//
+//	run a case "trials" times, with fresh phases, delays and noise,
+//	returns the number of trials detected correctly
+static
+int	runCase		(dabParams &params,
+	                 phaseTable &phases,
+	                 fftHandler &ifft,
+	                 TII_Detector &detector,
+	                 std::vector<transmitter> &tx,
+	                 int trials, float snr, int depth,
+	                 std::mt19937 &gen,
+	                 int *spurious, double *usecs) {
+std::uniform_real_distribution<float> phase (0, 2 * M_PI);
+std::vector<std::complex<float>> symbol;
+int	hits	= 0;
+
+	for (int trial = 0; trial < trials; trial ++) {
+	   for (int t = 0; t < (int)tx. size (); t ++) {
+	      tx [t]. amplitude	= pow (10, -3.0 * t / 20);
+	      tx [t]. phase	= phase (gen);
+	      tx [t]. delay	= gen () % (params. get_T_g () / 8);
+	   }
+	   detector. reset ();
+	   for (int d = 0; d < depth; d ++) {
+	      synthesize (params, phases, ifft, tx, snr, gen, symbol);
+	      detector. addBuffer (symbol);
+	   }
+	   auto t0	= std::chrono::steady_clock::now ();
+	   std::vector<tiiResult> res = detector. processNULL ();
+	   *usecs	+= std::chrono::duration<double, std::micro>
+	                        (std::chrono::steady_clock::now () - t0). count ();
+	   if (check (tx, res))
+	      hits ++;
+	   if (res. size () > tx. size ())
+	      (*spurious) ++;
+	}
+	return hits;
+}
+
+int	main (int argc, char **argv) {
+int	trials		= argc > 1 ? atoi (argv [1]) : 200;
+float	snr		= argc > 2 ? atof (argv [2]) : 10;
+int	nrTx		= argc > 3 ? atoi (argv [3]) : 3;
+int	depth		= argc > 4 ? atoi (argv [4]) : 4;
+bool	failed		= false;
+std::mt19937	gen (1);
+
+	if ((trials < 1) || (nrTx < 1) || (nrTx > MAX_TX) || (depth < 1)) {
+	   fprintf (stderr,
+	        "Usage: tiiTester [trials [snr (dB) [transmitters (1 .. %d) [depth]]]]\n",
+	                                                       MAX_TX);
+	   exit (1);
+	}
+
+	for (int mode = 1; mode <= 4; mode ++) {
+	   dabParams	params (mode);
+	   phaseTable	phases (mode);
+	   fftHandler	ifft (mode);
+	   TII_Detector	detector (mode, depth);
+
+	   if (!detector. is_supported ()) {
+	      std::vector<tiiResult> res = detector. processNULL ();
+	      printf ("mode %d: TII not supported, %d results\n",
+	                                   mode, (int)res. size ());
+	      if (res. size () != 0)
+	         failed = true;
+	      continue;
+	   }
+
+	   for (auto &c : fixedCases) {
+	      std::vector<transmitter> tx (c. subIds. size ());
+	      for (int t = 0; t < (int)tx. size (); t ++) {
+	         tx [t]. mainId	= c. mainId;
+	         tx [t]. subId	= c. subIds [t];
+	      }
+	      int	spurious	= 0;
+	      double	usecs		= 0;
+	      int hits	= runCase (params, phases, ifft, detector, tx,
+	                           trials, snr, depth, gen, &spurious, &usecs);
+	      printf ("mode %d, %s: %d of %d detected, %d with spurious results\n",
+	                  mode, c. name, hits, trials, spurious);
+	      if (hits < 0.95 * trials)
+	         failed = true;
+	   }
+//
+//	in an SFN the transmitters usually share the mainId,
+//	the subIds are different, adjacent ones included
+	   int	hits		= 0;
+	   int	spurious	= 0;
+	   double	usecs	= 0;
+	   for (int trial = 0; trial < trials; trial ++) {
+	      std::vector<transmitter> tx (nrTx);
+	      int mainId	= gen () % 70;
+	      for (int t = 0; t < nrTx; t ++) {
+	         bool unique;
+	         do {
+	            tx [t]. subId = gen () % GROUPSIZE;
+	            unique	= true;
+	            for (int s = 0; s < t; s ++)
+	               if (tx [s]. subId == tx [t]. subId)
+	                  unique = false;
+	         } while (!unique);
+	         tx [t]. mainId	= mainId;
+	      }
+	      hits += runCase (params, phases, ifft, detector, tx,
+	                       1, snr, depth, gen, &spurious, &usecs);
+	   }
+	   printf ("mode %d, random: %d of %d detected, %d with spurious results, %.2f usec per processNULL\n",
+	                  mode, hits, trials, spurious, usecs / trials);
+	   if (hits < 0.95 * trials)
+	      failed = true;
+	}
+	return failed ? 1 : 0;
+}
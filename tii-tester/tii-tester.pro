@@ -0,0 +1,41 @@
+#
+TEMPLATE    = app
+CONFIG      += console
+CONFIG      -= app_bundle
+QT          += core
+QT          -= gui
+
+INCLUDEPATH += . \
+	      ../includes \
+	      ../includes/ofdm \
+	      ../includes/support
+
+HEADERS     = ../includes/ofdm/tii_detector.h \
+	      ../includes/ofdm/phasetable.h \
+	      ../includes/support/fft-handler.h \
+	      ../includes/support/dab-params.h
+SOURCES     = ./main.cpp \
+	      ../src/ofdm/tii_detector.cpp \
+	      ../src/ofdm/phasetable.cpp \
+	      ../src/support/fft-handler.cpp \
+	      ../src/support/dab-params.cpp
+TARGET      = tiiTester
+
+#	the detector has SSE code, to test that path, add
+#CONFIG	+= sse
+
+sse {
+DEFINES		+= SSE_AVAILABLE
+QMAKE_CXXFLAGS	+= -msse2
+}
+
+win32 {
+DESTDIR     = ../windows-bin
+INCLUDEPATH += /usr/i686-w64-mingw32/sys-root/mingw/include
+LIBS	+= -lfftw3f
+}
+
+unix {
+DESTDIR     = ./linux-bin
+LIBS	+= -lfftw3f
+}